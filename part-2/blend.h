@@ -2,6 +2,7 @@
 #define __BLEND_H__
 
 #include "imlib.h"
+#include "imlib_planar.h"
 
 
 /// @brief Alpha-blends two images of equal size using floating-point math. The image data must 
@@ -26,4 +27,88 @@ struct Image blend_float(struct Image img1, struct Image img2, int mode, double
 struct Image blend_int(struct Image img1, struct Image img2, int mode, int alpha);
 
 
+/// @brief Alpha-blends two images of equal size into @a dst using floating-point math. Any of
+///        the images may be a view (see image_view()), so a small foreground can be blended onto
+///        a rectangle of a large background without copying. @a dst may be the same as @a img1.
+///
+/// @param dst output image. Must have four channels and be of the same dimension as img1.
+/// @param img1 background image. Must have four channels.
+/// @param img2 foreground image. Must have four channels and be of the same dimension as img1.
+/// @param mode blending mode: 0: merge mode, 1: overlay mode.
+/// @param alpha blending parameter (0.0 - 1.0).
+void blend_float_into(struct Image dst, struct Image img1, struct Image img2, int mode, double alpha);
+
+
+/// @brief Alpha-blends two images of equal size into @a dst using fixed-point 8-bit math. See
+///        blend_float_into().
+///
+/// @param dst output image. Must have four channels and be of the same dimension as img1.
+/// @param img1 background image. Must have four channels.
+/// @param img2 foreground image. Must have four channels and be of the same dimension as img1.
+/// @param mode blending mode: 0: merge mode, 1: overlay mode.
+/// @param alpha blending parameter (0 - 256).
+void blend_int_into(struct Image dst, struct Image img1, struct Image img2, int mode, int alpha);
+
+
+/// @brief Alpha-blends two planar images of equal size into @a dst using fixed-point 8-bit
+///        math. The result is identical to blend_int_into() on the interleaved images. @a dst
+///        may be the same as @a img1.
+///
+/// @param dst output image. Must have four channels and be of the same dimension as img1.
+/// @param img1 background image. Must have four channels.
+/// @param img2 foreground image. Must have four channels and be of the same dimension as img1.
+/// @param mode blending mode: 0: merge mode, 1: overlay mode.
+/// @param alpha blending parameter (0 - 256).
+void blend_int_planar_into(struct PlanarImage dst, struct PlanarImage img1, struct PlanarImage img2,
+                           int mode, int alpha);
+
+
+/// @brief Alpha-blends two planar images of equal size using fixed-point 8-bit math and returns
+///        the blended image. See blend_int_planar_into().
+///
+/// @param img1 background image. Must have four channels.
+/// @param img2 foreground image. Must have four channels and be of the same dimension as img1.
+/// @param mode blending mode: 0: merge mode, 1: overlay mode.
+/// @param alpha blending parameter (0 - 256).
+/// @retval struct PlanarImage blended image. Free with planar_free().
+struct PlanarImage blend_int_planar(struct PlanarImage img1, struct PlanarImage img2, int mode,
+                                    int alpha);
+
+
+/// @brief Alpha-blends the rectangle (@a y, @a x) - (@a y + dst.height, @a x + dst.width) of two
+///        images on disk into @a dst, reading only the tiles the rectangle intersects. Work units
+///        along the tile grid of @a img1 are processed by @a threads threads. The result is
+///        identical to the same rectangle of blend_float()/blend_int() on the whole images.
+///
+/// @param dst output image. Must have four channels. May be a view.
+/// @param img1 background image opened with tiled_open(). Must have four channels.
+/// @param img2 foreground image opened with tiled_open(). Must have four channels and be of the
+///             same dimension as img1.
+/// @param y y coordinate of the rectangle
+/// @param x x coordinate of the rectangle
+/// @param type 0: floating-point, 1: fixed-point blending
+/// @param mode blending mode: 0: merge mode, 1: overlay mode.
+/// @param alpha blending parameter (0.0 - 1.0).
+/// @param threads number of threads
+void blend_tiled_into(struct Image dst, struct TiledImage *img1, struct TiledImage *img2, int y,
+                      int x, int type, int mode, double alpha, int threads);
+
+
+/// @brief Alpha-blends a rectangle of two images on disk and returns it. See blend_tiled_into().
+///
+/// @param img1 background image opened with tiled_open(). Must have four channels.
+/// @param img2 foreground image opened with tiled_open(). Must have four channels.
+/// @param y y coordinate of the rectangle
+/// @param x x coordinate of the rectangle
+/// @param height height of the rectangle
+/// @param width  width of the rectangle
+/// @param type 0: floating-point, 1: fixed-point blending
+/// @param mode blending mode: 0: merge mode, 1: overlay mode.
+/// @param alpha blending parameter (0.0 - 1.0).
+/// @param threads number of threads
+/// @retval struct Image blended rectangle (4 channels)
+struct Image blend_tiled(struct TiledImage *img1, struct TiledImage *img2, int y, int x,
+                         int height, int width, int type, int mode, double alpha, int threads);
+
+
 #endif // __BLEND_H__
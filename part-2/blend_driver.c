@@ -41,18 +41,40 @@
 #include <libgen.h>
 
 #include "imlib.h"
+#include "imlib_aio.h"
+#include "imlib_cache.h"
 #include "blend.h"
+#include "blend_incr.h"
+#include "resize.h"
 
 enum BlurType { btFloat, btInt };
 enum BlurMode { bmOverlay, bmMerge };
+enum FitMode { fmNone, fmStretch, fmFit, fmFill };
+enum Layout { lyInterleaved, lyPlanar };
+
+static char *fit_name[] = { "none", "stretch", "fit", "fill" };
 
 struct Arguments {
   enum BlurType type;
   enum BlurMode mode;
   double alpha;
+  int at;                         // blend image2 onto a rectangle of image1 at (at_x, at_y)
+  int at_x, at_y;
+  enum FitMode fit;               // resize image2 to image1 if their dimensions differ
+  enum Layout layout;             // planar: blend planes (int only); image1 is converted once
+  int incremental;                // blend frames incrementally with tiles of tile_size pixels
+  int tile_size;
   char *image1;
-  char *image2;
+  char **image2;                  // foreground images (frames)
+  int nframes;
   char *output;
+  int compress;                   // write results in the compressed RAW format
+  int tiled;                      // write results in the tiled RAW format with this tile size
+  int roi;                        // blend only the rectangle (roi_x, roi_y) - (+roi_w, +roi_h)
+  int roi_x, roi_y, roi_w, roi_h;
+  int threads;                    // threads for --roi
+  char *cache;                    // result cache directory (NULL: no caching)
+  long long cache_size;
 };
 
 
@@ -64,18 +86,42 @@ void syntax(char *msg)
   if (msg) printf("%s\n\n", msg);
 
   printf("Usage: blend_driver [-h] [--type {int,float}] [--mode {overlay,merge}] [--alpha ALPHA] "
-                             "[--output OUTPUT] image1 image2\n"
+                             "[--at X,Y] [--fit {stretch,fit,fill}] [--incremental] [--tile N] "
+                             "[--layout {interleaved,planar}] [--roi X,Y,WxH] [--threads N] "
+                             "[--compress] [--tiled N] [--cache DIR] [--cache-size MB] "
+                             "[--output OUTPUT] image1 image2 [image2 ...]\n"
          "\n"
          "Positional arguments:\n"
          "  image1                      The background image\n"
-         "  image2                      The image to blend or merge\n"
+         "  image2                      The image(s) to blend or merge. Several images are\n"
+         "                              processed as a sequence of frames.\n"
          "\n"
          "Options:\n"
          "  -h/--help                   Show this help message and exit\n"
          "  -t/--type {int,float}       Computation type (default: float)\n"
          "  -m/--mode {overlay,merge}   Blending mode (default: overlay)\n"
          "  -a/--alpha ALPHA            Alpha value (0.0 - 1.0, default: 0.5)\n"
-         "  -o/--output OUTPUT          Force name of output image\n");
+         "  --at X,Y                    Blend a smaller image2 onto image1 with its top-left\n"
+         "                              corner at (X,Y). Only the covered pixels are processed.\n"
+         "  --fit {stretch,fit,fill}    Resize image2 to image1 if their dimensions differ:\n"
+         "                              stretch: to the dimensions of image1, fit: keep the\n"
+         "                              aspect ratio and center inside image1, fill: keep the\n"
+         "                              aspect ratio and crop to cover image1\n"
+         "  -i/--incremental            Only re-blend tiles whose inputs changed since the\n"
+         "                              previous frame\n"
+         "  --tile N                    Tile size for --incremental (default: %d)\n"
+         "  --layout {interleaved,planar}\n"
+         "                              Pixel layout for the computation (default: interleaved).\n"
+         "                              planar requires '--type int'.\n"
+         "  --roi X,Y,WxH               Only blend the WxH rectangle at (X,Y). Only the tiles it\n"
+         "                              intersects are read.\n"
+         "  --threads N                 Number of threads for --roi (default: 4)\n"
+         "  -z/--compress               Save results in the compressed RAW format\n"
+         "  --tiled N                   Save results in the tiled RAW format with NxN tiles\n"
+         "  --cache DIR                 Reuse results of identical jobs stored in DIR\n"
+         "  --cache-size MB             Size limit of the result cache (default: %lld MB)\n"
+         "  -o/--output OUTPUT          Force name of output image (frames: OUTPUT_N)\n",
+         BLEND_TILE_SIZE, CACHE_SIZE >> 20);
 
   exit(EXIT_FAILURE);
 }
@@ -89,10 +135,16 @@ void syntax(char *msg)
 struct Arguments parse_arguments(int argc, char *argv[])
 {
   struct Arguments args = { 
-    .type = btFloat, .mode = bmOverlay, .alpha = 0.5,
-    .image1 = NULL, .image2 = NULL, .output = NULL
+    .type = btFloat, .mode = bmOverlay, .alpha = 0.5, .at = 0, .at_x = 0, .at_y = 0, .fit = fmNone,
+    .layout = lyInterleaved,
+    .incremental = 0, .tile_size = BLEND_TILE_SIZE,
+    .image1 = NULL, .image2 = NULL, .nframes = 0, .output = NULL, .compress = 0, .tiled = 0,
+    .roi = 0, .threads = 4,
+    .cache = NULL, .cache_size = CACHE_SIZE
   };
 
+  if ((args.image2 = calloc(argc, sizeof(char*))) == NULL) panic("Out of memory", 0);
+
   for (int i=1; i<argc; i++) {
     if (!strcmp("--type", argv[i]) || !strcmp("-t", argv[i])) {
       if (++i == argc) syntax("Missing argument after '--type'.");
@@ -114,6 +166,78 @@ struct Arguments parse_arguments(int argc, char *argv[])
       args.alpha = strtod(argv[i], &endptr);
       if (*endptr != '\0') syntax("Invalid float after '--alpha'.");
     } else
+    if (!strcmp("--at", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--at'.");
+      char *endptr;
+      args.at_x = strtol(argv[i], &endptr, 10);
+      if (*endptr != ',') syntax("Invalid position after '--at'. Use X,Y.");
+      args.at_y = strtol(endptr+1, &endptr, 10);
+      if (*endptr != '\0') syntax("Invalid position after '--at'. Use X,Y.");
+      if ((args.at_x < 0) || (args.at_y < 0)) syntax("Position after '--at' must not be negative.");
+      args.at = 1;
+    } else
+    if (!strcmp("--fit", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--fit'.");
+      char *opt = argv[i];
+      if (!strcmp("stretch", opt)) args.fit = fmStretch;
+      else if (!strcmp("fit", opt)) args.fit = fmFit;
+      else if (!strcmp("fill", opt)) args.fit = fmFill;
+      else syntax("Invalid option to '--fit'");
+    } else
+    if (!strcmp("--incremental", argv[i]) || !strcmp("-i", argv[i])) {
+      args.incremental = 1;
+    } else
+    if (!strcmp("--tile", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--tile'.");
+      char *endptr;
+      args.tile_size = strtol(argv[i], &endptr, 10);
+      if ((*endptr != '\0') || (args.tile_size < 1)) syntax("Invalid tile size after '--tile'.");
+    } else
+    if (!strcmp("--layout", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--layout'.");
+      char *opt = argv[i];
+      if (!strcmp("interleaved", opt)) args.layout = lyInterleaved;
+      else if (!strcmp("planar", opt)) args.layout = lyPlanar;
+      else syntax("Invalid option to '--layout'");
+    } else
+    if (!strcmp("--roi", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--roi'.");
+      char *endptr;
+      args.roi_x = strtol(argv[i], &endptr, 10);
+      if (*endptr == ',') args.roi_y = strtol(endptr+1, &endptr, 10);
+      if (*endptr == ',') args.roi_w = strtol(endptr+1, &endptr, 10);
+      if (*endptr == 'x') args.roi_h = strtol(endptr+1, &endptr, 10);
+      if (*endptr != '\0') syntax("Invalid rectangle after '--roi'. Use X,Y,WxH.");
+      if ((args.roi_x < 0) || (args.roi_y < 0) || (args.roi_w < 1) || (args.roi_h < 1)) {
+        syntax("Invalid rectangle after '--roi'.");
+      }
+      args.roi = 1;
+    } else
+    if (!strcmp("--threads", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--threads'.");
+      char *endptr;
+      args.threads = strtol(argv[i], &endptr, 10);
+      if ((*endptr != '\0') || (args.threads < 1)) syntax("Invalid number of threads.");
+    } else
+    if (!strcmp("--compress", argv[i]) || !strcmp("-z", argv[i])) {
+      args.compress = 1;
+    } else
+    if (!strcmp("--tiled", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--tiled'.");
+      char *endptr;
+      args.tiled = strtol(argv[i], &endptr, 10);
+      if ((*endptr != '\0') || (args.tiled < 1)) syntax("Invalid tile size after '--tiled'.");
+    } else
+    if (!strcmp("--cache", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--cache'.");
+      args.cache = argv[i];
+    } else
+    if (!strcmp("--cache-size", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--cache-size'.");
+      char *endptr;
+      args.cache_size = strtoll(argv[i], &endptr, 10) << 20;
+      if ((*endptr != '\0') || (args.cache_size <= 0)) syntax("Invalid size after '--cache-size'.");
+    } else
     if (!strcmp("--output", argv[i]) || !strcmp("-o", argv[i])) {
       if (++i == argc) syntax("Missing argument after '--output'.");
       args.output = argv[i];
@@ -122,12 +246,28 @@ struct Arguments parse_arguments(int argc, char *argv[])
       syntax(NULL);
     } else {
       if (args.image1 == NULL) args.image1 = argv[i];
-      else if (args.image2 == NULL) args.image2 = argv[i];
-      else syntax("Too many images or unknown option.");
+      else args.image2[args.nframes++] = argv[i];
     }
   }
 
-  if (args.image2 == NULL) syntax("Please provide two images files.");
+  if (args.nframes == 0) syntax("Please provide two images files.");
+  if (args.at && ((args.nframes > 1) || args.incremental)) {
+    syntax("'--at' cannot be combined with several frames or '--incremental'.");
+  }
+  if (args.fit && (args.at || args.incremental)) {
+    syntax("'--fit' cannot be combined with '--at' or '--incremental'.");
+  }
+  if ((args.layout == lyPlanar) &&
+      ((args.type != btInt) || args.at || args.fit || args.incremental)) {
+    syntax("'--layout planar' requires '--type int' and cannot be combined with '--at', '--fit', "
+           "or '--incremental'.");
+  }
+  if (args.roi && ((args.nframes > 1) || args.at || args.fit || args.incremental ||
+                   (args.layout == lyPlanar) || args.cache)) {
+    syntax("'--roi' cannot be combined with several frames, '--at', '--fit', '--incremental', "
+           "'--layout planar', or '--cache'.");
+  }
+  if (args.compress && args.tiled) syntax("'--compress' cannot be combined with '--tiled'.");
 
   return args;
 }
@@ -154,6 +294,244 @@ void splitext(char *basename, char **ext)
 }
 
 
+/// @brief Construct the output file name of frame @a frame.
+///
+/// @param args parsed command line arguments
+/// @param frame frame index
+/// @retval char* file name (heap-allocated)
+char *output_filename(struct Arguments *args, int frame)
+{
+  char *bfn;
+
+  if (args->output == NULL) {
+    char *out, *dn1, *dn2, *bn1, *bn2, *ext1, *ext2;
+    out = strdup(args->image1); dn1 = strdup(dirname(out));  free(out);
+    out = strdup(args->image1); bn1 = strdup(basename(out)); free(out);
+    splitext(bn1, &ext1);
+
+    out = strdup(args->image2[frame]); dn2 = strdup(dirname(out));  free(out);
+    out = strdup(args->image2[frame]); bn2 = strdup(basename(out)); free(out);
+    splitext(bn2, &ext2);
+
+    size_t bfn_size = strlen(dn1)+strlen(bn1)+strlen(bn2)+32;
+    bfn = calloc(bfn_size, sizeof(char));
+    snprintf(bfn, bfn_size, "%s/%s_%s_%s_%.2g_%s.raw", 
+             dn1, bn1, bn2, args->mode == bmOverlay ? "overlay" : "merge", 
+             args->alpha, args->type == btFloat ? "float" : "int" );
+
+    free(dn1); free(dn2);
+    free(bn1); free(bn2);
+  } else if (args->nframes == 1) {
+    size_t bfn_size = strlen(args->output)+8;
+    bfn = calloc(bfn_size, sizeof(char));
+    snprintf(bfn, bfn_size, "%s.raw", args->output);
+  } else {
+    size_t bfn_size = strlen(args->output)+24;
+    bfn = calloc(bfn_size, sizeof(char));
+    snprintf(bfn, bfn_size, "%s_%d.raw", args->output, frame);
+  }
+
+  return bfn;
+}
+
+
+/// @brief Blend @a image2 onto @a image1 one row at a time. If the dimensions differ, image2 is
+///        resized according to args->fit; BGR rows of either image are expanded to opaque BGRA.
+///        Each row is resized/expanded right before it is blended, so no resized or expanded
+///        copy of an input is stored in full.
+///
+/// @param image1 background image (3 or 4 channels)
+/// @param image2 foreground image (3 or 4 channels)
+/// @param args parsed command line arguments
+/// @param mode blending mode: 0: merge mode, 1: overlay mode.
+/// @retval struct Image blended image (4 channels)
+struct Image blend_rows(struct Image image1, struct Image image2, struct Arguments *args,
+                        int mode)
+{
+  long long h1 = image1.height, w1 = image1.width, h2 = image2.height, w2 = image2.width;
+  int height = h1, width = w1, y = 0, x = 0;
+  struct Image src = image2;
+
+  if ((h1 != h2) || (w1 != w2)) {
+    if (args->fit == fmFit) {
+      // scale image2 to fit inside image1 and center it
+      if (w2*h1 > w1*h2) height = h2*w1/w2 > 0 ? h2*w1/w2 : 1;
+      else               width  = w2*h1/h2 > 0 ? w2*h1/h2 : 1;
+      y = (image1.height - height) / 2;
+      x = (image1.width - width) / 2;
+    } else
+    if (args->fit == fmFill) {
+      // crop the center of image2 to the aspect ratio of image1
+      int ch = h2, cw = w2;
+      if (w2*h1 > w1*h2) cw = w1*h2/h1 > 0 ? w1*h2/h1 : 1;
+      else               ch = h1*w2/w1 > 0 ? h1*w2/w1 : 1;
+      src = image_view(image2, (image2.height - ch) / 2, (image2.width - cw) / 2, ch, cw);
+    }
+  }
+
+  // 'fit' leaves pixels of image1 uncovered
+  struct Image blended = { .height = image1.height, .width = image1.width, .channels = 4 };
+  size_t size = (size_t)image1.height * image1.width * blended.channels;
+  if ((blended.data = malloc(size)) == NULL) panic("Out of memory", 0);
+  if ((height != image1.height) || (width != image1.width)) {
+    if (image1.channels == 4) memcpy(blended.data, image1.data, size);
+    else bgr_to_bgra(blended.data, image1.data, image1.height * image1.width, 0xff);
+  }
+
+  // Row buffers: resized image2 row, image1 and image2 rows expanded to BGRA
+  struct Image rrow = { .height = 1, .width = width, .channels = image2.channels };
+  struct Image brow = { .height = 1, .width = width, .channels = 4 };
+  struct Image frow = { .height = 1, .width = width, .channels = 4 };
+  struct Resizer *r = NULL;
+  if ((src.height != height) || (src.width != width)) {
+    r = resize_create(src, height, width);
+    if ((rrow.data = malloc((size_t)width * rrow.channels)) == NULL) panic("Out of memory", 0);
+  }
+  if ((image1.channels == 3) && ((brow.data = malloc((size_t)width * 4)) == NULL)) {
+    panic("Out of memory", 0);
+  }
+  if ((image2.channels == 3) && ((frow.data = malloc((size_t)width * 4)) == NULL)) {
+    panic("Out of memory", 0);
+  }
+
+  for (int i=0; i<height; i++) {
+    struct Image dst = image_view(blended, y+i, x, 1, width);
+    struct Image bg = image_view(image1, y+i, x, 1, width);
+    struct Image fg = r ? rrow : image_view(src, i, 0, 1, width);
+
+    if (r) resize_row(r, i, rrow);
+    if (bg.channels == 3) {
+      bgr_to_bgra(brow.data, bg.data, width, 0xff);
+      bg = brow;
+    }
+    if (fg.channels == 3) {
+      bgr_to_bgra(frow.data, fg.data, width, 0xff);
+      fg = frow;
+    }
+
+    if (args->type == btFloat) {
+      blend_float_into(dst, bg, fg, mode, args->alpha);
+    } else {
+      blend_int_into(dst, bg, fg, mode, (int)(args->alpha*255));
+    }
+  }
+
+  resize_destroy(r);
+  free(rrow.data);
+  free(brow.data);
+  free(frow.data);
+
+  return blended;
+}
+
+
+/// @brief Wall-clock time in seconds (CPU time would add up the time of all threads).
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/// @brief Save @a img in the output format selected by @a args.
+///
+/// @param args parsed command line arguments
+/// @param filename path to file
+/// @param img image
+void save_result(struct Arguments *args, char *filename, struct Image img)
+{
+  if (args->compress) write_raw_image_compressed(filename, img);
+  else if (args->tiled) write_raw_image_tiled(filename, img, args->tiled);
+  else write_raw_image(filename, img);
+}
+
+
+/// @brief Blend the rectangle given by --roi. The images are only opened; the tiles intersecting
+///        the rectangle are read by the blending threads.
+///
+/// @param args parsed command line arguments
+/// @param mode blending mode: 0: merge mode, 1: overlay mode.
+void blend_roi(struct Arguments *args, int mode)
+{
+  printf("Opening RAW images %s and %s...\n", args->image1, args->image2[0]);
+  struct TiledImage *img1 = tiled_open(args->image1), *img2 = tiled_open(args->image2[0]);
+  printf("  Image dimensions %d x %d x %d\n", img1->height, img1->width, img1->channels);
+
+  if ((img1->height != img2->height) || (img1->width != img2->width) ||
+      (img1->channels != 4) || (img2->channels != 4)) {
+    printf("'--roi' requires two BGRA images of the same dimensions\n"
+           "  %s: %dx%dx%d\n"
+           "  %s: %dx%dx%d\n",
+           args->image1, img1->height, img1->width, img1->channels,
+           args->image2[0], img2->height, img2->width, img2->channels);
+    exit(EXIT_FAILURE);
+  }
+  if ((args->roi_y + args->roi_h > img1->height) || (args->roi_x + args->roi_w > img1->width)) {
+    printf("Rectangle %dx%d at (%d,%d) is not inside %s (%dx%d)\n",
+           args->roi_w, args->roi_h, args->roi_x, args->roi_y,
+           args->image1, img1->width, img1->height);
+    exit(EXIT_FAILURE);
+  }
+
+  printf("Blending images (mode: %s, type: %s, alpha: %g)...\n",
+         args->mode == bmOverlay ? "overlay" : "merge", args->type == btFloat ? "float" : "int",
+         args->alpha);
+  double t_start = now();
+  struct Image blended = blend_tiled(img1, img2, args->roi_y, args->roi_x, args->roi_h,
+                                     args->roi_w, args->type == btInt, mode, args->alpha,
+                                     args->threads);
+  printf("  Rectangle %dx%d at (%d,%d): %.6f seconds (wall clock, %d threads)\n",
+         args->roi_w, args->roi_h, args->roi_x, args->roi_y, now() - t_start, args->threads);
+
+  char *bfn = output_filename(args, 0);
+  printf("Saving result (%d x %d x %d)...\n", blended.height, blended.width, blended.channels);
+  printf("  Saving as %s\n", bfn);
+  save_result(args, bfn, blended);
+
+  free(bfn);
+  free(blended.data);
+  tiled_close(img1);
+  tiled_close(img2);
+}
+
+
+/// @brief Print the result cache statistics.
+///
+/// @param cache result cache
+void print_cache_stats(struct ResultCache *cache)
+{
+  long hits, misses, evictions;
+  cache_stats(cache, &hits, &misses, &evictions);
+  printf("Result cache: %ld hits, %ld misses (%.1f%% hit rate), %ld evictions\n",
+         hits, misses, hits + misses ? 100.0*hits/(hits + misses) : 0.0, evictions);
+}
+
+
+/// @brief Check that frame @a f (@a image2) fits @a image1 (at the given position or with the
+///        given fit mode). Exits with an error message otherwise.
+static void check_frame(struct Arguments *args, struct Image image1, struct Image image2, int f)
+{
+  if (args->at) {
+    if ((args->at_y + image2.height > image1.height) ||
+        (args->at_x + image2.width > image1.width)) {
+      printf("Image %s (%dx%d) does not fit into %s (%dx%d) at (%d,%d)\n",
+             args->image2[f], image2.height, image2.width,
+             args->image1, image1.height, image1.width, args->at_x, args->at_y);
+      exit(EXIT_FAILURE);
+    }
+  } else
+  if (!args->fit && ((image1.height != image2.height) || (image1.width != image2.width))) {
+    printf("Image dimension mismatch (use --fit to resize)\n"
+           "  %s: %dx%d\n"
+           "  %s: %dx%d\n",
+           args->image1, image1.height, image1.width,
+           args->image2[f], image2.height, image2.width);
+    exit(EXIT_FAILURE);
+  }
+}
+
+
 int main(int argc, char *argv[])
 {
   struct Arguments args;
@@ -171,29 +549,63 @@ int main(int argc, char *argv[])
 
   mode = args.mode == bmOverlay ? 1 : 0;
 
+  if (args.roi) {
+    blend_roi(&args, mode);
+    free(args.image2);
+    return EXIT_SUCCESS;
+  }
+
 
   // Read images
-  printf("Loading RAW images %s and %s...\n", args.image1, args.image2);
-  image1 = read_raw_image(args.image1);
-  image2 = read_raw_image(args.image2);
+  if (args.nframes == 1) {
+    printf("Loading RAW images %s and %s...\n", args.image1, args.image2[0]);
+  } else {
+    printf("Loading RAW images %s and %d frames...\n", args.image1, args.nframes);
+  }
+  // Incremental mode streams the frames through one reused buffer (see below); only the
+  // background is loaded up front.
+  int nload = args.incremental ? 1 : args.nframes+1;
+  char **filenames = calloc(args.nframes+1, sizeof(char*));
+  struct Image *images = calloc(args.nframes+1, sizeof(struct Image));
+  if ((filenames == NULL) || (images == NULL)) panic("Out of memory", 0);
+  filenames[0] = args.image1;
+  memcpy(&filenames[1], args.image2, args.nframes*sizeof(char*));
+  read_raw_images(filenames, nload, images);
+  image1 = images[0];
+
+  // Hash inputs for the result cache
+  struct ResultCache *cache = args.cache ? cache_open(args.cache, args.cache_size) : NULL;
+  uint64_t *hashes = NULL;
+  char params[128], format[32];
+  if (cache) {
+    if ((hashes = calloc(args.nframes+1, sizeof(uint64_t))) == NULL) panic("Out of memory", 0);
+    for (int i=0; i<nload; i++) hashes[i] = image_hash(images[i]);
+    // the cached entry is the saved file, so the output format is part of the job
+    if (args.tiled) snprintf(format, sizeof(format), "tiled %d", args.tiled);
+    else snprintf(format, sizeof(format), "%s", args.compress ? "compressed" : "raw");
+    snprintf(params, sizeof(params), "blend %s %s %.17g %d,%d %s %s",
+             args.type == btFloat ? "float" : "int", args.mode == bmOverlay ? "overlay" : "merge",
+             args.alpha, args.at ? args.at_x : -1, args.at ? args.at_y : -1, fit_name[args.fit],
+             format);
+  }
 
 
-  // Check that dimensions match and an alpha channel is present
-  if ((image1.height != image2.height) || (image1.width != image2.width)) {
-    printf("Image dimension mismatch\n"
-           "  %s: %dx%d\n"
-           "  %s: %dx%d\n",
-           args.image1, image1.height, image1.width,
-           args.image2, image2.height, image2.width);
-    exit(EXIT_FAILURE);
+  // Check that dimensions match (or image2 fits at the given position) and an alpha channel is
+  // present. Streamed frames are checked when they are read.
+  for (int f=0; f<nload-1; f++) {
+    image2 = images[f+1];
+    check_frame(&args, image1, image2, f);
+    // BGR images are expanded to opaque BGRA row by row while blending; blending in place
+    // (--at) and planar blending need them converted up front
+    if ((image2.channels == 3) && (args.at || args.layout == lyPlanar)) {
+      images[f+1] = image_convert(image2, 4);
+      free(image2.data);
+    }
   }
-  if ((image1.channels != 4) || (image2.channels != 4)) {
-    printf("Missing alpha channel\n"
-           "  %s: %s alpha channel\n"
-           "  %s: %s alpha channel\n",
-           args.image1, image1.channels == 4 ? "has" : "no",
-           args.image2, image2.channels == 4 ? "has" : "no");
-    exit(EXIT_FAILURE);
+  if ((image1.channels == 3) && (args.at || args.incremental || args.layout == lyPlanar)) {
+    images[0] = image_convert(image1, 4);
+    free(image1.data);
+    image1 = images[0];
   }
   printf("  Image dimensions %d x %d x %d\n", image1.height, image1.width, image1.channels);
 
@@ -203,53 +615,149 @@ int main(int argc, char *argv[])
          args.mode == bmOverlay ? "overlay" : "merge", args.type == btFloat ? "float" : "int",
          args.alpha);
 
-  clock_t t_start = clock();
-  if (args.type == btFloat) {
-    blended = blend_float(image1, image2, mode, args.alpha);
-  } else {
-    blended = blend_int(image1, image2, mode, (int)(args.alpha*255));
+  struct BlendState *state = args.incremental ? blend_incr_create(args.tile_size) : NULL;
+  clock_t t_total = 0, t_kernel = 0;
+
+  // Planar layout: the background is converted once for all frames
+  struct PlanarImage planar1;
+  if (args.layout == lyPlanar) {
+    clock_t t_start = clock();
+    planar1 = image_to_planar(image1);
+    clock_t t_stop = clock();
+    t_total += t_stop-t_start;
+    printf("  Planar conversion of %s: %.6f seconds\n",
+           args.image1, ((float)(t_stop-t_start))/CLOCKS_PER_SEC);
   }
-  clock_t t_stop = clock();
-  printf("  Elapsed time: %.6f seconds\n", ((float)(t_stop-t_start))/CLOCKS_PER_SEC);
 
+  struct Image frame = { NULL, -1, -1, -1, 0 }, frame4 = { NULL, -1, -1, 4, 0 };
+  for (int f=0; f<args.nframes; f++) {
+    if (args.incremental) {
+      // blend_incr() keeps its own copy of the previous frame, so one buffer serves all frames
+      read_raw_image_reuse(args.image2[f], &frame);
+      check_frame(&args, image1, frame, f);
+      if (cache) hashes[f+1] = image_hash(frame);
+      if (frame.channels == 3) {
+        size_t npixels = (size_t)frame.height * frame.width;
+        uint8 *data = realloc(frame4.data, npixels ? 4*npixels : 1);
+        if (data == NULL) panic("Out of memory", 0);
+        frame4 = (struct Image){ data, frame.height, frame.width, 4, 0 };
+        bgr_to_bgra(frame4.data, frame.data, npixels, 255);
+        images[f+1] = frame4;
+      } else {
+        images[f+1] = frame;
+      }
+    }
+    image2 = images[f+1];
+    if (args.nframes > 1) printf("Frame %d: %s\n", f, args.image2[f]);
+    bfn = output_filename(&args, f);
+
+    // Look up result cache
+    uint64_t key = 0;
+    if (cache) {
+      uint64_t job[2] = { hashes[0], hashes[f+1] };
+      key = cache_key(params, job, 2);
+
+      clock_t t_start = clock();
+      int hit = cache_fetch(cache, key, bfn);
+      clock_t t_stop = clock();
+      if (hit) {
+        t_total += t_stop-t_start;
+        printf("  Result found in cache (key %016llx)\n", (unsigned long long)key);
+        printf("  Elapsed time: %.6f seconds\n", ((float)(t_stop-t_start))/CLOCKS_PER_SEC);
+        printf("  Saved as %s\n", bfn);
+        free(bfn);
+        if (!args.incremental) free(image2.data);
+        continue;
+      }
+    }
 
-  // Construct output filename
-  if (args.output == NULL) {
-    char *out, *dn1, *dn2, *bn1, *bn2, *ext1, *ext2;
-    out = strdup(args.image1); dn1 = strdup(dirname(out));  free(out);
-    out = strdup(args.image1); bn1 = strdup(basename(out)); free(out);
-    splitext(bn1, &ext1);
+    clock_t t_start = clock(), t_blend = 0;
+    if (args.layout == lyPlanar) {
+      struct PlanarImage planar2 = image_to_planar(image2);
+      t_blend = clock();
+      struct PlanarImage pblended = blend_int_planar(planar1, planar2, mode, (int)(args.alpha*255));
+      t_blend = clock() - t_blend;
+      t_kernel += t_blend;
+      blended = planar_to_image(pblended);
+      planar_free(&planar2);
+      planar_free(&pblended);
+    } else
+    if (state) {
+      blended = blend_incr(state, image1, image2, args.type == btInt, mode, args.alpha);
+    } else
+    if (args.at) {
+      // blend in place into the covered rectangle of image1
+      struct Image roi = image_view(image1, args.at_y, args.at_x, image2.height, image2.width);
+      if (args.type == btFloat) {
+        blend_float_into(roi, roi, image2, mode, args.alpha);
+      } else {
+        blend_int_into(roi, roi, image2, mode, (int)(args.alpha*255));
+      }
+      blended = image1;
+    } else
+    if ((image1.channels == 3) || (image2.channels == 3) ||
+        (image1.height != image2.height) || (image1.width != image2.width)) {
+      blended = blend_rows(image1, image2, &args, mode);
+    } else
+    if (args.type == btFloat) {
+      blended = blend_float(image1, image2, mode, args.alpha);
+    } else {
+      blended = blend_int(image1, image2, mode, (int)(args.alpha*255));
+    }
+    clock_t t_stop = clock();
+    t_total += t_stop-t_start;
+    printf("  Elapsed time: %.6f seconds\n", ((float)(t_stop-t_start))/CLOCKS_PER_SEC);
+    if (args.layout == lyPlanar) {
+      printf("  Planar blend: %.6f seconds (layout conversion: %.6f seconds)\n",
+             ((float)t_blend)/CLOCKS_PER_SEC, ((float)(t_stop-t_start-t_blend))/CLOCKS_PER_SEC);
+    }
 
-    out = strdup(args.image2); dn2 = strdup(dirname(out));  free(out);
-    out = strdup(args.image2); bn2 = strdup(basename(out)); free(out);
-    splitext(bn2, &ext2);
 
-    size_t bfn_size = strlen(dn1)+strlen(bn1)+strlen(bn2)+32;
-    bfn = calloc(bfn_size, sizeof(char));
-    snprintf(bfn, bfn_size, "%s/%s_%s_%s_%.2g_%s.raw", 
-             dn1, bn1, bn2, args.mode == bmOverlay ? "overlay" : "merge", 
-             args.alpha, args.type == btFloat ? "float" : "int" );
+    // Save blended RAW image
+    printf("Saving result (%d x %d x %d)...\n", blended.height, blended.width, blended.channels);
+    printf("  Saving as %s\n", bfn);
+    save_result(&args, bfn, blended);
+    if (cache) {
+      cache_store_file(cache, key, bfn);
+      printf("  Stored in cache (key %016llx)\n", (unsigned long long)key);
+    }
+    free(bfn);
 
-    free(dn1); free(dn2);
-    free(bn1); free(bn2);
-  } else {
-    size_t bfn_size = strlen(args.output)+8;
-    bfn = calloc(bfn_size, sizeof(char));
-    snprintf(bfn, bfn_size, "%s.raw", args.output);
+    if (!state && (blended.data != image1.data)) free(blended.data);
+    if (!args.incremental) free(image2.data);
   }
+  free(frame.data);
+  free(frame4.data);
 
-
-  // Save blurred RAW image
-  printf("Saving result (%d x %d x %d)...\n", blended.height, blended.width, blended.channels);
-  printf("  Saving as %s\n", bfn);
-  write_raw_image(bfn, blended);
+  if (args.nframes > 1) {
+    printf("Total elapsed time: %.6f seconds (%d frames)\n",
+           ((float)t_total)/CLOCKS_PER_SEC, args.nframes);
+  }
+  if (args.layout == lyPlanar) {
+    printf("Planar blend total: %.6f seconds of %.6f seconds\n",
+           ((float)t_kernel)/CLOCKS_PER_SEC, ((float)t_total)/CLOCKS_PER_SEC);
+    planar_free(&planar1);
+  }
+  if (state) {
+    long skipped, recomputed;
+    blend_incr_stats(state, &skipped, &recomputed);
+    printf("Tiles (%dx%d): %ld recomputed, %ld skipped (%.1f%% skipped)\n",
+           args.tile_size, args.tile_size, recomputed, skipped,
+           skipped + recomputed ? 100.0*skipped/(skipped + recomputed) : 0.0);
+    blend_incr_destroy(state);
+  }
+  if (cache) {
+    print_cache_stats(cache);
+    cache_close(cache);
+    free(hashes);
+  }
 
 
   // Cleanup
-  free(bfn);
   free(image1.data);
-  free(image2.data);
-  free(blended.data);
+  free(images);
+  free(filenames);
+  free(args.image2);
 
 
   // That's all, folks!
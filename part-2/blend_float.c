@@ -18,27 +18,21 @@
 #include "blend.h"
 
 
-struct Image blend_float(struct Image img1, struct Image img2, int overlay, double alpha)
+void blend_float_into(struct Image dst, struct Image img1, struct Image img2, int overlay, double alpha)
 {
   if (img1.channels != 4) abort();
 
-
-  // Initialize blended image
-  struct Image blended = {
-    .height   = img1.height,
-    .width    = img1.width,
-    .channels = img1.channels
-  };
-  blended.data = malloc(blended.height*blended.width*blended.channels*sizeof(uint8));
-  if (blended.data == NULL) abort();
-
   // Merge Mode
+  // (load both alpha values first: dst may alias img1)
+  double alpha1, alpha2;
   if (overlay == 0) {
-    for (int h=0; h<blended.height; h++) {
-      for (int w=0; w<blended.width; w++) {
-        PIXEL(blended, h, w, 3) = (uint8) (((PIXEL(img1, h, w, 3) / 255.0) * (1.0 - alpha) + (PIXEL(img2, h, w, 3) / 255.0) * alpha) * 255.0);
-        for (int c=0; c<blended.channels-1; c++) {
-          PIXEL(blended, h, w, c) = (uint8) (((PIXEL(img1, h, w, c) / 255.0) * (PIXEL(img1, h, w, 3) / 255.0) * (1.0 - alpha) + (PIXEL(img2, h, w, c) / 255.0) * (PIXEL(img2, h, w, 3) / 255.0) * alpha) * 255.0);
+    for (int h=0; h<dst.height; h++) {
+      for (int w=0; w<dst.width; w++) {
+        alpha1 = PIXEL(img1, h, w, 3) / 255.0;
+        alpha2 = PIXEL(img2, h, w, 3) / 255.0;
+        PIXEL(dst, h, w, 3) = (uint8) ((alpha1 * (1.0 - alpha) + alpha2 * alpha) * 255.0);
+        for (int c=0; c<dst.channels-1; c++) {
+          PIXEL(dst, h, w, c) = (uint8) (((PIXEL(img1, h, w, c) / 255.0) * alpha1 * (1.0 - alpha) + (PIXEL(img2, h, w, c) / 255.0) * alpha2 * alpha) * 255.0);
         }
       }
     }
@@ -47,17 +41,34 @@ struct Image blend_float(struct Image img1, struct Image img2, int overlay, doub
   // Overlay Mode
   double alpha_combined;
   if (overlay == 1) {
-    for (int h=0; h<blended.height; h++) {
-      for (int w=0; w<blended.width; w++) {
-        PIXEL(blended, h, w, 3) = PIXEL(img1, h, w, 3);
+    for (int h=0; h<dst.height; h++) {
+      for (int w=0; w<dst.width; w++) {
+        PIXEL(dst, h, w, 3) = PIXEL(img1, h, w, 3);
         alpha_combined = (PIXEL(img2, h, w, 3) / 255.0) * alpha;
-        for (int c=0; c<blended.channels-1; c++) {
-          PIXEL(blended, h, w, c) = (uint8) (((PIXEL(img1, h, w, c) / 255.0) * (1.0 - alpha_combined) + (PIXEL(img2, h, w, c) / 255.0) * alpha_combined) * 255.0);
+        for (int c=0; c<dst.channels-1; c++) {
+          PIXEL(dst, h, w, c) = (uint8) (((PIXEL(img1, h, w, c) / 255.0) * (1.0 - alpha_combined) + (PIXEL(img2, h, w, c) / 255.0) * alpha_combined) * 255.0);
         }
       }
     }
   }
+}
+
+
+struct Image blend_float(struct Image img1, struct Image img2, int overlay, double alpha)
+{
+  if (img1.channels != 4) abort();
+
+
+  // Initialize blended image
+  struct Image blended = {
+    .height   = img1.height,
+    .width    = img1.width,
+    .channels = img1.channels
+  };
+  blended.data = malloc(blended.height*blended.width*blended.channels*sizeof(uint8));
+  if (blended.data == NULL) abort();
 
+  blend_float_into(blended, img1, img2, overlay, alpha);
 
   return blended;
 }
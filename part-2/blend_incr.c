@@ -0,0 +1,162 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Incremental image blending
+///        The state keeps a copy of the previous inputs. For every tile, the rows of the new
+///        inputs are compared against the copy (16 bytes at a time with SSE2); unchanged tiles
+///        keep their blended pixels in the persistent output, changed tiles are copied and
+///        blended again with blend_{int,float}_into() on tile views.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "blend.h"
+#include "blend_incr.h"
+
+struct BlendState {
+  int tile_size;
+  int valid;                      // prev and output hold the previous frame
+  int type, mode;                 // parameters of the previous frame
+  double alpha;
+  struct Image prev[2];           // copy of the previous inputs (densely packed)
+  struct Image output;            // persistent blended image
+  long skipped, blended;          // statistics
+};
+
+
+/// @brief Compare @a n bytes.
+///
+/// @retval int 1 if equal, 0 otherwise
+static int equal(const uint8 *a, const uint8 *b, int n)
+{
+  int i = 0;
+#ifdef __SSE2__
+  for (; i+16 <= n; i+=16) {
+    __m128i va = _mm_loadu_si128((const __m128i*)(a+i));
+    __m128i vb = _mm_loadu_si128((const __m128i*)(b+i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xffff) return 0;
+  }
+#endif
+  return memcmp(a+i, b+i, n-i) == 0;
+}
+
+/// @brief Check whether the tile @a t of @a img differs from @a prev.
+static int tile_changed(struct Image img, struct Image prev, struct Image t, int y, int x)
+{
+  int len = t.width * t.channels;
+  for (int h=0; h<t.height; h++) {
+    if (!equal(&PIXEL(img, y+h, x, 0), &PIXEL(prev, y+h, x, 0), len)) return 1;
+  }
+  return 0;
+}
+
+/// @brief Copy the tile (@a y, @a x) of size @a t from @a img to @a prev.
+static void copy_tile(struct Image img, struct Image prev, struct Image t, int y, int x)
+{
+  int len = t.width * t.channels;
+  for (int h=0; h<t.height; h++) {
+    memcpy(&PIXEL(prev, y+h, x, 0), &PIXEL(img, y+h, x, 0), len);
+  }
+}
+
+/// @brief (Re-)allocate the buffers of @a s for images of the dimensions of @a img.
+static void resize(struct BlendState *s, struct Image img)
+{
+  size_t size = (size_t)img.height * img.width * img.channels;
+
+  for (int i=0; i<3; i++) {
+    struct Image *p = i < 2 ? &s->prev[i] : &s->output;
+    free(p->data);
+    *p = (struct Image){ .height = img.height, .width = img.width, .channels = img.channels };
+    if ((p->data = malloc(size)) == NULL) abort();
+  }
+}
+
+
+struct BlendState *blend_incr_create(int tile_size)
+{
+  if (tile_size < 1) abort();
+
+  struct BlendState *s = calloc(1, sizeof(struct BlendState));
+  if (s == NULL) abort();
+  s->tile_size = tile_size;
+
+  return s;
+}
+
+
+void blend_incr_destroy(struct BlendState *state)
+{
+  if (state == NULL) return;
+
+  free(state->prev[0].data);
+  free(state->prev[1].data);
+  free(state->output.data);
+  free(state);
+}
+
+
+struct Image blend_incr(struct BlendState *state, struct Image img1, struct Image img2,
+                        int type, int mode, double alpha)
+{
+  struct BlendState *s = state;
+
+  if ((img1.channels != 4) || (img2.channels != 4)) abort();
+  if ((img1.height != img2.height) || (img1.width != img2.width)) abort();
+
+  // Start over if the dimensions or the blending parameters changed
+  if ((s->output.data == NULL) ||
+      (s->output.height != img1.height) || (s->output.width != img1.width)) {
+    resize(s, img1);
+    s->valid = 0;
+  }
+  if ((s->type != type) || (s->mode != mode) || (s->alpha != alpha)) s->valid = 0;
+  s->type = type;
+  s->mode = mode;
+  s->alpha = alpha;
+
+  // Blend dirty tiles
+  int ts = s->tile_size;
+  for (int y=0; y<img1.height; y+=ts) {
+    for (int x=0; x<img1.width; x+=ts) {
+      struct Image t = image_view(s->output, y, x,
+                                  y+ts <= img1.height ? ts : img1.height-y,
+                                  x+ts <= img1.width  ? ts : img1.width-x);
+
+      if (s->valid &&
+          !tile_changed(img1, s->prev[0], t, y, x) && !tile_changed(img2, s->prev[1], t, y, x)) {
+        s->skipped++;
+        continue;
+      }
+
+      copy_tile(img1, s->prev[0], t, y, x);
+      copy_tile(img2, s->prev[1], t, y, x);
+
+      struct Image t1 = image_view(s->prev[0], y, x, t.height, t.width);
+      struct Image t2 = image_view(s->prev[1], y, x, t.height, t.width);
+      if (type == 0) blend_float_into(t, t1, t2, mode, alpha);
+      else blend_int_into(t, t1, t2, mode, (int)(alpha*255));
+      s->blended++;
+    }
+  }
+  s->valid = 1;
+
+  return s->output;
+}
+
+
+void blend_incr_stats(struct BlendState *state, long *skipped, long *blended)
+{
+  *skipped = state->skipped;
+  *blended = state->blended;
+}
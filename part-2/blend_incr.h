@@ -0,0 +1,68 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Incremental image blending
+///        Blends a sequence of frames (e.g., a static background with an animated overlay) into
+///        a persistent output buffer. Each frame is compared tile by tile against the previous
+///        inputs and only tiles whose inputs changed are blended again.
+///
+///        Typical use:
+///          struct BlendState *s = blend_incr_create(32);
+///          for each frame: out = blend_incr(s, background, overlay[i], 1, 1, 0.5); write out
+///          blend_incr_destroy(s);
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#ifndef __BLEND_INCR_H__
+#define __BLEND_INCR_H__
+
+#include "imlib.h"
+
+#define BLEND_TILE_SIZE 32        ///< default tile size (pixels)
+
+struct BlendState;
+
+
+/// @brief Create an incremental blending state.
+///
+/// @param tile_size width and height of a tile in pixels (>= 1)
+/// @retval struct BlendState* state. The function aborts in case of any error.
+struct BlendState *blend_incr_create(int tile_size);
+
+
+/// @brief Release the state including its output buffer.
+///
+/// @param state state
+void blend_incr_destroy(struct BlendState *state);
+
+
+/// @brief Blend the next frame. Tiles whose inputs are identical to those of the previous call
+///        (and blending parameters that did not change) are not recomputed. The first frame, a
+///        change in image dimensions, or a change of @a type, @a mode, or @a alpha recomputes
+///        all tiles. The result is identical to blend_int()/blend_float().
+///
+/// @param state state
+/// @param img1 background image. Must have four channels.
+/// @param img2 foreground image. Must have four channels and be of the same dimension as img1.
+/// @param type 0: floating-point, 1: fixed-point blending
+/// @param mode blending mode: 0: merge mode, 1: overlay mode.
+/// @param alpha blending parameter (0.0 - 1.0).
+/// @retval struct Image blended image. Owned by @a state; valid until the next call.
+struct Image blend_incr(struct BlendState *state, struct Image img1, struct Image img2,
+                        int type, int mode, double alpha);
+
+
+/// @brief Return the number of tiles skipped and recomputed since the state was created.
+///
+/// @param state state
+/// @param[out] skipped number of tiles whose inputs did not change
+/// @param[out] blended number of tiles that were recomputed
+void blend_incr_stats(struct BlendState *state, long *skipped, long *blended);
+
+#endif // __BLEND_INCR_H__
@@ -0,0 +1,118 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Image blending (tiled, parallel)
+///        Blends a region of two images on disk without reading the rest of the images. The
+///        region is split into work units along the tile grid of the background image; units are
+///        at least TILED_UNIT_ROWS rows high so that files with one-row tiles (uncompressed RAW)
+///        are read in reasonably large pieces. Each thread reads the background of its units
+///        straight into the output, the foreground into a private buffer, and blends in place
+///        with blend_int_into() or blend_float_into().
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "blend.h"
+
+#define TILED_UNIT_ROWS 64        ///< minimum height of a work unit (rows)
+
+struct BlendJob {
+  struct Image dst;               // output region
+  struct TiledImage *img1, *img2;
+  int y, x;                       // top-left corner of the region
+  int type, mode;
+  double alpha;
+  int unit_h, unit_w;             // work unit size (aligned to the tile grid of img1)
+  int first, step;                // units first, first+step, ...
+};
+
+
+/// @brief Blend the work units of @a arg (struct BlendJob).
+static void *blend_units(void *arg)
+{
+  struct BlendJob *j = arg;
+  int uy0 = j->y / j->unit_h, ux0 = j->x / j->unit_w;
+  int nuy = (j->y + j->dst.height - 1) / j->unit_h - uy0 + 1;
+  int nux = (j->x + j->dst.width - 1) / j->unit_w - ux0 + 1;
+
+  struct Image fg = { .channels = 4 };
+  if ((fg.data = malloc((size_t)j->unit_h * j->unit_w * 4)) == NULL) {
+    panic("Failed to allocate memory for tile buffer", errno);
+  }
+
+  for (int u=j->first; u<nuy*nux; u+=j->step) {
+    // intersection of the unit with the region
+    int y0 = (uy0 + u/nux) * j->unit_h, x0 = (ux0 + u%nux) * j->unit_w;
+    int y1 = y0 + j->unit_h, x1 = x0 + j->unit_w;
+    if (y0 < j->y) y0 = j->y;
+    if (x0 < j->x) x0 = j->x;
+    if (y1 > j->y + j->dst.height) y1 = j->y + j->dst.height;
+    if (x1 > j->x + j->dst.width) x1 = j->x + j->dst.width;
+
+    struct Image out = image_view(j->dst, y0 - j->y, x0 - j->x, y1 - y0, x1 - x0);
+    fg.height = y1 - y0;
+    fg.width = x1 - x0;
+    tiled_read_into(out, j->img1, y0, x0);
+    tiled_read_into(fg, j->img2, y0, x0);
+
+    if (j->type == 0) blend_float_into(out, out, fg, j->mode, j->alpha);
+    else blend_int_into(out, out, fg, j->mode, (int)(j->alpha*255));
+  }
+
+  free(fg.data);
+  return NULL;
+}
+
+
+void blend_tiled_into(struct Image dst, struct TiledImage *img1, struct TiledImage *img2, int y,
+                      int x, int type, int mode, double alpha, int threads)
+{
+  if ((img1->channels != 4) || (img2->channels != 4) || (dst.channels != 4)) {
+    panic("Tiled blending requires images with four channels.", 0);
+  }
+  if ((img1->height != img2->height) || (img1->width != img2->width)) {
+    panic("Image dimension mismatch.", 0);
+  }
+  if ((y < 0) || (x < 0) || (y + dst.height > img1->height) || (x + dst.width > img1->width)) {
+    panic("Blend region is not inside the images.", 0);
+  }
+  if ((dst.height == 0) || (dst.width == 0)) return;
+  if (threads < 1) threads = 1;
+
+  int unit_h = img1->tile_height;
+  if (unit_h < TILED_UNIT_ROWS) unit_h *= (TILED_UNIT_ROWS + unit_h - 1) / unit_h;
+
+  pthread_t tid[threads];
+  struct BlendJob job[threads];
+  for (int t=0; t<threads; t++) {
+    job[t] = (struct BlendJob){
+      .dst = dst, .img1 = img1, .img2 = img2, .y = y, .x = x, .type = type, .mode = mode,
+      .alpha = alpha, .unit_h = unit_h, .unit_w = img1->tile_width, .first = t, .step = threads
+    };
+    if (pthread_create(&tid[t], NULL, blend_units, &job[t])) panic("Cannot create thread", 0);
+  }
+  for (int t=0; t<threads; t++) pthread_join(tid[t], NULL);
+}
+
+
+struct Image blend_tiled(struct TiledImage *img1, struct TiledImage *img2, int y, int x,
+                         int height, int width, int type, int mode, double alpha, int threads)
+{
+  struct Image blended = { .height = height, .width = width, .channels = 4 };
+  size_t size = (size_t)height * width * 4;
+  if ((blended.data = malloc(size ? size : 1)) == NULL) {
+    panic("Failed to allocate memory for image", errno);
+  }
+
+  blend_tiled_into(blended, img1, img2, y, x, type, mode, alpha, threads);
+
+  return blended;
+}
@@ -17,26 +17,21 @@
 #include "blend.h"
 
 
-struct Image blend_int(struct Image img1, struct Image img2, int overlay, int alpha)
+void blend_int_into(struct Image dst, struct Image img1, struct Image img2, int overlay, int alpha)
 {
   if (img1.channels != 4) abort();
 
-  // Initialize blended image
-  struct Image blended = {
-    .height   = img1.height,
-    .width    = img1.width,
-    .channels = img1.channels
-  };
-  blended.data = malloc(blended.height*blended.width*blended.channels*sizeof(uint8));
-  if (blended.data == NULL) abort();
-
   // Merge Mode
+  // (load both alpha values first: dst may alias img1)
+  int alpha1, alpha2;
   if (overlay == 0) {
-    for (int h=0; h<blended.height; h++) {
-      for (int w=0; w<blended.width; w++) {
-        PIXEL(blended, h, w, 3) = (PIXEL(img1, h, w, 3) * (256 - alpha) + PIXEL(img2, h, w, 3) * alpha) >> 8;
-        for (int c=0; c<blended.channels-1; c++) {
-          PIXEL(blended, h, w, c) = (PIXEL(img1, h, w, c) * PIXEL(img1, h, w, 3) * (256 - alpha) + PIXEL(img2, h, w, c) * PIXEL(img2, h, w, 3) * alpha) >> 16;
+    for (int h=0; h<dst.height; h++) {
+      for (int w=0; w<dst.width; w++) {
+        alpha1 = PIXEL(img1, h, w, 3);
+        alpha2 = PIXEL(img2, h, w, 3);
+        PIXEL(dst, h, w, 3) = (alpha1 * (256 - alpha) + alpha2 * alpha) >> 8;
+        for (int c=0; c<dst.channels-1; c++) {
+          PIXEL(dst, h, w, c) = (PIXEL(img1, h, w, c) * alpha1 * (256 - alpha) + PIXEL(img2, h, w, c) * alpha2 * alpha) >> 16;
         }
       }
     }
@@ -45,16 +40,33 @@ struct Image blend_int(struct Image img1, struct Image img2, int overlay, int al
   // Overlay Mode
   int alpha_combined;
   if (overlay == 1) {
-    for (int h=0; h<blended.height; h++) {
-      for (int w=0; w<blended.width; w++) {
-        PIXEL(blended, h, w, 3) = PIXEL(img1, h, w, 3);
+    for (int h=0; h<dst.height; h++) {
+      for (int w=0; w<dst.width; w++) {
+        PIXEL(dst, h, w, 3) = PIXEL(img1, h, w, 3);
         alpha_combined = (PIXEL(img2, h, w, 3) * alpha) >> 8;
-        for (int c=0; c<blended.channels-1; c++) {
-          PIXEL(blended, h, w, c) = (PIXEL(img1, h, w, c) * (256 - alpha_combined) + PIXEL(img2, h, w, c) * alpha_combined) >> 8;
+        for (int c=0; c<dst.channels-1; c++) {
+          PIXEL(dst, h, w, c) = (PIXEL(img1, h, w, c) * (256 - alpha_combined) + PIXEL(img2, h, w, c) * alpha_combined) >> 8;
         }
       }
     }
   }
+}
+
+
+struct Image blend_int(struct Image img1, struct Image img2, int overlay, int alpha)
+{
+  if (img1.channels != 4) abort();
+
+  // Initialize blended image
+  struct Image blended = {
+    .height   = img1.height,
+    .width    = img1.width,
+    .channels = img1.channels
+  };
+  blended.data = malloc(blended.height*blended.width*blended.channels*sizeof(uint8));
+  if (blended.data == NULL) abort();
+
+  blend_int_into(blended, img1, img2, overlay, alpha);
 
   return blended;
 }
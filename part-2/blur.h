@@ -2,6 +2,7 @@
 #define __BLUR_H__
 
 #include "imlib.h"
+#include "imlib_planar.h"
 
 
 /// @brief Blurs an image with a kernel using floating-point math and returns the blurred image.
@@ -20,4 +21,72 @@ struct Image blur_float(struct Image image, int kernel_size);
 struct Image blur_int(struct Image image, int kernel_size);
 
 
+/// @brief Blurs @a image into @a dst using floating-point math. Both images may be views (see
+///        image_view()); only the pixels of @a dst are computed.
+///
+/// @param dst output image. Must be (kernel_size-1) smaller than @a image in both dimensions
+///        and must not overlap @a image.
+/// @param image image to blur.
+/// @param kernel_size size of kernel. Valid values: 3 (3x3), 5 (5x5), and 7 (7x7 kernel).
+void blur_float_into(struct Image dst, struct Image image, int kernel_size);
+
+
+/// @brief Blurs @a image into @a dst using fixed-point math. See blur_float_into().
+///
+/// @param dst output image. Must be (kernel_size-1) smaller than @a image in both dimensions
+///        and must not overlap @a image.
+/// @param image image to blur.
+/// @param kernel_size size of kernel. Valid values: 3 (3x3), 5 (5x5), and 7 (7x7 kernel).
+void blur_int_into(struct Image dst, struct Image image, int kernel_size);
+
+
+/// @brief Blurs the planar image @a image into @a dst using fixed-point math. The result is
+///        identical to blur_int_into() on the interleaved image.
+///
+/// @param dst output image. Must be (kernel_size-1) smaller than @a image in both dimensions
+///        and have the same number of channels.
+/// @param image image to blur.
+/// @param kernel_size size of kernel. Valid values: 3 (3x3), 5 (5x5), and 7 (7x7 kernel).
+void blur_int_planar_into(struct PlanarImage dst, struct PlanarImage image, int kernel_size);
+
+
+/// @brief Blurs the planar image @a image using fixed-point math and returns the blurred image.
+///
+/// @param image image to blur.
+/// @param kernel_size size of kernel. Valid values: 3 (3x3), 5 (5x5), and 7 (7x7 kernel).
+/// @retval struct PlanarImage blurred image. Free with planar_free().
+struct PlanarImage blur_int_planar(struct PlanarImage image, int kernel_size);
+
+
+/// @brief Blurs the rectangle (@a y, @a x) - (@a y + dst.height, @a x + dst.width) of the
+///        blurred image of @a img into @a dst, reading only the input tiles the rectangle
+///        depends on. Work units along the tile grid are processed by @a threads threads. The
+///        result is identical to the same rectangle of blur_float()/blur_int() on the whole image.
+///
+/// @param dst output image with the channels of @a img. May be a view.
+/// @param img input image opened with tiled_open()
+/// @param y y coordinate of the rectangle in the blurred image
+/// @param x x coordinate of the rectangle in the blurred image
+/// @param kernel_size size of kernel. Valid values: 3 (3x3), 5 (5x5), and 7 (7x7 kernel).
+/// @param type 0: floating-point, 1: fixed-point blurring
+/// @param threads number of threads
+void blur_tiled_into(struct Image dst, struct TiledImage *img, int y, int x, int kernel_size,
+                     int type, int threads);
+
+
+/// @brief Blurs a rectangle of @a img and returns it. See blur_tiled_into().
+///
+/// @param img input image opened with tiled_open()
+/// @param y y coordinate of the rectangle in the blurred image
+/// @param x x coordinate of the rectangle in the blurred image
+/// @param height height of the rectangle
+/// @param width  width of the rectangle
+/// @param kernel_size size of kernel. Valid values: 3 (3x3), 5 (5x5), and 7 (7x7 kernel).
+/// @param type 0: floating-point, 1: fixed-point blurring
+/// @param threads number of threads
+/// @retval struct Image blurred rectangle
+struct Image blur_tiled(struct TiledImage *img, int y, int x, int height, int width,
+                        int kernel_size, int type, int threads);
+
+
 #endif // __BLUR_H__
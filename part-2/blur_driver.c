@@ -41,15 +41,24 @@
 #include <libgen.h>
 
 #include "imlib.h"
+#include "imlib_cache.h"
 #include "blur.h"
 
 enum BlurType { btFloat, btInt };
+enum Layout { lyInterleaved, lyPlanar };
 
 struct Arguments {
   enum BlurType type;
   char *kernel;
+  enum Layout layout;             // planar: convert, blur planes (int only), convert back
   char *image;
   char *output;
+  char *cache;                    // result cache directory (NULL: no caching)
+  long long cache_size;
+  int roi;                        // blur only the rectangle (roi_x, roi_y) - (+roi_w, +roi_h)
+  int roi_x, roi_y, roi_w, roi_h;
+  int threads;                    // threads for --roi
+  int tiled;                      // save the result in the tiled RAW format with this tile size
 };
 
 
@@ -61,7 +70,8 @@ void syntax(char *msg)
   if (msg) printf("%s\n\n", msg);
 
   printf("Usage: blur_driver [-h] [--type {int,float}] [--kernel {3x3,5x5,7x7}] "
-                            "[--output OUTPUT] image\n"
+                            "[--layout {interleaved,planar}] [--roi X,Y,WxH] [--threads N] "
+                            "[--tiled N] [--cache DIR] [--cache-size MB] [--output OUTPUT] image\n"
          "\n"
          "Positional arguments:\n"
          "  image                       The image to blur\n"
@@ -70,7 +80,17 @@ void syntax(char *msg)
          "  -h/--help                   Show this help message and exit\n"
          "  -t/--type {int,float}       Computation type (default: float)\n"
          "  -k/--kernel {3x3,5x5,7x7}   Kernel size (default: 3x3)\n"
-         "  -o/--output OUTPUT          Force name of output image\n");
+         "  --layout {interleaved,planar}\n"
+         "                              Pixel layout for the computation (default: interleaved).\n"
+         "                              planar requires '--type int'.\n"
+         "  --roi X,Y,WxH               Only compute the WxH rectangle of the result at (X,Y).\n"
+         "                              Only the input tiles it depends on are read.\n"
+         "  --threads N                 Number of threads for --roi (default: 4)\n"
+         "  --tiled N                   Save the result in the tiled RAW format with NxN tiles\n"
+         "  --cache DIR                 Reuse results of identical jobs stored in DIR\n"
+         "  --cache-size MB             Size limit of the result cache (default: %lld MB)\n"
+         "  -o/--output OUTPUT          Force name of output image\n",
+         CACHE_SIZE >> 20);
 
   exit(EXIT_FAILURE);
 }
@@ -83,7 +103,10 @@ void syntax(char *msg)
 /// @retval struct Argument parsed command line arguments
 struct Arguments parse_arguments(int argc, char *argv[])
 {
-  struct Arguments args = { .type = btFloat, .kernel = "3x3", .image = NULL, .output = NULL };
+  struct Arguments args = {
+    .type = btFloat, .kernel = "3x3", .layout = lyInterleaved, .image = NULL, .output = NULL,
+    .cache = NULL, .cache_size = CACHE_SIZE, .roi = 0, .threads = 4, .tiled = 0
+  };
 
   for (int i=1; i<argc; i++) {
     if (!strcmp("--type", argv[i]) || !strcmp("-t", argv[i])) {
@@ -101,6 +124,48 @@ struct Arguments parse_arguments(int argc, char *argv[])
       }
       args.kernel = opt;
     } else
+    if (!strcmp("--layout", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--layout'.");
+      char *opt = argv[i];
+      if (!strcmp("interleaved", opt)) args.layout = lyInterleaved;
+      else if (!strcmp("planar", opt)) args.layout = lyPlanar;
+      else syntax("Invalid option to '--layout'");
+    } else
+    if (!strcmp("--roi", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--roi'.");
+      char *endptr;
+      args.roi_x = strtol(argv[i], &endptr, 10);
+      if (*endptr == ',') args.roi_y = strtol(endptr+1, &endptr, 10);
+      if (*endptr == ',') args.roi_w = strtol(endptr+1, &endptr, 10);
+      if (*endptr == 'x') args.roi_h = strtol(endptr+1, &endptr, 10);
+      if (*endptr != '\0') syntax("Invalid rectangle after '--roi'. Use X,Y,WxH.");
+      if ((args.roi_x < 0) || (args.roi_y < 0) || (args.roi_w < 1) || (args.roi_h < 1)) {
+        syntax("Invalid rectangle after '--roi'.");
+      }
+      args.roi = 1;
+    } else
+    if (!strcmp("--threads", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--threads'.");
+      char *endptr;
+      args.threads = strtol(argv[i], &endptr, 10);
+      if ((*endptr != '\0') || (args.threads < 1)) syntax("Invalid number of threads.");
+    } else
+    if (!strcmp("--tiled", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--tiled'.");
+      char *endptr;
+      args.tiled = strtol(argv[i], &endptr, 10);
+      if ((*endptr != '\0') || (args.tiled < 1)) syntax("Invalid tile size after '--tiled'.");
+    } else
+    if (!strcmp("--cache", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--cache'.");
+      args.cache = argv[i];
+    } else
+    if (!strcmp("--cache-size", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--cache-size'.");
+      char *endptr;
+      args.cache_size = strtoll(argv[i], &endptr, 10) << 20;
+      if ((*endptr != '\0') || (args.cache_size <= 0)) syntax("Invalid size after '--cache-size'.");
+    } else
     if (!strcmp("--output", argv[i]) || !strcmp("-o", argv[i])) {
       if (++i == argc) syntax("Missing argument after '--output'.");
       args.output = argv[i];
@@ -114,6 +179,12 @@ struct Arguments parse_arguments(int argc, char *argv[])
   }
 
   if (args.image == NULL) syntax("No image file provided.");
+  if ((args.layout == lyPlanar) && (args.type != btInt)) {
+    syntax("'--layout planar' requires '--type int'.");
+  }
+  if (args.roi && ((args.layout == lyPlanar) || args.cache)) {
+    syntax("'--roi' cannot be combined with '--layout planar' or '--cache'.");
+  }
 
   return args;
 }
@@ -139,12 +210,36 @@ void splitext(char *basename, char **ext)
 }
 
 
+/// @brief Wall-clock time in seconds (CPU time would add up the time of all threads).
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/// @brief Print the result cache statistics.
+///
+/// @param cache result cache
+void print_cache_stats(struct ResultCache *cache)
+{
+  long hits, misses, evictions;
+  cache_stats(cache, &hits, &misses, &evictions);
+  printf("Result cache: %ld hits, %ld misses (%.1f%% hit rate), %ld evictions\n",
+         hits, misses, hits + misses ? 100.0*hits/(hits + misses) : 0.0, evictions);
+}
+
+
 int main(int argc, char *argv[])
 {
   struct Arguments args;
   int kernel_size;
   struct Image image, blurred;
   char *bfn;
+  struct ResultCache *cache = NULL;
+  struct TiledImage *tiled = NULL;
+  uint64_t hash, key = 0;
 
   // Parse command line arguments
   args = parse_arguments(argc, argv);
@@ -152,24 +247,26 @@ int main(int argc, char *argv[])
   // Extract arguments
   kernel_size = args.kernel[0] - '0';
 
-  // Read image
+  // Read image (--roi: only open it; the tiles are read while blurring)
   printf("Loading RAW image %s...\n", args.image);
-  image = read_raw_image(args.image);
-  printf("  Image dimensions %d x %d x %d\n", image.height, image.width, image.channels);
-
-
-  // Call blur function
-  printf("Blurring image (kernel size: %s, type: %s)...\n", 
-         args.kernel, args.type == btFloat ? "float" : "int" );
-
-  clock_t t_start = clock();
-  if (args.type == btFloat) {
-    blurred = blur_float(image, kernel_size);
+  if (args.roi) {
+    tiled = tiled_open(args.image);
+    image = (struct Image){ NULL, tiled->height, tiled->width, tiled->channels, 0 };
+    if ((args.roi_y + args.roi_h > image.height - kernel_size + 1) ||
+        (args.roi_x + args.roi_w > image.width - kernel_size + 1)) {
+      printf("Rectangle %dx%d at (%d,%d) is not inside the blurred image (%dx%d)\n",
+             args.roi_w, args.roi_h, args.roi_x, args.roi_y,
+             image.width - kernel_size + 1, image.height - kernel_size + 1);
+      exit(EXIT_FAILURE);
+    }
+  } else
+  if (args.cache) {
+    cache = cache_open(args.cache, args.cache_size);
+    image = read_raw_image_hash(args.image, &hash);
   } else {
-    blurred = blur_int(image, kernel_size);
+    image = read_raw_image(args.image);
   }
-  clock_t t_stop = clock();
-  printf("  Elapsed time: %.6f seconds\n", ((float)(t_stop-t_start))/CLOCKS_PER_SEC);
+  printf("  Image dimensions %d x %d x %d\n", image.height, image.width, image.channels);
 
 
   // Construct output filename
@@ -193,16 +290,84 @@ int main(int argc, char *argv[])
   }
 
 
+  // Look up result cache
+  if (cache) {
+    char params[64];
+    // the cached entry is the saved file, so the output format is part of the job
+    snprintf(params, sizeof(params), "blur %s %s %s %d", args.type == btFloat ? "float" : "int",
+             args.kernel, args.tiled ? "tiled" : "raw", args.tiled);
+    key = cache_key(params, &hash, 1);
+
+    clock_t t_start = clock();
+    int hit = cache_fetch(cache, key, bfn);
+    clock_t t_stop = clock();
+    if (hit) {
+      printf("Result found in cache (key %016llx)\n", (unsigned long long)key);
+      printf("  Elapsed time: %.6f seconds\n", ((float)(t_stop-t_start))/CLOCKS_PER_SEC);
+      printf("  Saved as %s\n", bfn);
+      print_cache_stats(cache);
+
+      free(bfn);
+      free(image.data);
+      cache_close(cache);
+      return EXIT_SUCCESS;
+    }
+  }
+
+
+  // Call blur function
+  printf("Blurring image (kernel size: %s, type: %s)...\n", 
+         args.kernel, args.type == btFloat ? "float" : "int" );
+
+  clock_t t_start = clock(), t_kernel = 0;
+  if (tiled) {
+    double t_wall = now();
+    blurred = blur_tiled(tiled, args.roi_y, args.roi_x, args.roi_h, args.roi_w, kernel_size,
+                         args.type == btInt, args.threads);
+    printf("  Rectangle %dx%d at (%d,%d): %.6f seconds (wall clock, %d threads)\n",
+           args.roi_w, args.roi_h, args.roi_x, args.roi_y, now() - t_wall, args.threads);
+  } else
+  if (args.layout == lyPlanar) {
+    struct PlanarImage planar = image_to_planar(image);
+    t_kernel = clock();
+    struct PlanarImage pblurred = blur_int_planar(planar, kernel_size);
+    t_kernel = clock() - t_kernel;
+    blurred = planar_to_image(pblurred);
+    planar_free(&planar);
+    planar_free(&pblurred);
+  } else
+  if (args.type == btFloat) {
+    blurred = blur_float(image, kernel_size);
+  } else {
+    blurred = blur_int(image, kernel_size);
+  }
+  clock_t t_stop = clock();
+  printf("  Elapsed time: %.6f seconds\n", ((float)(t_stop-t_start))/CLOCKS_PER_SEC);
+  if (args.layout == lyPlanar) {
+    printf("  Planar blur: %.6f seconds (layout conversion: %.6f seconds)\n",
+           ((float)t_kernel)/CLOCKS_PER_SEC, ((float)(t_stop-t_start-t_kernel))/CLOCKS_PER_SEC);
+  }
+
+
   // Save blurred RAW image
   printf("Saving result (%d x %d x %d)...\n", blurred.height, blurred.width, blurred.channels);
   printf("  Saving as %s\n", bfn);
-  write_raw_image(bfn, blurred);
+  if (args.tiled) write_raw_image_tiled(bfn, blurred, args.tiled);
+  else write_raw_image(bfn, blurred);
+
+  if (cache) {
+    cache_store_file(cache, key, bfn);
+    printf("  Stored in cache (key %016llx)\n", (unsigned long long)key);
+    print_cache_stats(cache);
+    cache_close(cache);
+  }
 
 
   // Cleanup
   free(bfn);
   free(image.data);
   free(blurred.data);
+  tiled_close(tiled);
 
 
   // That's all, folks!
@@ -18,7 +18,7 @@
 #include "blur.h"
 
 
-struct Image blur_float(struct Image image, int kernel_size)
+void blur_float_into(struct Image dst, struct Image image, int kernel_size)
 {
   // Make Kernel
   double kernel[kernel_size][kernel_size];
@@ -29,30 +29,36 @@ struct Image blur_float(struct Image image, int kernel_size)
     }
   }
   
-  // Initialize output image
-  struct Image output = {
-    .height   = image.height - kernel_size + 1,
-    .width    = image.width - kernel_size + 1,
-    .channels = image.channels
-  };
-  output.data = (uint8*) malloc(sizeof(uint8) * output.height * output.width * output.channels);
-  if (output.data == NULL) abort();
-
   // Calculate convolution
   double convolution;
-  for (int c=0; c<output.channels; c++) {
-    for (int h=0; h<output.height; h++) {
-      for (int w=0; w<output.width; w++) {
+  for (int c=0; c<dst.channels; c++) {
+    for (int h=0; h<dst.height; h++) {
+      for (int w=0; w<dst.width; w++) {
         convolution = 0.0;
         for (int y=0; y<kernel_size; y++) {
           for (int x=0; x<kernel_size; x++) {
             convolution += PIXEL(image, h+y, w+x, c) * kernel[y][x];
           }
         }
-        PIXEL(output, h, w, c) = (uint8)convolution;
+        PIXEL(dst, h, w, c) = (uint8)convolution;
       }
     }
   }
+}
+
+
+struct Image blur_float(struct Image image, int kernel_size)
+{
+  // Initialize output image
+  struct Image output = {
+    .height   = image.height - kernel_size + 1,
+    .width    = image.width - kernel_size + 1,
+    .channels = image.channels
+  };
+  output.data = (uint8*) malloc(sizeof(uint8) * output.height * output.width * output.channels);
+  if (output.data == NULL) abort();
+
+  blur_float_into(output, image, kernel_size);
 
   return output;
 }
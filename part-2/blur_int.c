@@ -16,7 +16,7 @@
 #include "blur.h"
 
 
-struct Image blur_int(struct Image image, int kernel_size)
+void blur_int_into(struct Image dst, struct Image image, int kernel_size)
 {
   // Make kernel
   int kernel[kernel_size][kernel_size];
@@ -28,30 +28,36 @@ struct Image blur_int(struct Image image, int kernel_size)
   }
   kernel[kernel_size/2][kernel_size/2] = 255 - (kernel_size * kernel_size - 1) * (255 / (kernel_size * kernel_size));
 
-  // Initialize output image
-  struct Image output = {
-    .height   = image.height - kernel_size + 1,
-    .width    = image.width - kernel_size + 1,
-    .channels = image.channels
-  };
-  output.data = (uint8*) malloc(sizeof(uint8) * output.height * output.width * output.channels);
-  if (output.data == NULL) abort();
-
   // Calculate convolution 
   int convolution;
-  for (int c=0; c<output.channels; c++) {
-    for (int h=0; h<output.height; h++) {
-      for (int w=0; w<output.width; w++) {
+  for (int c=0; c<dst.channels; c++) {
+    for (int h=0; h<dst.height; h++) {
+      for (int w=0; w<dst.width; w++) {
         convolution = 0;
         for (int y=0; y<kernel_size; y++) {
           for (int x=0; x<kernel_size; x++) {
             convolution += PIXEL(image, h+y, w+x, c) * kernel[y][x];
           }
         }
-        PIXEL(output, h, w, c) = convolution >> 8;
+        PIXEL(dst, h, w, c) = convolution >> 8;
       }
     }
   }
+}
+
+
+struct Image blur_int(struct Image image, int kernel_size)
+{
+  // Initialize output image
+  struct Image output = {
+    .height   = image.height - kernel_size + 1,
+    .width    = image.width - kernel_size + 1,
+    .channels = image.channels
+  };
+  output.data = (uint8*) malloc(sizeof(uint8) * output.height * output.width * output.channels);
+  if (output.data == NULL) abort();
+
+  blur_int_into(output, image, kernel_size);
 
   return output;
 }
@@ -0,0 +1,99 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Image blurring (int, planar)
+///        The kernel of blur_int_into() has the same weight w for all taps except the center one
+///        (wc), so the convolution is w * (sum of the window) + (wc - w) * center. Each plane is
+///        processed row by row: the window's column sums of an output row are computed first,
+///        then eight window sums are formed at a time from them. All intermediate values fit in
+///        16 bits (the convolution is at most 255 * 255), so the SSE2 version works on 16-bit
+///        lanes and produces the same result as the interleaved version.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "blur.h"
+
+
+void blur_int_planar_into(struct PlanarImage dst, struct PlanarImage image, int kernel_size)
+{
+  int k = kernel_size;
+  if ((dst.channels != image.channels) ||
+      (dst.height != image.height - k + 1) || (dst.width != image.width - k + 1)) abort();
+
+  // Same kernel as blur_int_into()
+  int w = 255 / (k * k);
+  int wc = 255 - (k * k - 1) * w;
+
+  unsigned short *colsum = malloc(image.stride * sizeof(unsigned short));
+  if (colsum == NULL) abort();
+
+  for (int c=0; c<dst.channels; c++) {
+    for (int h=0; h<dst.height; h++) {
+      // Column sums of the k rows of the window (the stride is a multiple of 16)
+      int x = 0;
+#ifdef __SSE2__
+      const __m128i zero = _mm_setzero_si128();
+      for (; x<image.stride; x+=16) {
+        __m128i lo = zero, hi = zero;
+        for (int y=0; y<k; y++) {
+          __m128i v = _mm_loadu_si128((const __m128i*)&PLANE(image, c, h+y, x));
+          lo = _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero));
+          hi = _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero));
+        }
+        _mm_storeu_si128((__m128i*)(colsum + x), lo);
+        _mm_storeu_si128((__m128i*)(colsum + x + 8), hi);
+      }
+#endif
+      for (; x<image.width; x++) {
+        colsum[x] = 0;
+        for (int y=0; y<k; y++) colsum[x] += PLANE(image, c, h+y, x);
+      }
+
+      // Window sums and convolution
+      const uint8 *center = &PLANE(image, c, h + k/2, k/2);
+      uint8 *d = &PLANE(dst, c, h, 0);
+      x = 0;
+#ifdef __SSE2__
+      const __m128i vw = _mm_set1_epi16(w), vwc = _mm_set1_epi16(wc - w);
+      for (; x+8 <= dst.width; x+=8) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(colsum + x));
+        for (int i=1; i<k; i++) {
+          s = _mm_add_epi16(s, _mm_loadu_si128((const __m128i*)(colsum + x + i)));
+        }
+        __m128i m = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(center + x)), zero);
+        __m128i conv = _mm_add_epi16(_mm_mullo_epi16(s, vw), _mm_mullo_epi16(m, vwc));
+        conv = _mm_srli_epi16(conv, 8);
+        _mm_storel_epi64((__m128i*)(d + x), _mm_packus_epi16(conv, conv));
+      }
+#endif
+      for (; x<dst.width; x++) {
+        int s = 0;
+        for (int i=0; i<k; i++) s += colsum[x+i];
+        d[x] = (s * w + center[x] * (wc - w)) >> 8;
+      }
+    }
+  }
+
+  free(colsum);
+}
+
+
+struct PlanarImage blur_int_planar(struct PlanarImage image, int kernel_size)
+{
+  struct PlanarImage output = planar_alloc(image.height - kernel_size + 1,
+                                           image.width - kernel_size + 1, image.channels);
+
+  blur_int_planar_into(output, image, kernel_size);
+
+  return output;
+}
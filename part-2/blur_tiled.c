@@ -0,0 +1,112 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Image blurring (tiled, parallel)
+///        Blurs a region of an image on disk without reading the rest of the image. The output
+///        region is split into work units along the tile grid of the input; units are at least
+///        TILED_UNIT_ROWS rows high so that files with one-row tiles (uncompressed RAW) are read
+///        in reasonably large pieces. Each thread reads the input of its units, including the
+///        (kernel_size-1) halo, into a private buffer and blurs it into the output with
+///        blur_int_into() or blur_float_into().
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "blur.h"
+
+#define TILED_UNIT_ROWS 64        ///< minimum height of a work unit (rows)
+
+struct BlurJob {
+  struct Image dst;               // output region
+  struct TiledImage *img;
+  int y, x;                       // top-left corner of the output region
+  int kernel_size, type;
+  int unit_h, unit_w;             // work unit size (aligned to the tile grid)
+  int first, step;                // units first, first+step, ...
+};
+
+
+/// @brief Blur the work units of @a arg (struct BlurJob).
+static void *blur_units(void *arg)
+{
+  struct BlurJob *j = arg;
+  int k = j->kernel_size, ch = j->dst.channels;
+  int uy0 = j->y / j->unit_h, ux0 = j->x / j->unit_w;
+  int nuy = (j->y + j->dst.height - 1) / j->unit_h - uy0 + 1;
+  int nux = (j->x + j->dst.width - 1) / j->unit_w - ux0 + 1;
+
+  struct Image in = { .channels = ch };
+  in.data = malloc((size_t)(j->unit_h + k-1) * (j->unit_w + k-1) * ch);
+  if (in.data == NULL) panic("Failed to allocate memory for tile buffer", errno);
+
+  for (int u=j->first; u<nuy*nux; u+=j->step) {
+    // intersection of the unit with the output region
+    int y0 = (uy0 + u/nux) * j->unit_h, x0 = (ux0 + u%nux) * j->unit_w;
+    int y1 = y0 + j->unit_h, x1 = x0 + j->unit_w;
+    if (y0 < j->y) y0 = j->y;
+    if (x0 < j->x) x0 = j->x;
+    if (y1 > j->y + j->dst.height) y1 = j->y + j->dst.height;
+    if (x1 > j->x + j->dst.width) x1 = j->x + j->dst.width;
+
+    in.height = y1 - y0 + k-1;
+    in.width = x1 - x0 + k-1;
+    tiled_read_into(in, j->img, y0, x0);
+
+    struct Image out = image_view(j->dst, y0 - j->y, x0 - j->x, y1 - y0, x1 - x0);
+    if (j->type == 0) blur_float_into(out, in, k);
+    else blur_int_into(out, in, k);
+  }
+
+  free(in.data);
+  return NULL;
+}
+
+
+void blur_tiled_into(struct Image dst, struct TiledImage *img, int y, int x, int kernel_size,
+                     int type, int threads)
+{
+  int k = kernel_size;
+  if ((dst.channels != img->channels) || (y < 0) || (x < 0) ||
+      (y + dst.height > img->height - k + 1) || (x + dst.width > img->width - k + 1)) {
+    panic("Blur region is not inside the image.", 0);
+  }
+  if ((dst.height == 0) || (dst.width == 0)) return;
+  if (threads < 1) threads = 1;
+
+  int unit_h = img->tile_height;
+  if (unit_h < TILED_UNIT_ROWS) unit_h *= (TILED_UNIT_ROWS + unit_h - 1) / unit_h;
+
+  pthread_t tid[threads];
+  struct BlurJob job[threads];
+  for (int t=0; t<threads; t++) {
+    job[t] = (struct BlurJob){
+      .dst = dst, .img = img, .y = y, .x = x, .kernel_size = k, .type = type,
+      .unit_h = unit_h, .unit_w = img->tile_width, .first = t, .step = threads
+    };
+    if (pthread_create(&tid[t], NULL, blur_units, &job[t])) panic("Cannot create thread", 0);
+  }
+  for (int t=0; t<threads; t++) pthread_join(tid[t], NULL);
+}
+
+
+struct Image blur_tiled(struct TiledImage *img, int y, int x, int height, int width,
+                        int kernel_size, int type, int threads)
+{
+  struct Image output = { .height = height, .width = width, .channels = img->channels };
+  size_t size = (size_t)height * width * img->channels;
+  if ((output.data = malloc(size ? size : 1)) == NULL) {
+    panic("Failed to allocate memory for image", errno);
+  }
+
+  blur_tiled_into(output, img, y, x, kernel_size, type, threads);
+
+  return output;
+}
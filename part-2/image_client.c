@@ -0,0 +1,378 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Image processing client
+///        Sends blend and blur requests to image_server. The command line mirrors blend_driver
+///        and blur_driver. Input images are referenced by path (cached by the server) or, with
+///        --shm, passed as memfds. The result is received as a memfd and written to disk.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "imlib.h"
+#include "image_server.h"
+
+struct Arguments {
+  char *socket;
+  int shm;
+  enum ServerOp op;
+  int type;                       // 0: float, 1: int
+  int mode;                       // 0: merge, 1: overlay
+  double alpha;
+  char *kernel;
+  char *image[2];
+  int nimages;
+  char *output;
+};
+
+
+/// @brief Print program syntax and exit. Does not return.
+///
+/// @param msg optional error/informational message.
+void syntax(char *msg)
+{
+  if (msg) printf("%s\n\n", msg);
+
+  printf("Usage: image_client [-h] [--socket SOCKET] [--shm] command [options] image(s)\n"
+         "\n"
+         "Commands:\n"
+         "  blend [--type {int,float}] [--mode {overlay,merge}] [--alpha ALPHA] [--output OUTPUT]\n"
+         "        image1 image2\n"
+         "  blur [--type {int,float}] [--kernel {3x3,5x5,7x7}] [--output OUTPUT] image\n"
+         "  stats                       Show server statistics\n"
+         "  shutdown                    Show server statistics and terminate the server\n"
+         "\n"
+         "Options:\n"
+         "  -h/--help                   Show this help message and exit\n"
+         "  -s/--socket SOCKET          Path of the server socket (default: %s)\n"
+         "  --shm                       Pass input images in shared memory instead of by path\n"
+         "  -t/--type {int,float}       Computation type (default: float)\n"
+         "  -m/--mode {overlay,merge}   Blending mode (default: overlay)\n"
+         "  -a/--alpha ALPHA            Alpha value (0.0 - 1.0, default: 0.5)\n"
+         "  -k/--kernel {3x3,5x5,7x7}   Kernel size (default: 3x3)\n"
+         "  -o/--output OUTPUT          Force name of output image\n",
+         SERVER_SOCKET);
+
+  exit(EXIT_FAILURE);
+}
+
+
+/// @brief Parse arguments
+///
+/// @param argc number of command line arguments
+/// @param argv command line arguments
+/// @retval struct Argument parsed command line arguments
+struct Arguments parse_arguments(int argc, char *argv[])
+{
+  struct Arguments args = {
+    .socket = SERVER_SOCKET, .shm = 0, .op = -1, .type = 0, .mode = 1, .alpha = 0.5,
+    .kernel = "3x3", .image = { NULL, NULL }, .nimages = 0, .output = NULL
+  };
+
+  for (int i=1; i<argc; i++) {
+    if (!strcmp("--socket", argv[i]) || !strcmp("-s", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--socket'.");
+      args.socket = argv[i];
+    } else
+    if (!strcmp("--shm", argv[i])) {
+      args.shm = 1;
+    } else
+    if (!strcmp("--type", argv[i]) || !strcmp("-t", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--type'.");
+      char *opt = argv[i];
+      if (!strcmp("float", opt)) args.type = 0;
+      else if (!strcmp("int", opt)) args.type = 1;
+      else syntax("Invalid option to '--type'");
+    } else
+    if (!strcmp("--mode", argv[i]) || !strcmp("-m", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--mode'.");
+      char *opt = argv[i];
+      if (!strcmp("overlay", opt)) args.mode = 1;
+      else if (!strcmp("merge", opt)) args.mode = 0;
+      else syntax("Invalid option to '--mode'");
+    } else
+    if (!strcmp("--alpha", argv[i]) || !strcmp("-a", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--alpha'.");
+      char *endptr;
+      args.alpha = strtod(argv[i], &endptr);
+      if (*endptr != '\0') syntax("Invalid float after '--alpha'.");
+    } else
+    if (!strcmp("--kernel", argv[i]) || !strcmp("-k", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--kernel'.");
+      char *opt = argv[i];
+      if (strcmp("3x3", opt) && strcmp("5x5", opt) && strcmp("7x7", opt)) {
+        syntax("Invalid option to '--kernel'.");
+      }
+      args.kernel = opt;
+    } else
+    if (!strcmp("--output", argv[i]) || !strcmp("-o", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--output'.");
+      args.output = argv[i];
+    } else
+    if (!strcmp("--help", argv[i]) || !strcmp("-h", argv[i])) {
+      syntax(NULL);
+    } else
+    if ((int)args.op < 0) {
+      if (!strcmp("blend", argv[i])) args.op = soBlend;
+      else if (!strcmp("blur", argv[i])) args.op = soBlur;
+      else if (!strcmp("stats", argv[i])) args.op = soStats;
+      else if (!strcmp("shutdown", argv[i])) args.op = soShutdown;
+      else syntax("Unknown command.");
+    } else {
+      if (args.nimages < 2) args.image[args.nimages++] = argv[i];
+      else syntax("Too many images or unknown option.");
+    }
+  }
+
+  if ((int)args.op < 0) syntax("No command given.");
+  if ((args.op == soBlend) && (args.nimages != 2)) syntax("Please provide two images files.");
+  if ((args.op == soBlur) && (args.nimages != 1)) syntax("Please provide one image file.");
+  if ((args.alpha < 0.0) || (args.alpha > 1.0)) {
+    syntax("Invalid alpha value. Value must be between 0.0 and 1.0.");
+  }
+
+  return args;
+}
+
+
+/// @brief Split a basename (filename.ext) into filename and extension at the last '.'.
+///        Basename is assumed to not contain any path delimiters. Warning: modifies basename!
+///
+/// @param[in/out] basename basename (filename.ext)
+/// @param[out] ext pointer to string to hold extension
+void splitext(char *basename, char **ext)
+{
+  *ext = NULL;
+
+  // assumption: basename is not NULL and does not contain a path
+  char *p = basename;
+  while (*p != '\0') {
+    if (*p == '.') *ext = p+1;
+    p++;
+  }
+
+  // split basename into filename and extension by removing the last '.'
+  if (*ext) *(*ext-1) = '\0';
+}
+
+
+/// @brief Construct the output file name the same way blend_driver and blur_driver do.
+///
+/// @retval char* file name (heap-allocated)
+char *output_filename(struct Arguments *args)
+{
+  char *bfn;
+
+  if (args->output != NULL) {
+    size_t bfn_size = strlen(args->output)+8;
+    bfn = calloc(bfn_size, sizeof(char));
+    snprintf(bfn, bfn_size, "%s.raw", args->output);
+    return bfn;
+  }
+
+  char *out, *dn, *bn1, *bn2 = NULL, *ext;
+  out = strdup(args->image[0]); dn = strdup(dirname(out));  free(out);
+  out = strdup(args->image[0]); bn1 = strdup(basename(out)); free(out);
+  splitext(bn1, &ext);
+
+  size_t bfn_size = strlen(dn)+strlen(bn1)+32;
+  if (args->op == soBlend) {
+    out = strdup(args->image[1]); bn2 = strdup(basename(out)); free(out);
+    splitext(bn2, &ext);
+    bfn_size += strlen(bn2);
+  }
+  bfn = calloc(bfn_size, sizeof(char));
+
+  if (args->op == soBlend) {
+    snprintf(bfn, bfn_size, "%s/%s_%s_%s_%.2g_%s.raw",
+             dn, bn1, bn2, args->mode ? "overlay" : "merge",
+             args->alpha, args->type ? "int" : "float");
+  } else {
+    snprintf(bfn, bfn_size, "%s/%s_%s_%s.raw",
+             dn, bn1, args->kernel, args->type ? "int" : "float");
+  }
+
+  free(dn); free(bn1); free(bn2);
+  return bfn;
+}
+
+
+/// @brief Copy the contents of a file into a new memfd (kernel-side copy). The memfd is sealed
+///        against resizing and writes, so the server can map it safely.
+///
+/// @retval int memfd
+int file_to_memfd(char *filename)
+{
+  struct stat st;
+  int in = open(filename, O_RDONLY);
+  if (in < 0) panic("Cannot open file", errno);
+  if (fstat(in, &st) < 0) panic("Cannot stat file", errno);
+
+  int fd = memfd_create(basename(filename), MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd < 0) panic("Cannot create memfd", errno);
+
+  off_t ofs = 0;
+  while (ofs < st.st_size) {
+    ssize_t n = sendfile(fd, in, &ofs, st.st_size - ofs);
+    if (n <= 0) panic("Cannot copy image to shared memory", n < 0 ? errno : EIO);
+  }
+  close(in);
+
+  if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE) < 0) {
+    panic("Cannot seal memfd", errno);
+  }
+
+  return fd;
+}
+
+
+/// @brief Copy the contents of a file descriptor into a file (kernel-side copy).
+void memfd_to_file(int fd, char *filename)
+{
+  struct stat st;
+  if (fstat(fd, &st) < 0) panic("Cannot stat result", errno);
+
+  int out = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out < 0) panic("Cannot open file", errno);
+
+  off_t ofs = 0;
+  while (ofs < st.st_size) {
+    ssize_t n = sendfile(out, fd, &ofs, st.st_size - ofs);
+    if (n <= 0) panic("Cannot write image data", n < 0 ? errno : EIO);
+  }
+  close(out);
+}
+
+
+int main(int argc, char *argv[])
+{
+  struct Arguments args;
+  struct ServerRequest req;
+  struct ServerResponse resp;
+  int fds[2], nfds = 0;
+
+  // Parse command line arguments
+  args = parse_arguments(argc, argv);
+
+  // Build request
+  memset(&req, 0, sizeof(req));
+  req.magic = SERVER_MAGIC;
+  req.op = args.op;
+  req.type = args.type;
+  req.mode = args.mode;
+  req.alpha = args.alpha;
+  req.kernel_size = args.kernel[0] - '0';
+  req.nimages = args.nimages;
+
+  for (int i=0; i<args.nimages; i++) {
+    if (args.shm) {
+      fds[nfds++] = file_to_memfd(args.image[i]);
+    } else {
+      // the server does not share our working directory
+      char path[PATH_MAX];
+      if (realpath(args.image[i], path) == NULL) panic("Cannot open file", errno);
+      if (strlen(path) >= MAX_PATH_LEN) panic("Path too long", 0);
+      strcpy(req.path[i], path);
+    }
+  }
+
+  // Connect to server
+  struct sockaddr_un addr = { .sun_family = AF_UNIX };
+  if (strlen(args.socket) >= sizeof(addr.sun_path)) panic("Socket path too long", 0);
+  strcpy(addr.sun_path, args.socket);
+
+  int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (sock < 0) panic("Cannot create socket", errno);
+  if (connect(sock, (struct sockaddr*)&addr, sizeof(addr)) < 0) panic("Cannot connect to server", errno);
+
+  struct timespec t_start, t_stop;
+  clock_gettime(CLOCK_MONOTONIC, &t_start);
+
+  // Send request with input memfds attached
+  char control[CMSG_SPACE(2 * sizeof(int))];
+  struct iovec iov = { &req, sizeof(req) };
+  struct msghdr msg = { .msg_iov = &iov, .msg_iovlen = 1 };
+  if (nfds > 0) {
+    memset(control, 0, sizeof(control));
+    msg.msg_control = control;
+    msg.msg_controllen = CMSG_SPACE(nfds * sizeof(int));
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(nfds * sizeof(int));
+    memcpy(CMSG_DATA(c), fds, nfds * sizeof(int));
+  }
+  if (sendmsg(sock, &msg, 0) < 0) panic("Cannot send request", errno);
+  for (int i=0; i<nfds; i++) close(fds[i]);
+
+  // Receive response and result memfd
+  int result = -1;
+  char rcontrol[CMSG_SPACE(sizeof(int))];
+  iov.iov_base = &resp;
+  iov.iov_len = sizeof(resp);
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = rcontrol;
+  msg.msg_controllen = sizeof(rcontrol);
+  int res = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+  if (res < 0) panic("Cannot receive response", errno);
+  if (res != sizeof(resp)) panic("Connection closed by server", 0);
+  for (struct cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+    if ((c->cmsg_level == SOL_SOCKET) && (c->cmsg_type == SCM_RIGHTS)) {
+      memcpy(&result, CMSG_DATA(c), sizeof(int));
+    }
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &t_stop);
+  close(sock);
+
+  resp.message[sizeof(resp.message)-1] = '\0';
+  if (resp.status < 0) {
+    printf("Request failed: %s\n", resp.message);
+    exit(EXIT_FAILURE);
+  }
+
+  if ((args.op == soStats) || (args.op == soShutdown)) {
+    printf("%s", resp.message);
+    return EXIT_SUCCESS;
+  }
+  if (result < 0) panic("No result image received", 0);
+
+  double elapsed = (t_stop.tv_sec - t_start.tv_sec) + (t_stop.tv_nsec - t_start.tv_nsec) * 1e-9;
+  printf("  Elapsed time: %.6f seconds (server: %.6f seconds)\n", elapsed, resp.elapsed);
+
+  // Save result
+  char *bfn = output_filename(&args);
+  printf("Saving result (%s)...\n", resp.message);
+  printf("  Saving as %s\n", bfn);
+  memfd_to_file(result, bfn);
+
+  // Cleanup
+  close(result);
+  free(bfn);
+
+  // That's all, folks!
+  return EXIT_SUCCESS;
+}
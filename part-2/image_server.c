@@ -0,0 +1,632 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Image processing server
+///        Long-running process that serves blend and blur requests from image_client over a
+///        Unix domain socket. Connections are multiplexed with poll(), so an idle client does
+///        not hold up the others. Input images given by path are copied into memory once and
+///        kept in an LRU cache; images passed as sealed memfds are mapped directly. Results are
+///        returned in a new memfd, so pixel data is never copied through the socket.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "imlib.h"
+#include "blend.h"
+#include "blur.h"
+#include "image_server.h"
+
+#define NUM_LATENCIES 4096        // number of most recent request latencies kept for statistics
+
+struct Arguments {
+  char *socket;
+  int cache_size;
+};
+
+/// @brief A memory-mapped RAW image
+struct Mapped {
+  void *addr;
+  size_t len;
+  struct Image img;
+};
+
+/// @brief An entry in the input image cache
+struct CacheEntry {
+  char path[MAX_PATH_LEN];
+  dev_t dev;
+  ino_t ino;
+  struct timespec mtime;
+  off_t size;
+  struct Mapped map;
+  unsigned long last_use;
+};
+
+static struct {
+  struct CacheEntry *entry;
+  int size;
+  unsigned long clock;
+  unsigned long hits, misses, evictions;
+} cache;
+
+static struct {
+  unsigned long requests[4];
+  unsigned long errors;
+  double latency[NUM_LATENCIES];  // seconds, ring buffer
+  unsigned long nlatency;
+} stats;
+
+static volatile sig_atomic_t terminate = 0;
+
+
+/// @brief Print program syntax and exit. Does not return.
+///
+/// @param msg optional error/informational message.
+void syntax(char *msg)
+{
+  if (msg) printf("%s\n\n", msg);
+
+  printf("Usage: image_server [-h] [--socket SOCKET] [--cache N]\n"
+         "\n"
+         "Options:\n"
+         "  -h/--help                   Show this help message and exit\n"
+         "  -s/--socket SOCKET          Path of the Unix domain socket (default: %s)\n"
+         "  -c/--cache N                Number of input images to cache (default: 16)\n",
+         SERVER_SOCKET);
+
+  exit(EXIT_FAILURE);
+}
+
+
+/// @brief Parse arguments
+///
+/// @param argc number of command line arguments
+/// @param argv command line arguments
+/// @retval struct Argument parsed command line arguments
+struct Arguments parse_arguments(int argc, char *argv[])
+{
+  struct Arguments args = { .socket = SERVER_SOCKET, .cache_size = 16 };
+
+  for (int i=1; i<argc; i++) {
+    if (!strcmp("--socket", argv[i]) || !strcmp("-s", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--socket'.");
+      args.socket = argv[i];
+    } else
+    if (!strcmp("--cache", argv[i]) || !strcmp("-c", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--cache'.");
+      char *endptr;
+      args.cache_size = strtol(argv[i], &endptr, 0);
+      if ((*endptr != '\0') || (args.cache_size < 1)) syntax("Invalid value after '--cache'.");
+    } else
+    if (!strcmp("--help", argv[i]) || !strcmp("-h", argv[i])) {
+      syntax(NULL);
+    } else {
+      syntax("Unknown option.");
+    }
+  }
+
+  return args;
+}
+
+
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/// @brief Read all @a len bytes of @a fd into @a buf.
+///
+/// @retval 0 on success, 1 if the file is shorter than @a len, -1 on error
+static int read_full(int fd, uint8 *buf, size_t len)
+{
+  size_t pos = 0;
+  while (pos < len) {
+    ssize_t n = pread(fd, buf + pos, len - pos, pos);
+    if ((n < 0) && (errno == EINTR)) continue;
+    if (n < 0) return -1;
+    if (n == 0) return 1;
+    pos += n;
+  }
+  return 0;
+}
+
+/// @brief Map a RAW image read-only and set up an Image struct pointing into the mapping.
+///        Sealed memfds are mapped directly. Files are copied into private memory, so that
+///        later writes to the file or its truncation cannot change the image under the server.
+///
+/// @param fd file descriptor
+/// @param sealed @a fd is a memfd passed by a client; it must be sealed against shrinking and
+///        is mapped shared. Otherwise @a fd is copied.
+/// @param[out] m mapped image
+/// @param[out] err error message (on failure)
+/// @retval 0 on success, -1 on error
+static int map_image(int fd, int sealed, struct Mapped *m, char *err, size_t errlen)
+{
+  struct stat st;
+
+  // The sender keeps the memfd; without a shrink seal it could truncate it while the image is
+  // mapped here, and the server would die of SIGBUS.
+  if (sealed) {
+    int seals = fcntl(fd, F_GET_SEALS);
+    if ((seals < 0) || !(seals & F_SEAL_SHRINK)) {
+      snprintf(err, errlen, "Image memfd must be sealed against shrinking (F_SEAL_SHRINK)");
+      return -1;
+    }
+  }
+
+  if (fstat(fd, &st) < 0) {
+    snprintf(err, errlen, "Cannot stat image: %s", strerror(errno));
+    return -1;
+  }
+  if (st.st_size < RAW_HEADER_SIZE) {
+    snprintf(err, errlen, "Image too small (%ld bytes)", (long)st.st_size);
+    return -1;
+  }
+
+  m->len = st.st_size;
+  if (sealed) {
+    m->addr = mmap(NULL, m->len, PROT_READ, MAP_SHARED, fd, 0);
+  } else {
+    m->addr = mmap(NULL, m->len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  }
+  if (m->addr == MAP_FAILED) {
+    snprintf(err, errlen, "Cannot map image: %s", strerror(errno));
+    m->addr = NULL;
+    return -1;
+  }
+  if (!sealed) {
+    int res = read_full(fd, m->addr, m->len);
+    if (res != 0) {
+      if (res < 0) snprintf(err, errlen, "Cannot read image: %s", strerror(errno));
+      else snprintf(err, errlen, "Truncated RAW image");
+      munmap(m->addr, m->len);
+      m->addr = NULL;
+      return -1;
+    }
+    mprotect(m->addr, m->len, PROT_READ);
+  }
+
+  uint8 *h = m->addr;
+  if (raw_parse_header(h, &m->img) != rlPlain) {
+    snprintf(err, errlen, "Invalid RAW image header");
+    munmap(m->addr, m->len);
+    m->addr = NULL;
+    return -1;
+  }
+  m->img.data = h + RAW_HEADER_SIZE;
+  m->img.stride = 0;
+
+  size_t size = (size_t)m->img.height * m->img.width * m->img.channels;
+  if (RAW_HEADER_SIZE + size > m->len) {
+    snprintf(err, errlen, "Truncated RAW image");
+    munmap(m->addr, m->len);
+    m->addr = NULL;
+    return -1;
+  }
+
+  return 0;
+}
+
+
+/// @brief Look up an image in the cache and load (copy) it on a miss. Entries are revalidated
+///        against the file's inode, size, and modification time on every lookup.
+///
+/// @retval struct Mapped* mapped image, NULL on error
+static struct Mapped *cache_get(char *path, char *err, size_t errlen)
+{
+  struct stat st;
+
+  if (stat(path, &st) < 0) {
+    snprintf(err, errlen, "Cannot open %s: %s", path, strerror(errno));
+    return NULL;
+  }
+
+  cache.clock++;
+  struct CacheEntry *victim = NULL;
+  for (int i=0; i<cache.size; i++) {
+    struct CacheEntry *e = &cache.entry[i];
+    if ((e->map.addr != NULL) && !strcmp(e->path, path)) {
+      if ((e->dev == st.st_dev) && (e->ino == st.st_ino) && (e->size == st.st_size) &&
+          (e->mtime.tv_sec == st.st_mtim.tv_sec) && (e->mtime.tv_nsec == st.st_mtim.tv_nsec)) {
+        e->last_use = cache.clock;
+        cache.hits++;
+        return &e->map;
+      }
+      // stale entry: reuse the slot
+      munmap(e->map.addr, e->map.len);
+      e->map.addr = NULL;
+      victim = e;
+      break;
+    }
+    if ((victim == NULL) || (victim->map.addr && (!e->map.addr || e->last_use < victim->last_use))) {
+      victim = e;
+    }
+  }
+  cache.misses++;
+
+  if (victim->map.addr != NULL) {
+    munmap(victim->map.addr, victim->map.len);
+    victim->map.addr = NULL;
+    cache.evictions++;
+  }
+
+  // Record the state of the file that is actually copied (it may have changed since stat())
+  int fd = open(path, O_RDONLY);
+  if ((fd < 0) || (fstat(fd, &st) < 0)) {
+    snprintf(err, errlen, "Cannot open %s: %s", path, strerror(errno));
+    if (fd >= 0) close(fd);
+    return NULL;
+  }
+  int res = map_image(fd, 0, &victim->map, err, errlen);
+  close(fd);
+  if (res < 0) return NULL;
+
+  snprintf(victim->path, sizeof(victim->path), "%s", path);
+  victim->dev = st.st_dev;
+  victim->ino = st.st_ino;
+  victim->size = st.st_size;
+  victim->mtime = st.st_mtim;
+  victim->last_use = cache.clock;
+
+  return &victim->map;
+}
+
+
+/// @brief Copy an image into a new memfd in RAW format.
+///
+/// @retval int memfd, -1 on error
+static int image_to_memfd(struct Image img)
+{
+  size_t size = (size_t)img.height * img.width * img.channels;
+  int fd = memfd_create("image_server_result", MFD_CLOEXEC);
+  if (fd < 0) return -1;
+
+  if (ftruncate(fd, RAW_HEADER_SIZE + size) < 0) {
+    close(fd);
+    return -1;
+  }
+
+  uint8 *p = mmap(NULL, RAW_HEADER_SIZE + size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (p == MAP_FAILED) {
+    close(fd);
+    return -1;
+  }
+
+  raw_build_header(p, img, rlPlain);
+  memcpy(p + RAW_HEADER_SIZE, img.data, size);
+  munmap(p, RAW_HEADER_SIZE + size);
+
+  return fd;
+}
+
+
+static int compare_double(const void *a, const void *b)
+{
+  double x = *(const double*)a, y = *(const double*)b;
+  return x < y ? -1 : x > y;
+}
+
+/// @brief Format request statistics and latency percentiles into @a buf.
+static void format_stats(char *buf, size_t len)
+{
+  unsigned long n = stats.nlatency < NUM_LATENCIES ? stats.nlatency : NUM_LATENCIES;
+  double p50 = 0.0, p90 = 0.0, p99 = 0.0, max = 0.0;
+
+  if (n > 0) {
+    double *sorted = malloc(n * sizeof(double));
+    if (sorted == NULL) abort();
+    memcpy(sorted, stats.latency, n * sizeof(double));
+    qsort(sorted, n, sizeof(double), compare_double);
+    p50 = sorted[(n-1) * 50 / 100];
+    p90 = sorted[(n-1) * 90 / 100];
+    p99 = sorted[(n-1) * 99 / 100];
+    max = sorted[n-1];
+    free(sorted);
+  }
+
+  snprintf(buf, len,
+           "Requests: %lu blend, %lu blur, %lu errors\n"
+           "Latency (last %lu requests): p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n"
+           "Image cache: %lu hits, %lu misses, %lu evictions (%d entries)\n",
+           stats.requests[soBlend], stats.requests[soBlur], stats.errors,
+           n, p50*1e3, p90*1e3, p99*1e3, max*1e3,
+           cache.hits, cache.misses, cache.evictions, cache.size);
+}
+
+
+/// @brief Receive a request together with any attached file descriptors.
+///
+/// @retval int number of bytes received, 0 on EOF, -1 on error
+static int receive_request(int sock, struct ServerRequest *req, int *fds, int *nfds)
+{
+  char control[CMSG_SPACE(2 * sizeof(int))];
+  struct iovec iov = { req, sizeof(*req) };
+  struct msghdr msg = {
+    .msg_iov = &iov, .msg_iovlen = 1,
+    .msg_control = control, .msg_controllen = sizeof(control)
+  };
+
+  *nfds = 0;
+  int res = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+  if (res <= 0) return res;
+
+  for (struct cmsghdr *c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+    if ((c->cmsg_level == SOL_SOCKET) && (c->cmsg_type == SCM_RIGHTS)) {
+      int n = (c->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+      memcpy(fds + *nfds, CMSG_DATA(c), n * sizeof(int));
+      *nfds += n;
+    }
+  }
+
+  return res;
+}
+
+/// @brief Send a response, optionally with a result memfd attached.
+static void send_response(int sock, struct ServerResponse *resp, int fd)
+{
+  char control[CMSG_SPACE(sizeof(int))];
+  struct iovec iov = { resp, sizeof(*resp) };
+  struct msghdr msg = { .msg_iov = &iov, .msg_iovlen = 1 };
+
+  if (fd >= 0) {
+    memset(control, 0, sizeof(control));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr *c = CMSG_FIRSTHDR(&msg);
+    c->cmsg_level = SOL_SOCKET;
+    c->cmsg_type = SCM_RIGHTS;
+    c->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(c), &fd, sizeof(int));
+  }
+
+  if (sendmsg(sock, &msg, MSG_NOSIGNAL) < 0) perror("Cannot send response");
+}
+
+
+/// @brief Process one request.
+///
+/// @retval int result memfd, -1 if no image is returned
+static int handle_request(struct ServerRequest *req, int *fds, int nfds, struct ServerResponse *resp)
+{
+  struct Mapped fdmap[2];
+  struct Image in[2];
+  int nmapped = 0, nextfd = 0, result = -1;
+  char *err = resp->message;
+  size_t errlen = sizeof(resp->message);
+
+  resp->status = -1;
+
+  if ((req->magic != SERVER_MAGIC) || (req->op < soBlend) || (req->op > soShutdown)) {
+    snprintf(err, errlen, "Invalid request");
+    return -1;
+  }
+  if ((req->op == soStats) || (req->op == soShutdown)) {
+    format_stats(resp->message, sizeof(resp->message));
+    resp->status = 0;
+    return -1;
+  }
+
+  int nimages = req->op == soBlend ? 2 : 1;
+  if (req->nimages != nimages) {
+    snprintf(err, errlen, "Expected %d input image(s)", nimages);
+    return -1;
+  }
+
+  // Resolve input images: cached files or attached memfds
+  for (int i=0; i<nimages; i++) {
+    req->path[i][MAX_PATH_LEN-1] = '\0';
+    if (req->path[i][0] != '\0') {
+      struct Mapped *m = cache_get(req->path[i], err, errlen);
+      if (m == NULL) goto out;
+      in[i] = m->img;
+    } else {
+      if (nextfd >= nfds) {
+        snprintf(err, errlen, "Missing file descriptor for image %d", i+1);
+        goto out;
+      }
+      if (map_image(fds[nextfd++], 1, &fdmap[nmapped], err, errlen) < 0) goto out;
+      in[i] = fdmap[nmapped++].img;
+    }
+  }
+
+  // Check parameters (the kernels abort on invalid input)
+  struct Image out;
+  double t_start = now();
+  if (req->op == soBlend) {
+    if ((in[0].height != in[1].height) || (in[0].width != in[1].width)) {
+      snprintf(err, errlen, "Image dimension mismatch: %dx%d vs %dx%d",
+               in[0].height, in[0].width, in[1].height, in[1].width);
+      goto out;
+    }
+    if ((in[0].channels != 4) || (in[1].channels != 4)) {
+      snprintf(err, errlen, "Missing alpha channel");
+      goto out;
+    }
+    if ((req->alpha < 0.0) || (req->alpha > 1.0)) {
+      snprintf(err, errlen, "Invalid alpha value. Value must be between 0.0 and 1.0.");
+      goto out;
+    }
+    if ((req->mode != 0) && (req->mode != 1)) {
+      snprintf(err, errlen, "Invalid blending mode %d", req->mode);
+      goto out;
+    }
+    if (req->type == 0) out = blend_float(in[0], in[1], req->mode, req->alpha);
+    else out = blend_int(in[0], in[1], req->mode, (int)(req->alpha*255));
+  } else {
+    int k = req->kernel_size;
+    if ((k != 3) && (k != 5) && (k != 7)) {
+      snprintf(err, errlen, "Invalid kernel size %d", k);
+      goto out;
+    }
+    if ((in[0].height < k) || (in[0].width < k)) {
+      snprintf(err, errlen, "Image smaller than kernel");
+      goto out;
+    }
+    if (req->type == 0) out = blur_float(in[0], k);
+    else out = blur_int(in[0], k);
+  }
+  resp->elapsed = now() - t_start;
+
+  result = image_to_memfd(out);
+  free(out.data);
+  if (result < 0) {
+    snprintf(err, errlen, "Cannot create result: %s", strerror(errno));
+    goto out;
+  }
+
+  resp->status = 0;
+  snprintf(resp->message, sizeof(resp->message), "%dx%dx%d", out.height, out.width, out.channels);
+
+out:
+  for (int i=0; i<nmapped; i++) munmap(fdmap[i].addr, fdmap[i].len);
+  return result;
+}
+
+
+/// @brief Receive, process, and answer one request on connection @a sock.
+///
+/// @retval 0 on success, -1 if the connection was closed or the message was invalid
+static int serve_request(int sock)
+{
+  struct ServerRequest req;
+  int fds[8], nfds;
+
+  if (receive_request(sock, &req, fds, &nfds) != sizeof(req)) {
+    // short or failed message: drop the descriptors it may have carried
+    for (int i=0; i<nfds; i++) close(fds[i]);
+    return -1;
+  }
+
+  struct ServerResponse resp;
+  memset(&resp, 0, sizeof(resp));
+
+  double t_start = now();
+  int result = handle_request(&req, fds, nfds, &resp);
+  for (int i=0; i<nfds; i++) close(fds[i]);
+
+  if (resp.status < 0) {
+    stats.errors++;
+  } else if ((req.op == soBlend) || (req.op == soBlur)) {
+    stats.requests[req.op]++;
+    stats.latency[stats.nlatency++ % NUM_LATENCIES] = now() - t_start;
+  }
+
+  send_response(sock, &resp, result);
+  if (result >= 0) close(result);
+
+  if (req.op == soShutdown) terminate = 1;
+  return 0;
+}
+
+
+static void on_signal(int sig)
+{
+  (void)sig;
+  terminate = 1;
+}
+
+
+int main(int argc, char *argv[])
+{
+  struct Arguments args = parse_arguments(argc, argv);
+
+  cache.size = args.cache_size;
+  if ((cache.entry = calloc(cache.size, sizeof(struct CacheEntry))) == NULL) {
+    panic("Failed to allocate image cache", errno);
+  }
+
+  // Set up listening socket
+  struct sockaddr_un addr = { .sun_family = AF_UNIX };
+  if (strlen(args.socket) >= sizeof(addr.sun_path)) panic("Socket path too long", 0);
+  strcpy(addr.sun_path, args.socket);
+
+  int lsock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (lsock < 0) panic("Cannot create socket", errno);
+  unlink(args.socket);
+  if (bind(lsock, (struct sockaddr*)&addr, sizeof(addr)) < 0) panic("Cannot bind socket", errno);
+  if (listen(lsock, 64) < 0) panic("Cannot listen on socket", errno);
+
+  struct sigaction sa = { .sa_handler = on_signal };
+  sigaction(SIGINT, &sa, NULL);
+  sigaction(SIGTERM, &sa, NULL);
+
+  printf("Image server listening on %s (cache: %d images)\n", args.socket, cache.size);
+  fflush(stdout);
+
+  // Serve requests. Each connection may carry any number of requests; requests are handled one
+  // at a time in the order in which poll() reports them.
+  int nclients = 0, maxclients = 16;
+  struct pollfd *pfd = malloc((maxclients + 1) * sizeof(struct pollfd));
+  if (pfd == NULL) panic("Out of memory", errno);
+  pfd[0] = (struct pollfd){ .fd = lsock, .events = POLLIN };
+
+  while (!terminate) {
+    if (poll(pfd, nclients + 1, -1) < 0) {
+      if (errno == EINTR) continue;
+      panic("poll failed", errno);
+    }
+
+    // Serve ready clients; drop closed connections (the last one takes over the slot)
+    for (int i=1; (i<=nclients) && !terminate; i++) {
+      if (pfd[i].revents == 0) continue;
+      if (serve_request(pfd[i].fd) < 0) {
+        close(pfd[i].fd);
+        pfd[i--] = pfd[nclients--];
+      }
+    }
+
+    // Accept a new connection
+    if (!terminate && (pfd[0].revents & POLLIN)) {
+      int sock = accept4(lsock, NULL, NULL, SOCK_CLOEXEC);
+      if (sock < 0) {
+        if ((errno == EINTR) || (errno == ECONNABORTED)) continue;
+        panic("accept failed", errno);
+      }
+      if (nclients == maxclients) {
+        maxclients *= 2;
+        struct pollfd *p = realloc(pfd, (maxclients + 1) * sizeof(struct pollfd));
+        if (p == NULL) panic("Out of memory", errno);
+        pfd = p;
+      }
+      pfd[++nclients] = (struct pollfd){ .fd = sock, .events = POLLIN };
+    }
+  }
+  for (int i=1; i<=nclients; i++) close(pfd[i].fd);
+  free(pfd);
+
+  // Report statistics and clean up
+  char report[1024];
+  format_stats(report, sizeof(report));
+  printf("%s", report);
+
+  close(lsock);
+  unlink(args.socket);
+  for (int i=0; i<cache.size; i++) {
+    if (cache.entry[i].map.addr) munmap(cache.entry[i].map.addr, cache.entry[i].map.len);
+  }
+  free(cache.entry);
+
+  return EXIT_SUCCESS;
+}
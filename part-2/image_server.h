@@ -0,0 +1,47 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Image processing server protocol
+///        Message formats exchanged between image_server and image_client over a Unix domain
+///        socket. Images never travel through the socket: inputs are referenced either by path
+///        (the server caches them) or passed as memfd file descriptors holding a RAW image
+///        (SCM_RIGHTS). The result is returned as a memfd holding a RAW image.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#ifndef __IMAGE_SERVER_H__
+#define __IMAGE_SERVER_H__
+
+#define SERVER_SOCKET   "/tmp/image_server.sock"
+#define SERVER_MAGIC    0x51525343        // 'CSRQ'
+#define MAX_PATH_LEN    256
+
+enum ServerOp { soBlend, soBlur, soStats, soShutdown };
+
+/// @brief Request sent by the client. Input images with an empty path are passed as file
+///        descriptors in the ancillary data of the same message, in order.
+struct ServerRequest {
+  unsigned int magic;             ///< SERVER_MAGIC
+  int op;                         ///< enum ServerOp
+  int type;                       ///< 0: float, 1: int
+  int mode;                       ///< blend: 0: merge, 1: overlay
+  double alpha;                   ///< blend: alpha (0.0 - 1.0)
+  int kernel_size;                ///< blur: 3, 5, or 7
+  int nimages;                    ///< number of input images (blend: 2, blur: 1)
+  char path[2][MAX_PATH_LEN];     ///< input image paths, "" if passed as memfd
+};
+
+/// @brief Response sent by the server. On success, the result image is attached as a memfd.
+struct ServerResponse {
+  int status;                     ///< 0 on success, negative on error
+  double elapsed;                 ///< server-side processing time in seconds
+  char message[1024];             ///< error message or statistics report
+};
+
+#endif // __IMAGE_SERVER_H__
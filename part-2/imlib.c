@@ -35,15 +35,37 @@
 //-------------------------------------------------------------------------------------------------
 
 #include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
 #include "imlib.h"
 
 
 static uint8 MAGIC[4] = { 'C', 'S', 'A', 'P' };
 static uint8 BGR_FORMAT[4] = { 'B', 'G', 'R', '-' };
 static uint8 BGRA_FORMAT[4] = { 'B', 'G', 'R', 'A' };
+static uint8 BGR_Z_FORMAT[4] = { 'B', 'G', 'R', 'z' };
+static uint8 BGRA_Z_FORMAT[4] = { 'B', 'G', 'A', 'z' };
+static uint8 BGR_T_FORMAT[4] = { 'B', 'G', 'R', 't' };
+static uint8 BGRA_T_FORMAT[4] = { 'B', 'G', 'A', 't' };
+
+static const struct {
+  const uint8 *format;
+  int channels;
+  enum RawLayout layout;
+} FORMATS[] = {
+  { BGR_FORMAT,    3, rlPlain },      { BGRA_FORMAT,   4, rlPlain },
+  { BGR_Z_FORMAT,  3, rlCompressed }, { BGRA_Z_FORMAT, 4, rlCompressed },
+  { BGR_T_FORMAT,  3, rlTiled },      { BGRA_T_FORMAT, 4, rlTiled },
+};
 
 
 void panic(char *message, int errorno)
@@ -60,68 +82,542 @@ void panic(char *message, int errorno)
 }
 
 
-struct Image read_raw_image(char *filename)
+static void put32(uint8 *p, uint32_t v)
 {
-  FILE *f;
-  struct Image img = { NULL, -1, -1, -1 };
+  for (int i=0; i<4; i++) p[i] = v >> (8*i);
+}
 
-  // Open file
-  if ((f = fopen(filename, "rb")) == NULL) panic("Cannot open file", errno);
+static uint32_t get32(const uint8 *p)
+{
+  return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
 
-  // Read magic number
-  uint8 magic[4];
-  if (fread(&magic, sizeof(magic), 1, f) < 1) panic("Cannot read magic", errno);
-  if (*(int*)magic != *(int*)MAGIC) {
-    char msg[64];
-    snprintf(msg, sizeof(msg), "Invalid magic number: %08x (expected %08x).\n", 
-             *(int*)magic, *(int*)MAGIC);
-    panic(msg, 0);
+
+int raw_parse_header(const uint8 *h, struct Image *img)
+{
+  if (memcmp(h, MAGIC, sizeof(MAGIC))) return -1;
+
+  for (size_t i=0; i<sizeof(FORMATS)/sizeof(FORMATS[0]); i++) {
+    if (memcmp(h+4, FORMATS[i].format, 4)) continue;
+
+    int height = get32(h+8), width = get32(h+12);
+    if ((height < 0) || (width < 0)) return -1;
+
+    img->height = height;
+    img->width = width;
+    img->channels = FORMATS[i].channels;
+    return FORMATS[i].layout;
   }
 
-  // Read data format
-  uint8 format[4];
-  if (fread(&format, sizeof(format), 1, f) < 1) panic("Cannot read image format", errno);
-  if (*(int*)format == *(int*)BGR_FORMAT) {
-    img.channels = 3;
-  } else if (*(int*)format == *(int*)BGRA_FORMAT) {
-    img.channels = 4;
+  return -1;
+}
+
+
+void raw_build_header(uint8 *h, struct Image img, enum RawLayout layout)
+{
+  memcpy(h, MAGIC, sizeof(MAGIC));
+  for (size_t i=0; i<sizeof(FORMATS)/sizeof(FORMATS[0]); i++) {
+    if ((FORMATS[i].channels == img.channels) && (FORMATS[i].layout == layout)) {
+      memcpy(h+4, FORMATS[i].format, 4);
+    }
+  }
+  put32(h+8, img.height);
+  put32(h+12, img.width);
+}
+
+
+/// @brief Abort with a description of what is wrong with the RAW header @a h.
+static void header_panic(const uint8 *h)
+{
+  char msg[64];
+
+  if (memcmp(h, MAGIC, sizeof(MAGIC))) {
+    snprintf(msg, sizeof(msg), "Invalid magic number: %08x (expected %08x).\n",
+             get32(h), get32(MAGIC));
+  } else if (((int)get32(h+8) < 0) || ((int)get32(h+12) < 0)) {
+    snprintf(msg, sizeof(msg), "Invalid image dimensions.");
   } else {
-    char msg[64];
-    snprintf(msg, sizeof(msg), "Invalid data format: %08x.\n", *(int*)format);
+    snprintf(msg, sizeof(msg), "Invalid data format: %08x.\n", get32(h+4));
+  }
+  panic(msg, 0);
+}
+
+
+struct Image image_view(struct Image img, int y, int x, int height, int width)
+{
+  if ((y < 0) || (x < 0) || (height < 0) || (width < 0) ||
+      (y + height > img.height) || (x + width > img.width)) {
+    char msg[128];
+    snprintf(msg, sizeof(msg), "View %dx%d at (%d,%d) exceeds image dimensions %dx%d.",
+             height, width, y, x, img.height, img.width);
     panic(msg, 0);
   }
 
-  // Read height and width
-  uint8 h[4], w[4];
-  if (fread(h, sizeof(h), 1, f) < 1) panic("Cannot read image height", errno);
-  if (fread(w, sizeof(w), 1, f) < 1) panic("Cannot read image width", errno);
-  img.height = h[3] << 24 | h[2] << 16 | h[1] << 8 | h[0];
-  img.width  = w[3] << 24 | w[2] << 16 | w[1] << 8 | w[0];
+  struct Image view = {
+    .data     = &PIXEL(img, y, x, 0),
+    .height   = height,
+    .width    = width,
+    .channels = img.channels,
+    .stride   = STRIDE(img)
+  };
 
-  // Allocate memory for image data
-  int img_size = img.height * img.width * img.channels;
-  if ((img.data = malloc(sizeof(uint8)*img_size)) == NULL) {
+  return view;
+}
+
+
+void bgr_to_bgra(uint8 *dst, const uint8 *src, int n, uint8 alpha)
+{
+  int i = 0;
+
+#ifdef __SSSE3__
+  // 48 input bytes = 16 pixels; each shuffle expands 12 bytes (4 pixels) to 16
+  const __m128i expand = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i a = _mm_set1_epi32((unsigned)alpha << 24);
+
+  for (; i+16 <= n; i+=16) {
+    __m128i s0 = _mm_loadu_si128((const __m128i*)(src + 3*i));
+    __m128i s1 = _mm_loadu_si128((const __m128i*)(src + 3*i + 16));
+    __m128i s2 = _mm_loadu_si128((const __m128i*)(src + 3*i + 32));
+    __m128i *d = (__m128i*)(dst + 4*i);
+    _mm_storeu_si128(d,   _mm_or_si128(_mm_shuffle_epi8(s0, expand), a));
+    _mm_storeu_si128(d+1, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(s1, s0, 12), expand), a));
+    _mm_storeu_si128(d+2, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(s2, s1, 8), expand), a));
+    _mm_storeu_si128(d+3, _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(s2, 4), expand), a));
+  }
+#endif
+
+  for (; i<n; i++) {
+    dst[4*i]   = src[3*i];
+    dst[4*i+1] = src[3*i+1];
+    dst[4*i+2] = src[3*i+2];
+    dst[4*i+3] = alpha;
+  }
+}
+
+
+void bgra_to_bgr(uint8 *dst, const uint8 *src, int n)
+{
+  int i = 0;
+
+#ifdef __SSSE3__
+  // each shuffle packs 4 pixels into the low 12 bytes; the four results are merged into 48 bytes
+  const __m128i pack = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+  for (; i+16 <= n; i+=16) {
+    const __m128i *s = (const __m128i*)(src + 4*i);
+    __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128(s),   pack);
+    __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128(s+1), pack);
+    __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128(s+2), pack);
+    __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128(s+3), pack);
+    __m128i *d = (__m128i*)(dst + 3*i);
+    _mm_storeu_si128(d,   _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+    _mm_storeu_si128(d+1, _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+    _mm_storeu_si128(d+2, _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+  }
+#endif
+
+  for (; i<n; i++) {
+    dst[3*i]   = src[4*i];
+    dst[3*i+1] = src[4*i+1];
+    dst[3*i+2] = src[4*i+2];
+  }
+}
+
+
+struct Image image_convert(struct Image img, int channels)
+{
+  if ((img.channels < 3) || (img.channels > 4) || (channels < 3) || (channels > 4)) {
+    panic("Invalid channel conversion.", 0);
+  }
+
+  struct Image conv = { .height = img.height, .width = img.width, .channels = channels };
+  if ((conv.data = malloc((size_t)img.height * img.width * channels)) == NULL) {
     panic("Failed to allocate memory for image", errno);
   }
 
+  for (int y=0; y<img.height; y++) {
+    uint8 *d = &PIXEL(conv, y, 0, 0);
+    uint8 *s = &PIXEL(img, y, 0, 0);
+    if (img.channels == channels) memcpy(d, s, (size_t)img.width * channels);
+    else if (channels == 4) bgr_to_bgra(d, s, img.width, 0xff);
+    else bgra_to_bgr(d, s, img.width);
+  }
+
+  return conv;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Compressed RAW format
+//
+// A row is stored channel by channel. The bytes of a channel are the differences to the left
+// neighbor (modulo 256; the first pixel is stored as is), encoded as a sequence of packets:
+//   n < 128:  n+1 literal bytes follow
+//   n >= 128: the following byte repeats n-125 times (3 - 130)
+//
+
+#define RUN_MIN     3
+#define RUN_MAX   130
+#define LIT_MAX   128
+
+/// @brief Run-length encode the @a n bytes at @a src into @a dst; return the encoded size.
+static size_t rle_encode(uint8 *dst, const uint8 *src, int n)
+{
+  uint8 *d = dst;
+  int lit = 0;                    // start of the pending literals
+
+  for (int i=0; i<n; ) {
+    int r = 1;
+    while ((i+r < n) && (r < RUN_MAX) && (src[i+r] == src[i])) r++;
+
+    if ((r >= RUN_MIN) || (i+r == n)) {
+      // flush literals before the run (or the end)
+      int end = r >= RUN_MIN ? i : n;
+      while (lit < end) {
+        int len = end - lit < LIT_MAX ? end - lit : LIT_MAX;
+        *d++ = len - 1;
+        memcpy(d, src + lit, len);
+        d += len;
+        lit += len;
+      }
+      if (r >= RUN_MIN) {
+        *d++ = r + 125;
+        *d++ = src[i];
+        lit = i + r;
+      }
+      i += r;
+    } else {
+      i += r;
+    }
+  }
+
+  return d - dst;
+}
+
+/// @brief Decode run-length encoded data at @a src (at most @a size bytes) until @a n bytes are
+///        produced in @a dst. Return the number of bytes consumed or -1 if the data is corrupt.
+static long rle_decode(uint8 *dst, int n, const uint8 *src, size_t size)
+{
+  size_t p = 0;
+
+  for (int i=0; i<n; ) {
+    if (p >= size) return -1;
+    int c = src[p++];
+    if (c < 128) {
+      int len = c + 1;
+      if ((i + len > n) || (p + len > size)) return -1;
+      memcpy(dst + i, src + p, len);
+      p += len;
+      i += len;
+    } else {
+      int len = c - 125;
+      if ((i + len > n) || (p >= size)) return -1;
+      memset(dst + i, src[p++], len);
+      i += len;
+    }
+  }
+
+  return p;
+}
+
+
+size_t raw_compress_block(uint8 *dst, struct Image img, int y, int rows)
+{
+  int ch = img.channels;
+  uint8 *delta = malloc(img.width ? img.width : 1);
+  if (delta == NULL) panic("Failed to allocate memory for compression", errno);
+
+  size_t size = 0;
+  for (int r=y; r<y+rows; r++) {
+    const uint8 *p = &PIXEL(img, r, 0, 0);
+    for (int c=0; c<ch; c++) {
+      uint8 prev = 0;
+      for (int x=0; x<img.width; x++) {
+        delta[x] = p[ch*x + c] - prev;
+        prev = p[ch*x + c];
+      }
+      size += rle_encode(dst + size, delta, img.width);
+    }
+  }
+
+  free(delta);
+  return size;
+}
+
+
+int raw_decompress_block(struct Image img, int y, int rows, const uint8 *src, size_t size)
+{
+  int ch = img.channels;
+  uint8 *delta = malloc(img.width ? img.width : 1);
+  if (delta == NULL) return -1;
+
+  size_t pos = 0;
+  for (int r=y; r<y+rows; r++) {
+    uint8 *p = &PIXEL(img, r, 0, 0);
+    for (int c=0; c<ch; c++) {
+      long used = rle_decode(delta, img.width, src + pos, size - pos);
+      if (used < 0) {
+        free(delta);
+        return -1;
+      }
+      pos += used;
+
+      uint8 prev = 0;
+      for (int x=0; x<img.width; x++) {
+        prev += delta[x];
+        p[ch*x + c] = prev;
+      }
+    }
+  }
+
+  free(delta);
+  return pos == size ? 0 : -1;
+}
+
+
+/// @brief Block-parallel decoding job of decompress().
+struct DecodeJob {
+  struct Image img;
+  const uint8 *data;              // compressed blocks
+  const size_t *offset;           // offset of block i in data; offset[nblocks] = end
+  int block_rows, nblocks;
+  int first, step;                // blocks first, first+step, ...
+  int status;
+};
+
+/// @brief Decode the blocks of @a arg (struct DecodeJob).
+static void *decode_blocks(void *arg)
+{
+  struct DecodeJob *j = arg;
+
+  for (int b=j->first; b<j->nblocks; b+=j->step) {
+    int y = b * j->block_rows;
+    int rows = j->img.height - y < j->block_rows ? j->img.height - y : j->block_rows;
+    if (raw_decompress_block(j->img, y, rows, j->data + j->offset[b],
+                             j->offset[b+1] - j->offset[b]) < 0) j->status = -1;
+  }
+
+  return NULL;
+}
+
+/// @brief Decode the block table and the blocks at @a src (@a size bytes following the header
+///        of a compressed image) into @a img with @a nthreads threads. Return 0 on success or -1
+///        if the data is corrupt.
+static int decompress(struct Image img, const uint8 *src, size_t size, int nthreads)
+{
+  if (size < 8) return -1;
+  uint32_t block_rows = get32(src), nblocks = get32(src+4);
+  if ((block_rows == 0) || (nblocks != (img.height + block_rows - 1) / block_rows) ||
+      ((size - 8) / 4 < nblocks)) return -1;
+
+  const uint8 *table = src + 8, *data = table + 4 * (size_t)nblocks;
+  size_t *offset = malloc((nblocks + 1) * sizeof(size_t));
+  if (offset == NULL) panic("Failed to allocate memory for image", errno);
+  offset[0] = 0;
+  for (uint32_t i=0; i<nblocks; i++) offset[i+1] = offset[i] + get32(table + 4*i);
+  if (offset[nblocks] > size - (data - src)) {
+    free(offset);
+    return -1;
+  }
+
+  if (nthreads > (int)nblocks) nthreads = nblocks;
+  if (nthreads < 1) nthreads = 1;
+
+  pthread_t tid[nthreads];
+  struct DecodeJob job[nthreads];
+  for (int t=0; t<nthreads; t++) {
+    job[t] = (struct DecodeJob){
+      .img = img, .data = data, .offset = offset, .block_rows = block_rows,
+      .nblocks = nblocks, .first = t, .step = nthreads, .status = 0
+    };
+  }
+  if (nthreads == 1) {
+    decode_blocks(&job[0]);
+  } else {
+    for (int t=0; t<nthreads; t++) {
+      if (pthread_create(&tid[t], NULL, decode_blocks, &job[t])) {
+        panic("Cannot create thread", 0);
+      }
+    }
+    for (int t=0; t<nthreads; t++) pthread_join(tid[t], NULL);
+  }
+
+  int status = 0;
+  for (int t=0; t<nthreads; t++) status |= job[t].status;
+
+  free(offset);
+  return status;
+}
+
+/// @brief Read the block table and the blocks of a compressed image from @a f (positioned after
+///        the header) and decode them into @a img.
+static void read_compressed(FILE *f, struct Image img)
+{
+  struct stat st;
+  long pos = ftell(f);
+  if ((pos < 0) || fstat(fileno(f), &st)) panic("Cannot read block table", errno);
+  if (st.st_size < pos) panic("Invalid block table.", 0);
+
+  size_t size = st.st_size - pos;
+  uint8 *data = malloc(size ? size : 1);
+  if (data == NULL) panic("Failed to allocate memory for image", errno);
+  if (fread(data, sizeof(uint8), size, f) < size) panic("Cannot read image data", errno);
+
+  if (decompress(img, data, size, 1) < 0) panic("Corrupt image data.", 0);
+
+  free(data);
+}
+
+
+int raw_decompress(struct Image img, const uint8 *file, size_t size, int nthreads)
+{
+  struct Image hdr;
+  if ((size < RAW_HEADER_SIZE) || (raw_parse_header(file, &hdr) != rlCompressed)) return -1;
+  if ((hdr.height != img.height) || (hdr.width != img.width) || (hdr.channels != img.channels)) {
+    return -1;
+  }
+
+  return decompress(img, file + RAW_HEADER_SIZE, size - RAW_HEADER_SIZE, nthreads);
+}
+
+
+struct Image read_raw_image(char *filename)
+{
+  struct Image img = { NULL, -1, -1, -1, 0 };
+
+  read_raw_image_reuse(filename, &img);
+
+  return img;
+}
+
+
+void read_raw_image_reuse(char *filename, struct Image *img)
+{
+  FILE *f;
+
+  // Open file
+  if ((f = fopen(filename, "rb")) == NULL) panic("Cannot open file", errno);
+
+  // Read header
+  uint8 hdr[RAW_HEADER_SIZE];
+  if (fread(hdr, sizeof(hdr), 1, f) < 1) panic("Cannot read image header", errno);
+  int layout = raw_parse_header(hdr, img);
+  if (layout < 0) header_panic(hdr);
+  img->stride = 0;
+
+  // Allocate memory for image data (or resize the previous buffer)
+  int img_size = img->height * img->width * img->channels;
+  uint8 *data = realloc(img->data, sizeof(uint8)*(img_size ? img_size : 1));
+  if (data == NULL) panic("Failed to allocate memory for image", errno);
+  img->data = data;
+
   // Read pixel data
-  if (fread(img.data, sizeof(uint8), img_size, f) < img_size) {
+  if (layout == rlTiled) {
+    // tiled: read all tiles through the region reader
+    struct TiledImage *t = tiled_open(filename);
+    tiled_read_into(*img, t, 0, 0);
+    tiled_close(t);
+  } else if (layout == rlCompressed) {
+    read_compressed(f, *img);
+  } else if (fread(img->data, sizeof(uint8), img_size, f) < img_size) {
     panic("Cannot read image data", errno);
   }
 
+  // Clean up
+  fclose(f);
+}
+
+
+void write_raw_image(char* filename, struct Image img)
+{
+  FILE *f;
+
+  // Run a few checks
+  if (img.data == NULL) panic("No image data.", 0);
+
+  // Only 3 and 4 channels are supported
+  if ((img.channels < 3) || (4 < img.channels)) panic("Invalid data format.", 0);
+
+  // Write data to file
+  if ((f = fopen(filename, "wb")) == NULL) panic("Cannot open file", errno);
+
+  // Write header (magic number and data format, height and width in little endian)
+  uint8 hdr[RAW_HEADER_SIZE];
+  raw_build_header(hdr, img, rlPlain);
+  if (fwrite(hdr, sizeof(hdr), 1, f) < 1) panic("Cannot write image header", errno);
+
+  // Write pixel data (row by row for views)
+  int row_size = img.width * img.channels;
+  if (STRIDE(img) == row_size) {
+    int img_size = img.height * row_size;
+    if (fwrite(img.data, sizeof(uint8), img_size, f) < img_size) {
+      panic("Cannot write image data", errno);
+    }
+  } else {
+    for (int y=0; y<img.height; y++) {
+      if (fwrite(&PIXEL(img, y, 0, 0), sizeof(uint8), row_size, f) < row_size) {
+        panic("Cannot write image data", errno);
+      }
+    }
+  }
+
   // Clean up and return
   fclose(f);
+}
 
-  return img;
+
+void write_raw_image_compressed(char *filename, struct Image img)
+{
+  FILE *f;
+
+  // Run a few checks
+  if (img.data == NULL) panic("No image data.", 0);
+
+  // Only 3 and 4 channels are supported
+  if ((img.channels < 3) || (4 < img.channels)) panic("Invalid data format.", 0);
+
+  // Write data to file
+  if ((f = fopen(filename, "wb")) == NULL) panic("Cannot open file", errno);
+
+  // Header, block table with the sizes still unknown
+  uint32_t nblocks = (img.height + RAW_BLOCK_ROWS - 1) / RAW_BLOCK_ROWS;
+  size_t table_size = 8 + 4 * (size_t)nblocks;
+  uint8 hdr[RAW_HEADER_SIZE];
+  raw_build_header(hdr, img, rlCompressed);
+  uint8 *table = calloc(table_size, 1);
+  if (table == NULL) panic("Failed to allocate memory for compression", errno);
+  put32(table, RAW_BLOCK_ROWS);
+  put32(table+4, nblocks);
+  if (fwrite(hdr, sizeof(hdr), 1, f) < 1) panic("Cannot write image header", errno);
+  if (fwrite(table, table_size, 1, f) < 1) panic("Cannot write block table", errno);
+
+  // Compress and write the blocks, then fill in their sizes
+  uint8 *block = malloc(RAW_BLOCK_BOUND(img, RAW_BLOCK_ROWS) + 1);
+  if (block == NULL) panic("Failed to allocate memory for compression", errno);
+  for (uint32_t i=0; i<nblocks; i++) {
+    int y = i * RAW_BLOCK_ROWS;
+    int rows = img.height - y < RAW_BLOCK_ROWS ? img.height - y : RAW_BLOCK_ROWS;
+    size_t size = raw_compress_block(block, img, y, rows);
+    if (fwrite(block, sizeof(uint8), size, f) < size) panic("Cannot write image data", errno);
+    put32(table + 8 + 4*i, size);
+  }
+  if (fseek(f, sizeof(hdr), SEEK_SET) ||
+      (fwrite(table, table_size, 1, f) < 1)) panic("Cannot write block table", errno);
+
+  // Clean up
+  free(block);
+  free(table);
+  fclose(f);
 }
 
 
-void write_raw_image(char* filename, struct Image img)
+void write_raw_image_tiled(char *filename, struct Image img, int tile_size)
 {
   FILE *f;
 
   // Run a few checks
   if (img.data == NULL) panic("No image data.", 0);
+  if (tile_size < 1) panic("Invalid tile size.", 0);
 
   // Only 3 and 4 channels are supported
   if ((img.channels < 3) || (4 < img.channels)) panic("Invalid data format.", 0);
@@ -129,25 +625,204 @@ void write_raw_image(char* filename, struct Image img)
   // Write data to file
   if ((f = fopen(filename, "wb")) == NULL) panic("Cannot open file", errno);
 
-  // Write magic number and data format (big endian)
-  if (fwrite(MAGIC, sizeof(MAGIC), 1, f) < 1) panic("Cannot write magic to file", errno);
-  uint8 *format = (img.channels == 3 ? BGR_FORMAT : BGRA_FORMAT);
-  if (fwrite(format, sizeof(BGR_FORMAT), 1, f) < 1) panic("Cannot write format to file", errno);
+  // Header and tile table. Tiles are stored in row-major order right after the table.
+  int ch = img.channels;
+  int tiles_y = (img.height + tile_size - 1) / tile_size;
+  int tiles_x = (img.width + tile_size - 1) / tile_size;
+  size_t table_size = 8 + 8 * (size_t)tiles_y * tiles_x;
+  uint8 hdr[RAW_HEADER_SIZE];
+  raw_build_header(hdr, img, rlTiled);
+  uint8 *table = malloc(table_size);
+  if (table == NULL) panic("Failed to allocate memory for tile table", errno);
+  put32(table, tile_size);
+  put32(table+4, tile_size);
 
-  // Write height and width (little endian)
-  uint8 h[4] = {img.height, img.height>>8, img.height>>16, img.height>>24};
-  uint8 w[4] = {img.width,  img.width >>8, img.width >>16, img.width >>24};
-  if (fwrite(h, sizeof(h), 1, f) < 1) panic("Cannot write image height", errno);
-  if (fwrite(w, sizeof(w), 1, f) < 1) panic("Cannot write image width", errno);
+  uint64_t offset = sizeof(hdr) + table_size;
+  for (int ty=0; ty<tiles_y; ty++) {
+    int rows = img.height - ty*tile_size < tile_size ? img.height - ty*tile_size : tile_size;
+    for (int tx=0; tx<tiles_x; tx++) {
+      int cols = img.width - tx*tile_size < tile_size ? img.width - tx*tile_size : tile_size;
+      uint8 *p = table + 8 + 8 * ((size_t)ty*tiles_x + tx);
+      put32(p, offset);
+      put32(p+4, offset >> 32);
+      offset += (uint64_t)rows * cols * ch;
+    }
+  }
+  if (fwrite(hdr, sizeof(hdr), 1, f) < 1) panic("Cannot write image header", errno);
+  if (fwrite(table, table_size, 1, f) < 1) panic("Cannot write tile table", errno);
 
-  // Write pixel data
-  int img_size = img.height * img.width * img.channels;
-  if (fwrite(img.data, sizeof(uint8), img_size, f) < img_size) {
-    panic("Cannot write image data", errno);
+  // Tiles
+  for (int ty=0; ty<tiles_y; ty++) {
+    int rows = img.height - ty*tile_size < tile_size ? img.height - ty*tile_size : tile_size;
+    for (int tx=0; tx<tiles_x; tx++) {
+      int cols = img.width - tx*tile_size < tile_size ? img.width - tx*tile_size : tile_size;
+      for (int r=0; r<rows; r++) {
+        uint8 *row = &PIXEL(img, ty*tile_size + r, tx*tile_size, 0);
+        if (fwrite(row, sizeof(uint8), cols*ch, f) < cols*ch) {
+          panic("Cannot write image data", errno);
+        }
+      }
+    }
   }
 
-  // Clean up and return
+  // Clean up
+  free(table);
   fclose(f);
 }
 
 
+/// @brief Read exactly @a len bytes at @a offset of @a fd into @a buf; abort on errors.
+static void pread_full(int fd, void *buf, size_t len, long long offset)
+{
+  while (len > 0) {
+    ssize_t n = pread(fd, buf, len, offset);
+    if (n < 0) panic("Cannot read image data", errno);
+    if (n == 0) panic("Unexpected end of image data.", 0);
+    buf = (uint8*)buf + n;
+    len -= n;
+    offset += n;
+  }
+}
+
+
+struct TiledImage *tiled_open(char *filename)
+{
+  struct TiledImage *img = calloc(1, sizeof(struct TiledImage));
+  if (img == NULL) panic("Out of memory", errno);
+
+  if ((img->fd = open(filename, O_RDONLY)) < 0) panic("Cannot open file", errno);
+
+  // Header
+  uint8 h[RAW_HEADER_SIZE];
+  pread_full(img->fd, h, sizeof(h), 0);
+  struct Image dim;
+  int layout = raw_parse_header(h, &dim);
+  if (layout < 0) header_panic(h);
+  if (layout == rlCompressed) panic("Compressed RAW images do not support region reads.", 0);
+  int tiled = layout == rlTiled;
+  img->height = dim.height;
+  img->width = dim.width;
+  img->channels = dim.channels;
+
+  // Tile table. Uncompressed files consist of one tile per row.
+  long long n;
+  if (tiled) {
+    uint8 t[8];
+    pread_full(img->fd, t, sizeof(t), sizeof(h));
+    img->tile_height = get32(t);
+    img->tile_width = get32(t+4);
+    if ((img->tile_height <= 0) || (img->tile_width <= 0)) panic("Invalid tile table.", 0);
+  } else {
+    img->tile_height = 1;
+    img->tile_width = img->width > 0 ? img->width : 1;
+  }
+  img->tiles_y = (img->height + img->tile_height - 1) / img->tile_height;
+  img->tiles_x = (img->width + img->tile_width - 1) / img->tile_width;
+  n = (long long)img->tiles_y * img->tiles_x;
+
+  if ((img->offset = malloc((n ? n : 1) * sizeof(long long))) == NULL) {
+    panic("Failed to allocate memory for tile table", errno);
+  }
+  if (tiled) {
+    uint8 *table = malloc(n ? 8*n : 1);
+    if (table == NULL) panic("Failed to allocate memory for tile table", errno);
+    pread_full(img->fd, table, 8*n, sizeof(h) + 8);
+    for (long long i=0; i<n; i++) {
+      img->offset[i] = get32(table + 8*i) | (long long)get32(table + 8*i + 4) << 32;
+    }
+    free(table);
+  } else {
+    for (long long i=0; i<n; i++) {
+      img->offset[i] = sizeof(h) + i * img->width * img->channels;
+    }
+  }
+
+  // All tiles must be inside the file
+  struct stat st;
+  if (fstat(img->fd, &st) < 0) panic("Cannot stat file", errno);
+  for (int ty=0; ty<img->tiles_y; ty++) {
+    for (int tx=0; tx<img->tiles_x; tx++) {
+      int rows = img->height - ty*img->tile_height;
+      int cols = img->width - tx*img->tile_width;
+      if (rows > img->tile_height) rows = img->tile_height;
+      if (cols > img->tile_width) cols = img->tile_width;
+      long long off = img->offset[(long long)ty*img->tiles_x + tx];
+      if ((off < 0) || (off + (long long)rows * cols * img->channels > st.st_size)) {
+        panic("Invalid tile table.", 0);
+      }
+    }
+  }
+
+  return img;
+}
+
+
+void tiled_close(struct TiledImage *img)
+{
+  if (img == NULL) return;
+
+  close(img->fd);
+  free(img->offset);
+  free(img);
+}
+
+
+void tiled_read_into(struct Image dst, struct TiledImage *img, int y, int x)
+{
+  if (dst.channels != img->channels) panic("Channel mismatch in region read.", 0);
+  if ((y < 0) || (x < 0) || (dst.height < 0) || (dst.width < 0) ||
+      (y + dst.height > img->height) || (x + dst.width > img->width)) {
+    panic("Region is not inside the image.", 0);
+  }
+  if ((dst.height == 0) || (dst.width == 0)) return;
+
+  int ch = img->channels, th = img->tile_height, tw = img->tile_width;
+  uint8 *buf = NULL;
+
+  for (int ty=y/th; ty<=(y + dst.height - 1)/th; ty++) {
+    int ty0 = ty*th;
+    int r0 = (y > ty0 ? y : ty0) - ty0;
+    int r1 = (y + dst.height < ty0 + th ? y + dst.height : ty0 + th) - ty0;
+
+    for (int tx=x/tw; tx<=(x + dst.width - 1)/tw; tx++) {
+      int tx0 = tx*tw;
+      int cols = img->width - tx0 < tw ? img->width - tx0 : tw;
+      int c0 = (x > tx0 ? x : tx0) - tx0;
+      int c1 = (x + dst.width < tx0 + cols ? x + dst.width : tx0 + cols) - tx0;
+      long long off = img->offset[(long long)ty*img->tiles_x + tx];
+      size_t row_size = (size_t)cols * ch, len = (size_t)(c1 - c0) * ch;
+
+      if ((c1 - c0 == cols) || (row_size <= 4096)) {
+        // whole tile rows: one read of the covered rows, then copy the covered columns
+        if ((buf == NULL) && ((buf = malloc((size_t)th * tw * ch)) == NULL)) {
+          panic("Failed to allocate memory for region read", errno);
+        }
+        pread_full(img->fd, buf, (r1 - r0) * row_size, off + r0 * row_size);
+        for (int r=r0; r<r1; r++) {
+          memcpy(&PIXEL(dst, ty0 + r - y, tx0 + c0 - x, 0), buf + (r - r0)*row_size + c0*ch, len);
+        }
+      } else {
+        // wide tiles: read only the covered part of each row
+        for (int r=r0; r<r1; r++) {
+          pread_full(img->fd, &PIXEL(dst, ty0 + r - y, tx0 + c0 - x, 0), len,
+                     off + r*row_size + c0*ch);
+        }
+      }
+    }
+  }
+
+  free(buf);
+}
+
+
+struct Image tiled_read(struct TiledImage *img, int y, int x, int height, int width)
+{
+  struct Image out = { .height = height, .width = width, .channels = img->channels };
+  size_t size = (size_t)height * width * img->channels;
+  if ((out.data = malloc(size ? size : 1)) == NULL) {
+    panic("Failed to allocate memory for image", errno);
+  }
+  tiled_read_into(out, img, y, x);
+
+  return out;
+}
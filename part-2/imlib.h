@@ -36,6 +36,16 @@
 #ifndef __IMLIB_H__
 #define __IMLIB_H__
 
+#include <stddef.h>
+
+/// @brief Number of bytes between the starts of two consecutive rows of an image. Images with
+///        stride 0 are densely packed (stride = width * channels); views into a larger image
+///        (see image_view()) have the stride of their parent.
+///
+/// @param img Image struct
+/// @retval int row stride in bytes
+#define STRIDE(img) ((img).stride ? (img).stride : (img).width * (img).channels)
+
 /// @brief Compute the offset of a specific pixel in an image. No range checks.
 ///
 /// @param img Image struct
@@ -43,7 +53,7 @@
 /// @param x   x coordinate of pixel
 /// @param c   channel number
 /// @retval int offset of pixel in image data
-#define INDEX(img, y, x, c) ((y) * img.width + (x)) * img.channels + (c)
+#define INDEX(img, y, x, c) ((y) * STRIDE(img) + (x) * img.channels + (c))
 
 /// @brief Access (read/write) a specific pixel in an image. No range checks.
 ///        Similar to img[y][x][c] in Python.
@@ -70,9 +80,83 @@ struct Image {
     int height;
     int width;
     int channels;
+    int stride;                   ///< bytes per row; 0 for densely packed images
 };
 
-/// @brief Reads a RAW image file and returns its pixel data, height, width, and number of 
+/// @brief Print an error message (and the description of @a errorno, if non-zero) to stderr and
+///        terminate the program. Does not return.
+///
+/// @param message error message
+/// @param errorno errno value or 0
+void panic(char *message, int errorno);
+
+
+/// @brief Return a view of the rectangle (@a y, @a x) - (@a y + @a height, @a x + @a width) of
+///        @a img. The view shares the pixel data of @a img; nothing is copied and the view must
+///        not be freed. The function aborts if the rectangle is not inside @a img.
+///
+/// @param img parent image (may itself be a view)
+/// @param y   y coordinate of the top-left corner of the view
+/// @param x   x coordinate of the top-left corner of the view
+/// @param height height of the view
+/// @param width  width of the view
+/// @retval struct Image view
+struct Image image_view(struct Image img, int y, int x, int height, int width);
+
+
+/// @brief Expand @a n BGR pixels to BGRA with the constant alpha value @a alpha. With SSSE3, 16
+///        pixels are converted per step with byte shuffles.
+///
+/// @param dst output (4 * @a n bytes). Must not overlap @a src.
+/// @param src input (3 * @a n bytes)
+/// @param n number of pixels
+/// @param alpha alpha value of all output pixels
+void bgr_to_bgra(uint8 *dst, const uint8 *src, int n, uint8 alpha);
+
+
+/// @brief Drop the alpha channel of @a n BGRA pixels. With SSSE3, 16 pixels are converted per
+///        step with byte shuffles.
+///
+/// @param dst output (3 * @a n bytes). Must not overlap @a src.
+/// @param src input (4 * @a n bytes)
+/// @param n number of pixels
+void bgra_to_bgr(uint8 *dst, const uint8 *src, int n);
+
+
+/// @brief Convert @a img to @a channels channels (3: BGR, 4: BGRA) and return the converted
+///        image. Expanded BGR pixels are opaque (alpha = 255). The function aborts in case of any
+///        error.
+///
+/// @param img image with 3 or 4 channels. May be a view.
+/// @param channels number of channels of the result (3 or 4)
+/// @retval struct Image converted image (a copy if @a img already has @a channels channels)
+struct Image image_convert(struct Image img, int channels);
+
+
+#define RAW_HEADER_SIZE 16        ///< RAW file header: magic, data format, height, width
+
+/// @brief Layout of the pixel data that follows the header of a RAW file.
+enum RawLayout { rlPlain, rlCompressed, rlTiled };
+
+/// @brief Parse the RAW file header at @a h. The height, width, and number of channels are
+///        stored in @a img; the other fields are not modified.
+///
+/// @param h RAW_HEADER_SIZE bytes
+/// @param[out] img image dimensions
+/// @retval int layout of the pixel data (enum RawLayout)
+/// @retval -1 invalid magic number, data format, or dimensions
+int raw_parse_header(const uint8 *h, struct Image *img);
+
+
+/// @brief Build the RAW file header of @a img with pixel data layout @a layout in @a h.
+///
+/// @param[out] h RAW_HEADER_SIZE bytes
+/// @param img image (3 or 4 channels)
+/// @param layout layout of the pixel data
+void raw_build_header(uint8 *h, struct Image img, enum RawLayout layout);
+
+
+/// @brief Reads a RAW image file and returns its pixel data, height, width, and number of
 ///        channels in an Image struct. The function aborts in case of any error.
 ///
 /// @param filename path to file
@@ -80,10 +164,142 @@ struct Image {
 struct Image read_raw_image(char *filename);
 
 
-/// @brief Saves an image in RAW image file format. The function aborts in case of any error.
+/// @brief Reads a RAW image file into @a img like read_raw_image(), but reuses the pixel buffer
+///        of @a img (resized with realloc() if the dimensions differ). Reading a sequence of
+///        frames this way keeps a single buffer alive. The function aborts in case of any error.
+///
+/// @param filename path to file
+/// @param[in,out] img image whose data is NULL or was allocated by a previous read. Must not be
+///                a view.
+void read_raw_image_reuse(char *filename, struct Image *img);
+
+
+/// @brief Saves an image in RAW image file format. @a img may be a view, in which case only the
+///        pixels of the view are written. The function aborts in case of any error.
 ///
 /// @param filename path to file
 /// @param struct Image image
 void write_raw_image(char *filename, struct Image img);
 
+
+/// @brief Saves an image in the compressed RAW format (data format "BGRz" or "BGAz"), which
+///        read_raw_image() reads transparently. The header is followed by the number of rows per
+///        block, the number of blocks, and the compressed size of every block (32-bit little
+///        endian each), then by the blocks. Every block of RAW_BLOCK_ROWS rows can be decoded
+///        independently. Within a row, each channel is delta-coded against its left neighbor
+///        and run-length encoded, so flat areas such as fully transparent regions shrink to a
+///        few bytes per row. @a img may be a view. The function aborts in case of any error.
+///
+/// @param filename path to file
+/// @param struct Image image
+void write_raw_image_compressed(char *filename, struct Image img);
+
+
+#define RAW_BLOCK_ROWS 16         ///< rows per block of compressed RAW files
+
+/// @brief Maximum compressed size of a block of @a rows rows of @a img (bytes).
+#define RAW_BLOCK_BOUND(img, rows) \
+  ((size_t)(rows) * (img).channels * ((img).width + ((img).width + 127) / 128))
+
+/// @brief Compress rows @a y to @a y + @a rows - 1 of @a img into @a dst.
+///
+/// @param dst output buffer of at least RAW_BLOCK_BOUND(img, rows) bytes
+/// @param img image. May be a view.
+/// @param y first row
+/// @param rows number of rows
+/// @retval size_t compressed size (bytes)
+size_t raw_compress_block(uint8 *dst, struct Image img, int y, int rows);
+
+
+/// @brief Decompress a block produced by raw_compress_block() into rows @a y to @a y + @a rows
+///        - 1 of @a img. Blocks are independent and may be decoded concurrently.
+///
+/// @param img image. May be a view.
+/// @param y first row
+/// @param rows number of rows
+/// @param src compressed block
+/// @param size size of the compressed block (bytes)
+/// @retval 0 on success
+/// @retval -1 if the block is corrupt
+int raw_decompress_block(struct Image img, int y, int rows, const uint8 *src, size_t size);
+
+
+/// @brief Decode a compressed RAW file held in memory into @a img. The blocks are distributed
+///        round-robin over @a nthreads threads.
+///
+/// @param img image with the dimensions and the number of channels of the file. May be a view.
+/// @param file file contents (header, block table, and blocks)
+/// @param size size of @a file (bytes)
+/// @param nthreads number of decoding threads
+/// @retval 0 on success
+/// @retval -1 if @a file is not a compressed RAW image of the size of @a img or is corrupt
+int raw_decompress(struct Image img, const uint8 *file, size_t size, int nthreads);
+
+
+/// @brief Saves an image in the tiled RAW format (data format "BGRt" or "BGAt"), which
+///        read_raw_image() reads transparently and tiled_open() reads tile by tile. The header is
+///        followed by the tile height and width (32-bit little endian each) and the file offsets
+///        of the tiles (64-bit little endian, row-major tile order), then by the tiles. Each tile
+///        is stored densely packed; tiles at the right and bottom edges are cropped to the image.
+///        @a img may be a view. The function aborts in case of any error.
+///
+/// @param filename path to file
+/// @param struct Image image
+/// @param tile_size tile height and width (pixels)
+void write_raw_image_tiled(char *filename, struct Image img, int tile_size);
+
+
+/// @brief Random-access reader for RAW files. Tiled files are read tile by tile; uncompressed
+///        RAW files are treated as tiles of one row each. Regions are read with pread(), so
+///        several threads may read from the same TiledImage concurrently.
+struct TiledImage {
+  int fd;
+  int height;
+  int width;
+  int channels;
+  int tile_height;
+  int tile_width;
+  int tiles_y;
+  int tiles_x;
+  long long *offset;              ///< file offset of tile (ty, tx) at [ty * tiles_x + tx]
+};
+
+
+/// @brief Open a tiled or uncompressed RAW file for region reads. Only the header and the tile
+///        offsets are read. The function aborts in case of any error (including compressed RAW
+///        files, which do not support random access).
+///
+/// @param filename path to file
+/// @retval struct TiledImage* reader. Close with tiled_close().
+struct TiledImage *tiled_open(char *filename);
+
+
+/// @brief Close @a img.
+///
+/// @param img reader returned by tiled_open()
+void tiled_close(struct TiledImage *img);
+
+
+/// @brief Read the rectangle (@a y, @a x) - (@a y + dst.height, @a x + dst.width) of @a img into
+///        @a dst. Only the tiles intersecting the rectangle are read, and of those only the
+///        covered rows. The function aborts if the rectangle is not inside @a img or in case of
+///        any other error.
+///
+/// @param dst output image with the channels of @a img. May be a view.
+/// @param img reader
+/// @param y y coordinate of the top-left corner of the rectangle
+/// @param x x coordinate of the top-left corner of the rectangle
+void tiled_read_into(struct Image dst, struct TiledImage *img, int y, int x);
+
+
+/// @brief Read a rectangle of @a img into a new image. See tiled_read_into().
+///
+/// @param img reader
+/// @param y y coordinate of the top-left corner of the rectangle
+/// @param x x coordinate of the top-left corner of the rectangle
+/// @param height height of the rectangle
+/// @param width  width of the rectangle
+/// @retval struct Image densely packed image
+struct Image tiled_read(struct TiledImage *img, int y, int x, int height, int width);
+
 #endif // __IMLIB_H__
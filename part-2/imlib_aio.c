@@ -0,0 +1,572 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Asynchronous image I/O
+///        This module implements the completion-based image loader declared in imlib_aio.h.
+///        The io_uring backend talks to the kernel directly through the io_uring_setup/enter
+///        system calls so that no additional library is required.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "imlib_aio.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#define HAVE_IO_URING
+#endif
+
+#define DIO_ALIGN   4096          // alignment of O_DIRECT buffers, offsets, and lengths
+
+enum RequestState { rsFree, rsHeader, rsData, rsWrite, rsDone };
+
+struct Request {
+  enum RequestState state;
+  struct ImageOp op;
+  int fd;
+  int direct;                     // file opened with O_DIRECT
+  uint8 *hdr;                     // header buffer (one block in direct mode)
+  uint8 *dst;                     // current read destination
+  off_t offset;                   // current file offset
+  size_t remaining;               // bytes still to transfer (reads: to reach 'needed')
+  size_t length;                  // length of the current read request
+  struct iovec iov[2];            // header + pixel data for writes
+  uint8 raw_hdr[RAW_HEADER_SIZE]; // header bytes for writes
+  int next;                       // free list / completion queue link
+};
+
+struct Uring {
+  int fd;
+  unsigned *sq_head, *sq_tail, *sq_mask, *sq_array;
+  unsigned *cq_head, *cq_tail, *cq_mask;
+  struct io_uring_sqe *sqes;
+  struct io_uring_cqe *cqes;
+  void *sq_ring, *cq_ring;
+  size_t sq_ring_size, cq_ring_size, sqes_size;
+  unsigned queued;                // SQEs filled in but not yet submitted
+};
+
+struct ImageLoader {
+  int depth;
+  int flags;
+  int inflight;                   // requests neither free nor completed
+  struct Request *req;
+  int free_list;
+  int done_head, done_tail;       // queue of completed requests
+  struct Uring *ring;             // NULL: pread/pwrite backend
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// Helpers
+//
+
+static size_t image_size(struct Image img)
+{
+  return (size_t)img.height * img.width * img.channels;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// io_uring backend
+//
+
+#ifdef HAVE_IO_URING
+
+/// @brief Return non-zero if the kernel supports @a opcode on io_uring @a fd. Kernels without
+///        IORING_REGISTER_PROBE (before 5.6) report no support.
+static int uring_supports(int fd, int opcode)
+{
+  unsigned nops = 256;
+  size_t len = sizeof(struct io_uring_probe) + nops * sizeof(struct io_uring_probe_op);
+  struct io_uring_probe *probe = calloc(1, len);
+  if (probe == NULL) panic("Failed to allocate io_uring probe", errno);
+
+  int res = syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, nops);
+  int supported = (res >= 0) && (opcode <= probe->last_op) &&
+                  (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+
+  free(probe);
+  return supported;
+}
+
+static struct Uring *uring_create(unsigned entries)
+{
+  struct io_uring_params p;
+  struct Uring *r;
+
+  memset(&p, 0, sizeof(p));
+  int fd = syscall(__NR_io_uring_setup, entries, &p);
+  if (fd < 0) return NULL;
+
+  if ((r = calloc(1, sizeof(struct Uring))) == NULL) panic("Failed to allocate io_uring", errno);
+  r->fd = fd;
+  r->sq_ring = r->cq_ring = r->sqes = MAP_FAILED;
+
+  r->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  r->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    if (r->cq_ring_size > r->sq_ring_size) r->sq_ring_size = r->cq_ring_size;
+    r->cq_ring_size = r->sq_ring_size;
+  }
+
+  r->sq_ring = mmap(NULL, r->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd, IORING_OFF_SQ_RING);
+  if (r->sq_ring == MAP_FAILED) goto error;
+
+  if (p.features & IORING_FEAT_SINGLE_MMAP) {
+    r->cq_ring = r->sq_ring;
+  } else {
+    r->cq_ring = mmap(NULL, r->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_CQ_RING);
+    if (r->cq_ring == MAP_FAILED) goto error;
+  }
+
+  r->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+  r->sqes = mmap(NULL, r->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                 fd, IORING_OFF_SQES);
+  if (r->sqes == MAP_FAILED) goto error;
+
+  r->sq_head  = (unsigned*)((char*)r->sq_ring + p.sq_off.head);
+  r->sq_tail  = (unsigned*)((char*)r->sq_ring + p.sq_off.tail);
+  r->sq_mask  = (unsigned*)((char*)r->sq_ring + p.sq_off.ring_mask);
+  r->sq_array = (unsigned*)((char*)r->sq_ring + p.sq_off.array);
+  r->cq_head  = (unsigned*)((char*)r->cq_ring + p.cq_off.head);
+  r->cq_tail  = (unsigned*)((char*)r->cq_ring + p.cq_off.tail);
+  r->cq_mask  = (unsigned*)((char*)r->cq_ring + p.cq_off.ring_mask);
+  r->cqes     = (struct io_uring_cqe*)((char*)r->cq_ring + p.cq_off.cqes);
+
+  // IORING_OP_READ requires Linux 5.6; older kernels use the pread backend
+  if (!uring_supports(fd, IORING_OP_READ) || !uring_supports(fd, IORING_OP_WRITEV)) goto error;
+
+  return r;
+
+error:
+  if (r->sqes != MAP_FAILED) munmap(r->sqes, r->sqes_size);
+  if ((r->cq_ring != MAP_FAILED) && (r->cq_ring != r->sq_ring)) munmap(r->cq_ring, r->cq_ring_size);
+  if (r->sq_ring != MAP_FAILED) munmap(r->sq_ring, r->sq_ring_size);
+  close(fd);
+  free(r);
+  return NULL;
+}
+
+static void uring_destroy(struct Uring *r)
+{
+  munmap(r->sqes, r->sqes_size);
+  if (r->cq_ring != r->sq_ring) munmap(r->cq_ring, r->cq_ring_size);
+  munmap(r->sq_ring, r->sq_ring_size);
+  close(r->fd);
+  free(r);
+}
+
+static void uring_queue(struct Uring *r, int opcode, int fd, void *addr, unsigned len,
+                        off_t offset, int id)
+{
+  unsigned tail = *r->sq_tail;
+  unsigned idx = tail & *r->sq_mask;
+  struct io_uring_sqe *sqe = &r->sqes[idx];
+
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode    = opcode;
+  sqe->fd        = fd;
+  sqe->addr      = (unsigned long)addr;
+  sqe->len       = len;
+  sqe->off       = offset;
+  sqe->user_data = id;
+
+  r->sq_array[idx] = idx;
+  __atomic_store_n(r->sq_tail, tail+1, __ATOMIC_RELEASE);
+  r->queued++;
+}
+
+static void uring_enter(struct Uring *r, int wait)
+{
+  int res;
+  do {
+    res = syscall(__NR_io_uring_enter, r->fd, r->queued, wait ? 1 : 0,
+                  wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+  } while ((res < 0) && (errno == EINTR));
+  if (res < 0) panic("io_uring_enter failed", errno);
+  r->queued -= res;
+}
+
+#endif // HAVE_IO_URING
+
+
+//-------------------------------------------------------------------------------------------------
+// Request state machine
+//
+
+static void finish(struct ImageLoader *l, int id, int status)
+{
+  struct Request *q = &l->req[id];
+
+  if (q->fd >= 0) close(q->fd);
+  q->fd = -1;
+  q->op.status = status;
+  if ((status < 0) && (q->op.type == ioRead)) {
+    free(q->op.buffer);
+    q->op.buffer = q->op.img.data = NULL;
+  }
+  if ((q->hdr != NULL) && (q->hdr != q->op.buffer)) free(q->hdr);
+  q->hdr = NULL;
+
+  q->state = rsDone;
+  q->next = -1;
+  if (l->done_tail < 0) l->done_head = id;
+  else l->req[l->done_tail].next = id;
+  l->done_tail = id;
+}
+
+// Issue the next transfer of request @a id. With the pread/pwrite backend the transfer is
+// executed immediately and process() is called recursively through issue_sync().
+static void process(struct ImageLoader *l, int id, long res);
+
+static void issue(struct ImageLoader *l, int id)
+{
+  struct Request *q = &l->req[id];
+
+#ifdef HAVE_IO_URING
+  if (l->ring) {
+    if (q->state == rsWrite) {
+      int n = q->iov[0].iov_len ? 2 : 1;
+      uring_queue(l->ring, IORING_OP_WRITEV, q->fd, &q->iov[2-n], n, q->offset, id);
+    } else {
+      uring_queue(l->ring, IORING_OP_READ, q->fd, q->dst, q->length, q->offset, id);
+    }
+    return;
+  }
+#endif
+
+  long res;
+  if (q->state == rsWrite) {
+    int n = q->iov[0].iov_len ? 2 : 1;
+    res = pwritev(q->fd, &q->iov[2-n], n, q->offset);
+  } else {
+    res = pread(q->fd, q->dst, q->length, q->offset);
+  }
+  process(l, id, res < 0 ? -errno : res);
+}
+
+static void process(struct ImageLoader *l, int id, long res)
+{
+  struct Request *q = &l->req[id];
+
+  if (res < 0) {
+    finish(l, id, res);
+    return;
+  }
+
+  switch (q->state) {
+    case rsHeader: {
+      if (res < RAW_HEADER_SIZE) {
+        finish(l, id, -EIO);
+        return;
+      }
+      int layout = raw_parse_header(q->hdr, &q->op.img);
+      if (layout != rlPlain) {
+        // compressed and tiled files are left to read_raw_image()
+        finish(l, id, layout < 0 ? -EINVAL : -ENOTSUP);
+        return;
+      }
+
+      size_t size = image_size(q->op.img);
+      if (q->direct) {
+        // Read whole blocks into an aligned buffer; the first block is already in q->hdr.
+        size_t total = (RAW_HEADER_SIZE + size + DIO_ALIGN-1) & ~(size_t)(DIO_ALIGN-1);
+        if (posix_memalign((void**)&q->op.buffer, DIO_ALIGN, total)) {
+          finish(l, id, -ENOMEM);
+          return;
+        }
+        memcpy(q->op.buffer, q->hdr, res);
+        q->op.img.data = (uint8*)q->op.buffer + RAW_HEADER_SIZE;
+        if (RAW_HEADER_SIZE + size <= (size_t)res) {
+          finish(l, id, 0);
+          return;
+        }
+        q->offset = DIO_ALIGN;
+        q->dst = (uint8*)q->op.buffer + DIO_ALIGN;
+        q->remaining = RAW_HEADER_SIZE + size - DIO_ALIGN;
+        q->length = total - DIO_ALIGN;
+      } else {
+        if ((q->op.buffer = malloc(size ? size : 1)) == NULL) {
+          finish(l, id, -ENOMEM);
+          return;
+        }
+        q->op.img.data = q->op.buffer;
+        if (size == 0) {
+          finish(l, id, 0);
+          return;
+        }
+        q->offset = RAW_HEADER_SIZE;
+        q->dst = q->op.buffer;
+        q->remaining = q->length = size;
+      }
+      q->state = rsData;
+      issue(l, id);
+      return;
+    }
+
+    case rsData:
+      if (res == 0) {
+        finish(l, id, -EIO);          // file truncated
+        return;
+      }
+      if ((size_t)res >= q->remaining) {
+        finish(l, id, 0);
+        return;
+      }
+      // short read: continue where we stopped (block-aligned in direct mode)
+      q->remaining -= res;
+      q->offset += res;
+      q->dst += res;
+      q->length -= res;
+      issue(l, id);
+      return;
+
+    case rsWrite: {
+      size_t n = res;
+      for (int i=0; i<2; i++) {
+        size_t c = n < q->iov[i].iov_len ? n : q->iov[i].iov_len;
+        q->iov[i].iov_base = (uint8*)q->iov[i].iov_base + c;
+        q->iov[i].iov_len -= c;
+        n -= c;
+      }
+      q->offset += res;
+      if (q->iov[1].iov_len == 0) finish(l, id, 0);
+      else if (res == 0) finish(l, id, -EIO);
+      else issue(l, id);
+      return;
+    }
+
+    default:
+      panic("Invalid request state", 0);
+  }
+}
+
+static int alloc_request(struct ImageLoader *l)
+{
+  int id = l->free_list;
+  if (id < 0) return -1;
+
+  l->free_list = l->req[id].next;
+  memset(&l->req[id], 0, sizeof(struct Request));
+  l->req[id].fd = -1;
+  l->inflight++;
+
+  return id;
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Public interface
+//
+
+struct ImageLoader *loader_create(int depth, int flags)
+{
+  struct ImageLoader *l;
+
+  if ((depth < 1) || (depth > 4096)) panic("Invalid loader queue depth", 0);
+
+  if ((l = calloc(1, sizeof(struct ImageLoader))) == NULL) {
+    panic("Failed to allocate image loader", errno);
+  }
+  if ((l->req = calloc(depth, sizeof(struct Request))) == NULL) {
+    panic("Failed to allocate image loader", errno);
+  }
+
+  l->depth = depth;
+  l->flags = flags;
+  for (int i=0; i<depth; i++) l->req[i].next = i+1 < depth ? i+1 : -1;
+  l->free_list = 0;
+  l->done_head = l->done_tail = -1;
+
+#ifdef HAVE_IO_URING
+  if (!(flags & AIO_NO_URING)) l->ring = uring_create(depth);
+#endif
+
+  return l;
+}
+
+void loader_destroy(struct ImageLoader *loader)
+{
+  struct ImageOp op;
+
+  while (loader_complete(loader, &op, 1)) loader_release(&op);
+
+#ifdef HAVE_IO_URING
+  if (loader->ring) uring_destroy(loader->ring);
+#endif
+
+  free(loader->req);
+  free(loader);
+}
+
+const char *loader_backend(struct ImageLoader *loader)
+{
+  return loader->ring ? "io_uring" : "pread";
+}
+
+int loader_submit_read(struct ImageLoader *loader, char *filename, void *user)
+{
+  int id = alloc_request(loader);
+  if (id < 0) return -1;
+
+  struct Request *q = &loader->req[id];
+  q->op.type = ioRead;
+  q->op.filename = filename;
+  q->op.user = user;
+  q->state = rsHeader;
+
+  if (loader->flags & AIO_DIRECT) {
+    // not all file systems support O_DIRECT (e.g., tmpfs); fall back to buffered I/O
+    q->fd = open(filename, O_RDONLY | O_DIRECT);
+    q->direct = q->fd >= 0;
+  }
+  if (q->fd < 0) q->fd = open(filename, O_RDONLY);
+  if (q->fd < 0) {
+    finish(loader, id, -errno);
+    return 0;
+  }
+
+  size_t hsize = q->direct ? DIO_ALIGN : RAW_HEADER_SIZE;
+  if (posix_memalign((void**)&q->hdr, DIO_ALIGN, hsize)) {
+    finish(loader, id, -ENOMEM);
+    return 0;
+  }
+  q->dst = q->hdr;
+  q->offset = 0;
+  q->length = hsize;
+  issue(loader, id);
+
+  return 0;
+}
+
+int loader_submit_write(struct ImageLoader *loader, char *filename, struct Image img, void *user)
+{
+  int id = alloc_request(loader);
+  if (id < 0) return -1;
+
+  struct Request *q = &loader->req[id];
+  q->op.type = ioWrite;
+  q->op.filename = filename;
+  q->op.user = user;
+  q->op.img = img;
+  q->state = rsWrite;
+
+  if ((img.data == NULL) || (img.channels < 3) || (4 < img.channels) ||
+      (STRIDE(img) != img.width * img.channels)) {
+    finish(loader, id, -EINVAL);
+    return 0;
+  }
+
+  if ((q->fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0) {
+    finish(loader, id, -errno);
+    return 0;
+  }
+
+  raw_build_header(q->raw_hdr, img, rlPlain);
+  q->iov[0].iov_base = q->raw_hdr;
+  q->iov[0].iov_len  = RAW_HEADER_SIZE;
+  q->iov[1].iov_base = img.data;
+  q->iov[1].iov_len  = image_size(img);
+  q->offset = 0;
+  issue(loader, id);
+
+  return 0;
+}
+
+int loader_complete(struct ImageLoader *loader, struct ImageOp *op, int wait)
+{
+#ifdef HAVE_IO_URING
+  struct Uring *r = loader->ring;
+
+  while (r && (loader->done_head < 0) && (loader->inflight > 0)) {
+    if (r->queued || wait) uring_enter(r, wait);
+
+    unsigned head = *r->cq_head;
+    unsigned tail = __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+      if (wait) continue;
+      break;
+    }
+    for (; head != tail; head++) {
+      struct io_uring_cqe *cqe = &r->cqes[head & *r->cq_mask];
+      process(loader, cqe->user_data, cqe->res);
+    }
+    __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+  }
+#endif
+
+  int id = loader->done_head;
+  if (id < 0) return 0;
+
+  struct Request *q = &loader->req[id];
+  loader->done_head = q->next;
+  if (loader->done_head < 0) loader->done_tail = -1;
+
+  *op = q->op;
+
+  q->state = rsFree;
+  q->next = loader->free_list;
+  loader->free_list = id;
+  loader->inflight--;
+
+  return 1;
+}
+
+void loader_release(struct ImageOp *op)
+{
+  if (op->type == ioRead) free(op->buffer);
+  op->buffer = op->img.data = NULL;
+}
+
+void read_raw_images(char **filenames, int n, struct Image *imgs)
+{
+  struct ImageLoader *l = loader_create(n < 64 ? n : 64, 0);
+  struct ImageOp op;
+  int next = 0, done = 0;
+
+  if (l->ring == NULL) {
+    // no io_uring (or no IORING_OP_READ): nothing to overlap, read synchronously
+    loader_destroy(l);
+    for (int i=0; i<n; i++) imgs[i] = read_raw_image(filenames[i]);
+    return;
+  }
+
+  while (done < n) {
+    while ((next < n) && (loader_submit_read(l, filenames[next], &imgs[next]) == 0)) next++;
+
+    if (!loader_complete(l, &op, 1)) panic("Image loader stalled", 0);
+    if (op.status == -ENOTSUP) {
+      // compressed or tiled RAW file
+      *(struct Image*)op.user = read_raw_image(op.filename);
+      done++;
+      continue;
+    }
+    if (op.status < 0) {
+      char msg[256];
+      snprintf(msg, sizeof(msg), "Cannot read image %s", op.filename);
+      panic(msg, -op.status);
+    }
+    *(struct Image*)op.user = op.img;
+    done++;
+  }
+
+  loader_destroy(l);
+}
@@ -0,0 +1,123 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Asynchronous image I/O
+///        Completion-based interface to load and store many RAW images concurrently. On Linux,
+///        requests are submitted through io_uring; if io_uring is not available (kernel older
+///        than 5.6 without IORING_OP_READ, seccomp filter, ...) the loader silently falls back
+///        to pread/pwrite.
+///
+///        Typical use:
+///          struct ImageLoader *l = loader_create(32, 0);
+///          for each file: while (loader_submit_read(l, file, ctx) < 0) { wait for a completion }
+///          while (loader_complete(l, &op, 1) > 0) { use op.img; loader_release(&op); }
+///          loader_destroy(l);
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#ifndef __IMLIB_AIO_H__
+#define __IMLIB_AIO_H__
+
+#include "imlib.h"
+
+/// loader_create() flags
+#define AIO_DIRECT    0x1         ///< open input files with O_DIRECT (page-aligned buffers)
+#define AIO_NO_URING  0x2         ///< do not use io_uring, always use pread/pwrite
+
+enum ImageOpType { ioRead, ioWrite };
+
+/// @brief A completed load or store request as returned by loader_complete().
+struct ImageOp {
+  enum ImageOpType type;          ///< ioRead or ioWrite
+  char *filename;                 ///< file name passed to loader_submit_*()
+  void *user;                     ///< user pointer passed to loader_submit_*()
+  int status;                     ///< 0 on success, negative errno value on failure
+  struct Image img;               ///< loaded image (ioRead) or image that was written (ioWrite)
+  void *buffer;                   ///< allocation backing img.data (ioRead only)
+};
+
+struct ImageLoader;
+
+
+/// @brief Create a loader that keeps up to @a depth requests in flight.
+///
+/// @param depth maximum number of outstanding requests (1 - 4096)
+/// @param flags combination of AIO_DIRECT and AIO_NO_URING
+/// @retval struct ImageLoader* loader. The function aborts in case of any error.
+struct ImageLoader *loader_create(int depth, int flags);
+
+
+/// @brief Release all resources of a loader. Outstanding requests are waited for and their
+///        buffers released.
+///
+/// @param loader loader
+void loader_destroy(struct ImageLoader *loader);
+
+
+/// @brief Return the name of the active backend ("io_uring" or "pread").
+///
+/// @param loader loader
+/// @retval const char* backend name
+const char *loader_backend(struct ImageLoader *loader);
+
+
+/// @brief Submit an asynchronous image load. The header and the pixel data are read in two
+///        dependent requests; the payload read is issued as soon as the header completes.
+///        Compressed and tiled RAW files (see write_raw_image_compressed() and
+///        write_raw_image_tiled()) are not decoded by the loader; their requests complete with
+///        status -ENOTSUP.
+///
+/// @param loader loader
+/// @param filename path to file. Must remain valid until the request completes.
+/// @param user opaque pointer returned with the completion
+/// @retval 0 request submitted
+/// @retval -1 queue full, retrieve completions first
+int loader_submit_read(struct ImageLoader *loader, char *filename, void *user);
+
+
+/// @brief Submit an asynchronous image store. Header and pixel data are written with a single
+///        vectored write. img.data must remain valid until the request completes. Views (see
+///        image_view()) are not supported and complete with -EINVAL.
+///
+/// @param loader loader
+/// @param filename path to file. Must remain valid until the request completes.
+/// @param img image to write
+/// @param user opaque pointer returned with the completion
+/// @retval 0 request submitted
+/// @retval -1 queue full, retrieve completions first
+int loader_submit_write(struct ImageLoader *loader, char *filename, struct Image img, void *user);
+
+
+/// @brief Retrieve one completed request.
+///
+/// @param loader loader
+/// @param[out] op completed request
+/// @param wait if non-zero, block until a request completes
+/// @retval 1 a completion was stored in @a op
+/// @retval 0 no completion available (or nothing in flight if @a wait is set)
+int loader_complete(struct ImageLoader *loader, struct ImageOp *op, int wait);
+
+
+/// @brief Free the pixel buffer of a completed load.
+///
+/// @param op completed request
+void loader_release(struct ImageOp *op);
+
+
+/// @brief Load @a n RAW images concurrently. Convenience wrapper for the drivers; the images
+///        can be freed with free(img.data). Compressed and tiled RAW files, and all files on
+///        kernels without io_uring support for IORING_OP_READ (Linux < 5.6), are read
+///        synchronously with read_raw_image(). The function aborts in case of any error.
+///
+/// @param filenames array of @a n file names
+/// @param n number of files
+/// @param[out] imgs array of @a n images
+void read_raw_images(char **filenames, int n, struct Image *imgs);
+
+#endif // __IMLIB_AIO_H__
@@ -0,0 +1,509 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Content-hash result cache
+///        Results are stored as RAW files named <key>.raw in the cache directory. The modification
+///        time of a file is its last use: hits touch the file, eviction removes the files with
+///        the oldest modification time until the total size is below the limit. New results are
+///        written to a temporary file and renamed, so concurrent jobs never see partial files.
+///        Hit/miss/eviction counters accumulate across runs in the file 'stats'.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include "imlib_cache.h"
+
+#define CHUNK_SIZE  (256 << 10)   // read granularity of read_raw_image_hash()
+
+struct ResultCache {
+  char *dir;
+  long long max_size;
+  long hits, misses, evictions;
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// XXH64
+//
+
+#define P1 11400714785074694791ULL
+#define P2 14029467366897019727ULL
+#define P3  1609587929392839161ULL
+#define P4  9650029242287828579ULL
+#define P5  2870177450012600261ULL
+
+struct HashState {
+  uint64_t v[4];
+  uint64_t seed;
+  uint64_t total;
+  uint8 buf[32];
+  size_t buflen;
+};
+
+static inline uint64_t rotl(uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8 *p)
+{
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));       // little-endian hosts only (x86, RISC-V)
+  return v;
+}
+
+static inline uint32_t read32(const uint8 *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline uint64_t xxh_round(uint64_t acc, uint64_t input)
+{
+  acc += input * P2;
+  acc  = rotl(acc, 31);
+  return acc * P1;
+}
+
+static inline uint64_t xxh_merge(uint64_t acc, uint64_t val)
+{
+  acc ^= xxh_round(0, val);
+  return acc * P1 + P4;
+}
+
+static void hash_init(struct HashState *s, uint64_t seed)
+{
+  s->v[0] = seed + P1 + P2;
+  s->v[1] = seed + P2;
+  s->v[2] = seed;
+  s->v[3] = seed - P1;
+  s->seed = seed;
+  s->total = 0;
+  s->buflen = 0;
+}
+
+static void hash_block(struct HashState *s, const uint8 *p)
+{
+  s->v[0] = xxh_round(s->v[0], read64(p));
+  s->v[1] = xxh_round(s->v[1], read64(p+8));
+  s->v[2] = xxh_round(s->v[2], read64(p+16));
+  s->v[3] = xxh_round(s->v[3], read64(p+24));
+}
+
+static void hash_update(struct HashState *s, const void *data, size_t len)
+{
+  const uint8 *p = data;
+  s->total += len;
+
+  if (s->buflen + len < 32) {
+    memcpy(s->buf + s->buflen, p, len);
+    s->buflen += len;
+    return;
+  }
+
+  if (s->buflen > 0) {
+    size_t fill = 32 - s->buflen;
+    memcpy(s->buf + s->buflen, p, fill);
+    hash_block(s, s->buf);
+    p += fill;
+    len -= fill;
+    s->buflen = 0;
+  }
+
+  for (; len >= 32; p += 32, len -= 32) hash_block(s, p);
+
+  memcpy(s->buf, p, len);
+  s->buflen = len;
+}
+
+static uint64_t hash_digest(struct HashState *s)
+{
+  uint64_t h;
+
+  if (s->total >= 32) {
+    h = rotl(s->v[0], 1) + rotl(s->v[1], 7) + rotl(s->v[2], 12) + rotl(s->v[3], 18);
+    for (int i=0; i<4; i++) h = xxh_merge(h, s->v[i]);
+  } else {
+    h = s->seed + P5;
+  }
+  h += s->total;
+
+  const uint8 *p = s->buf;
+  size_t len = s->buflen;
+  for (; len >= 8; p += 8, len -= 8) {
+    h ^= xxh_round(0, read64(p));
+    h  = rotl(h, 27) * P1 + P4;
+  }
+  if (len >= 4) {
+    h ^= (uint64_t)read32(p) * P1;
+    h  = rotl(h, 23) * P2 + P3;
+    p += 4;
+    len -= 4;
+  }
+  for (; len > 0; p++, len--) {
+    h ^= *p * P5;
+    h  = rotl(h, 11) * P1;
+  }
+
+  h ^= h >> 33;
+  h *= P2;
+  h ^= h >> 29;
+  h *= P3;
+  h ^= h >> 32;
+
+  return h;
+}
+
+
+uint64_t hash_bytes(const void *data, size_t len, uint64_t seed)
+{
+  struct HashState s;
+  hash_init(&s, seed);
+  hash_update(&s, data, len);
+  return hash_digest(&s);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Image hashing
+//
+
+uint64_t image_hash(struct Image img)
+{
+  struct HashState s;
+  uint8 h[RAW_HEADER_SIZE];
+
+  hash_init(&s, 0);
+  raw_build_header(h, img, rlPlain);
+  hash_update(&s, h, sizeof(h));
+  for (int y=0; y<img.height; y++) {
+    hash_update(&s, &PIXEL(img, y, 0, 0), (size_t)img.width * img.channels);
+  }
+
+  return hash_digest(&s);
+}
+
+
+struct Image read_raw_image_hash(char *filename, uint64_t *hash)
+{
+  FILE *f;
+  struct Image img = { NULL, -1, -1, -1, 0 };
+  struct HashState s;
+  uint8 h[RAW_HEADER_SIZE];
+
+  // Open file and read header
+  if ((f = fopen(filename, "rb")) == NULL) panic("Cannot open file", errno);
+  if (fread(h, sizeof(h), 1, f) < 1) panic("Cannot read image header", errno);
+
+  if (raw_parse_header(h, &img) != rlPlain) {
+    // compressed or tiled: decode, then hash the pixels (same hash as the uncompressed file).
+    // read_raw_image() also reports invalid headers.
+    fclose(f);
+    img = read_raw_image(filename);
+    *hash = image_hash(img);
+    return img;
+  }
+
+  hash_init(&s, 0);
+  hash_update(&s, h, sizeof(h));
+
+  // Allocate memory for image data
+  size_t img_size = (size_t)img.height * img.width * img.channels;
+  if ((img.data = malloc(sizeof(uint8)*img_size)) == NULL) {
+    panic("Failed to allocate memory for image", errno);
+  }
+
+  // Read pixel data and hash each chunk while it is still in the cache
+  for (size_t pos=0; pos<img_size; pos+=CHUNK_SIZE) {
+    size_t len = img_size - pos < CHUNK_SIZE ? img_size - pos : CHUNK_SIZE;
+    if (fread(img.data + pos, sizeof(uint8), len, f) < len) panic("Cannot read image data", errno);
+    hash_update(&s, img.data + pos, len);
+  }
+
+  // Clean up and return
+  fclose(f);
+  *hash = hash_digest(&s);
+
+  return img;
+}
+
+
+uint64_t cache_key(const char *params, const uint64_t *hashes, int n)
+{
+  struct HashState s;
+
+  hash_init(&s, 0);
+  hash_update(&s, params, strlen(params));
+  hash_update(&s, hashes, n * sizeof(uint64_t));
+
+  return hash_digest(&s);
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Result cache
+//
+
+struct Entry {
+  char name[32];
+  off_t size;
+  struct timespec mtime;
+};
+
+static void entry_path(struct ResultCache *c, uint64_t key, char *path, size_t len)
+{
+  snprintf(path, len, "%s/%016llx.raw", c->dir, (unsigned long long)key);
+}
+
+static int compare_mtime(const void *a, const void *b)
+{
+  const struct timespec *x = &((const struct Entry*)a)->mtime;
+  const struct timespec *y = &((const struct Entry*)b)->mtime;
+  if (x->tv_sec != y->tv_sec) return x->tv_sec < y->tv_sec ? -1 : 1;
+  return x->tv_nsec < y->tv_nsec ? -1 : x->tv_nsec > y->tv_nsec;
+}
+
+/// @brief Remove the least recently used results until the cache fits its size limit.
+static void evict(struct ResultCache *c)
+{
+  DIR *d = opendir(c->dir);
+  if (d == NULL) return;
+
+  struct Entry *e = NULL;
+  int n = 0, cap = 0;
+  long long total = 0;
+  struct dirent *de;
+
+  while ((de = readdir(d)) != NULL) {
+    size_t len = strlen(de->d_name);
+    if ((len != 20) || strcmp(de->d_name + 16, ".raw")) continue;
+
+    struct stat st;
+    if (fstatat(dirfd(d), de->d_name, &st, 0) < 0) continue;
+
+    if (n == cap) {
+      cap = cap ? 2*cap : 64;
+      struct Entry *ne = realloc(e, cap * sizeof(struct Entry));
+      if (ne == NULL) break;
+      e = ne;
+    }
+    strcpy(e[n].name, de->d_name);
+    e[n].size = st.st_size;
+    e[n].mtime = st.st_mtim;
+    total += st.st_size;
+    n++;
+  }
+
+  if (total > c->max_size) {
+    qsort(e, n, sizeof(struct Entry), compare_mtime);
+    for (int i=0; (i<n) && (total > c->max_size); i++) {
+      if (unlinkat(dirfd(d), e[i].name, 0) == 0) {
+        total -= e[i].size;
+        c->evictions++;
+      }
+    }
+  }
+
+  closedir(d);
+  free(e);
+}
+
+/// @brief Read (and, if @a add is not NULL, add @a add to) the persistent counters.
+///
+/// @param c cache
+/// @param[out] v hits, misses, and evictions recorded in the stats file
+/// @param add values to add or NULL
+static void update_stats(struct ResultCache *c, long *v, const long *add)
+{
+  char path[PATH_MAX];
+  snprintf(path, sizeof(path), "%s/stats", c->dir);
+
+  v[0] = v[1] = v[2] = 0;
+  int fd = open(path, add ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+  if (fd < 0) return;
+  flock(fd, add ? LOCK_EX : LOCK_SH);
+
+  char buf[128];
+  ssize_t len = read(fd, buf, sizeof(buf)-1);
+  if (len > 0) {
+    buf[len] = '\0';
+    sscanf(buf, "%ld %ld %ld", &v[0], &v[1], &v[2]);
+  }
+
+  if (add) {
+    for (int i=0; i<3; i++) v[i] += add[i];
+    len = snprintf(buf, sizeof(buf), "%ld %ld %ld\n", v[0], v[1], v[2]);
+    if ((ftruncate(fd, 0) < 0) || (pwrite(fd, buf, len, 0) != len)) {
+      fprintf(stderr, "Warning: cannot update cache statistics: %s\n", strerror(errno));
+    }
+  }
+
+  close(fd);
+}
+
+/// @brief Copy the open file @a src to @a dst.
+///
+/// @retval int 0 on success, -1 on error
+static int copy_fd(int src, int dst)
+{
+#ifdef __linux__
+  // in-kernel copy (may share extents on file systems with reflink support)
+  ssize_t res;
+  while ((res = copy_file_range(src, NULL, dst, NULL, 1 << 30, 0)) > 0);
+  if (res == 0) return 0;
+  if ((errno != EXDEV) && (errno != ENOSYS) && (errno != EINVAL)) return -1;
+  if ((lseek(src, 0, SEEK_SET) < 0) || (lseek(dst, 0, SEEK_SET) < 0)) return -1;
+#endif
+
+  char buf[64 << 10];
+  ssize_t len;
+  while ((len = read(src, buf, sizeof(buf))) > 0) {
+    for (ssize_t done = 0; done < len; ) {
+      ssize_t res = write(dst, buf + done, len - done);
+      if (res < 0) return -1;
+      done += res;
+    }
+  }
+
+  return len < 0 ? -1 : 0;
+}
+
+
+struct ResultCache *cache_open(const char *dir, long long max_size)
+{
+  if ((mkdir(dir, 0755) < 0) && (errno != EEXIST)) {
+    fprintf(stderr, "Warning: cannot create cache directory %s: %s\n", dir, strerror(errno));
+    return NULL;
+  }
+
+  struct ResultCache *c = calloc(1, sizeof(struct ResultCache));
+  if ((c == NULL) || ((c->dir = strdup(dir)) == NULL)) {
+    fprintf(stderr, "Warning: cannot allocate result cache\n");
+    free(c);
+    return NULL;
+  }
+  c->max_size = max_size;
+
+  return c;
+}
+
+
+void cache_close(struct ResultCache *cache)
+{
+  if (cache == NULL) return;
+
+  long v[3], add[3] = { cache->hits, cache->misses, cache->evictions };
+  update_stats(cache, v, add);
+
+  free(cache->dir);
+  free(cache);
+}
+
+
+int cache_fetch(struct ResultCache *cache, uint64_t key, char *filename)
+{
+  char path[PATH_MAX];
+  entry_path(cache, key, path, sizeof(path));
+
+  int src = open(path, O_RDONLY);
+  if (src < 0) {
+    cache->misses++;
+    return 0;
+  }
+
+  int dst = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if ((dst < 0) || (copy_fd(src, dst) < 0)) {
+    fprintf(stderr, "Warning: cannot copy cached result to %s: %s\n", filename, strerror(errno));
+    if (dst >= 0) close(dst);
+    close(src);
+    cache->misses++;
+    return 0;
+  }
+
+  // mark as recently used
+  futimens(src, NULL);
+
+  close(dst);
+  close(src);
+  cache->hits++;
+
+  return 1;
+}
+
+
+void cache_store(struct ResultCache *cache, uint64_t key, struct Image img)
+{
+  char path[PATH_MAX], tmp[PATH_MAX];
+  entry_path(cache, key, path, sizeof(path));
+  snprintf(tmp, sizeof(tmp), "%s/.tmp-%d-%016llx", cache->dir, getpid(), (unsigned long long)key);
+
+  FILE *f = fopen(tmp, "wb");
+  if (f == NULL) {
+    fprintf(stderr, "Warning: cannot store result in cache: %s\n", strerror(errno));
+    return;
+  }
+
+  uint8 h[RAW_HEADER_SIZE];
+  raw_build_header(h, img, rlPlain);
+  int ok = fwrite(h, sizeof(h), 1, f) == 1;
+  size_t row_size = (size_t)img.width * img.channels;
+  for (int y=0; ok && (y<img.height); y++) {
+    ok = fwrite(&PIXEL(img, y, 0, 0), sizeof(uint8), row_size, f) == row_size;
+  }
+  if ((fclose(f) != 0) || !ok || (rename(tmp, path) < 0)) {
+    fprintf(stderr, "Warning: cannot store result in cache: %s\n", strerror(errno));
+    unlink(tmp);
+    return;
+  }
+
+  evict(cache);
+}
+
+
+
+void cache_store_file(struct ResultCache *cache, uint64_t key, char *filename)
+{
+  char path[PATH_MAX], tmp[PATH_MAX];
+  entry_path(cache, key, path, sizeof(path));
+  snprintf(tmp, sizeof(tmp), "%s/.tmp-%d-%016llx", cache->dir, getpid(), (unsigned long long)key);
+
+  int src = open(filename, O_RDONLY);
+  int dst = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  int ok = (src >= 0) && (dst >= 0) && (copy_fd(src, dst) == 0);
+  if (src >= 0) close(src);
+  if ((dst >= 0) && (close(dst) < 0)) ok = 0;
+  if (!ok || (rename(tmp, path) < 0)) {
+    fprintf(stderr, "Warning: cannot store result in cache: %s\n", strerror(errno));
+    unlink(tmp);
+    return;
+  }
+
+  evict(cache);
+}
+
+void cache_stats(struct ResultCache *cache, long *hits, long *misses, long *evictions)
+{
+  long v[3];
+  update_stats(cache, v, NULL);
+
+  *hits = v[0] + cache->hits;
+  *misses = v[1] + cache->misses;
+  *evictions = v[2] + cache->evictions;
+}
@@ -0,0 +1,126 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Content-hash result cache
+///        Stores results of blend/blur jobs in a directory, keyed by a 64-bit content hash of the
+///        input images (XXH64) combined with the operation parameters. A repeated job costs one
+///        pass over its inputs to compute the hash plus a file copy of the cached result. The
+///        cache is bounded in size; the least recently used results are evicted first.
+///
+///        Typical use:
+///          struct ResultCache *c = cache_open(dir, 256 << 20);
+///          img = read_raw_image_hash(file, &hash);
+///          key = cache_key("blur int 3x3", &hash, 1);
+///          if (!cache_fetch(c, key, output)) { compute result; write output; cache_store(c, key, result); }
+///          cache_close(c);
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#ifndef __IMLIB_CACHE_H__
+#define __IMLIB_CACHE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "imlib.h"
+
+#define CACHE_SIZE (256LL << 20)  ///< default cache size limit (bytes)
+
+struct ResultCache;
+
+
+/// @brief Compute the XXH64 hash of @a len bytes.
+///
+/// @param data data
+/// @param len number of bytes
+/// @param seed seed value
+/// @retval uint64_t hash
+uint64_t hash_bytes(const void *data, size_t len, uint64_t seed);
+
+
+/// @brief Compute the content hash of an image. The hash covers the RAW header and the pixel data
+///        and equals the hash of the corresponding RAW file. @a img may be a view.
+///
+/// @param img image
+/// @retval uint64_t hash
+uint64_t image_hash(struct Image img);
+
+
+/// @brief Same as read_raw_image(), but also computes the content hash (see image_hash()) of the
+///        image while it is read. The function aborts in case of any error.
+///
+/// @param filename path to file
+/// @param[out] hash content hash
+/// @retval struct Image image
+struct Image read_raw_image_hash(char *filename, uint64_t *hash);
+
+
+/// @brief Combine the content hashes of the inputs and a description of the operation (e.g.,
+///        "blend int overlay 0.5") into a cache key.
+///
+/// @param params operation and parameters
+/// @param hashes content hashes of the input images
+/// @param n number of input images
+/// @retval uint64_t cache key
+uint64_t cache_key(const char *params, const uint64_t *hashes, int n);
+
+
+/// @brief Open (and create, if necessary) a result cache in directory @a dir.
+///
+/// @param dir cache directory
+/// @param max_size size limit in bytes
+/// @retval struct ResultCache* cache, NULL on error (a warning is printed)
+struct ResultCache *cache_open(const char *dir, long long max_size);
+
+
+/// @brief Close the cache and add the counters of this run to the persistent statistics.
+///
+/// @param cache cache (may be NULL)
+void cache_close(struct ResultCache *cache);
+
+
+/// @brief Look up @a key and, on a hit, copy the cached RAW image to @a filename.
+///
+/// @param cache cache
+/// @param key cache key
+/// @param filename output file
+/// @retval 1 hit, result copied to @a filename
+/// @retval 0 miss
+int cache_fetch(struct ResultCache *cache, uint64_t key, char *filename);
+
+
+/// @brief Store the result of a job under @a key and evict old entries if the cache exceeds its
+///        size limit. Errors are reported as warnings; the cache is best-effort.
+///
+/// @param cache cache
+/// @param key cache key
+/// @param img result image
+void cache_store(struct ResultCache *cache, uint64_t key, struct Image img);
+
+
+/// @brief Store the result file @a filename under @a key as is. Use this instead of
+///        cache_store() for results saved in another format than plain RAW (compressed, tiled),
+///        so that a later cache_fetch() produces the same file; the format must then be part of
+///        the job parameters passed to cache_key().
+///
+/// @param cache cache
+/// @param key cache key
+/// @param filename result file
+void cache_store_file(struct ResultCache *cache, uint64_t key, char *filename);
+
+
+/// @brief Return the number of hits, misses, and evictions of all runs that used the cache
+///        directory, including the current one.
+///
+/// @param cache cache
+/// @param[out] hits number of hits
+/// @param[out] misses number of misses
+/// @param[out] evictions number of evicted results
+void cache_stats(struct ResultCache *cache, long *hits, long *misses, long *evictions);
+
+#endif // __IMLIB_CACHE_H__
@@ -0,0 +1,143 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Planar image layout
+///        With SSE2, four-channel rows are converted 16 pixels (64 bytes) at a time. Deinterleave
+///        extracts a channel from the 32-bit pixels with a shift and a mask and narrows the four
+///        vectors with two pack steps; interleave zips the planes with _mm_unpack{lo,hi}_epi8
+///        (B/G and R/A) followed by _mm_unpack{lo,hi}_epi16.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#include <errno.h>
+#include <stdlib.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "imlib_planar.h"
+
+
+struct PlanarImage planar_alloc(int height, int width, int channels)
+{
+  if ((height < 0) || (width < 0) || (channels < 1) || (channels > 4)) {
+    panic("Invalid planar image dimensions.", 0);
+  }
+
+  struct PlanarImage img = {
+    .height = height, .width = width, .channels = channels, .stride = (width + 15) & ~15
+  };
+
+  size_t plane_size = ((size_t)img.stride * height + PLANE_ALIGN-1) & ~(size_t)(PLANE_ALIGN-1);
+  void *p = NULL;
+  if (posix_memalign(&p, PLANE_ALIGN, plane_size * channels)) {
+    panic("Failed to allocate memory for planar image", errno);
+  }
+  for (int c=0; c<channels; c++) img.plane[c] = (uint8*)p + c*plane_size;
+
+  return img;
+}
+
+
+void planar_free(struct PlanarImage *img)
+{
+  free(img->plane[0]);
+  for (int c=0; c<4; c++) img->plane[c] = NULL;
+}
+
+
+void deinterleave_into(struct PlanarImage dst, struct Image src)
+{
+  if ((dst.height != src.height) || (dst.width != src.width) || (dst.channels != src.channels)) {
+    panic("Planar image dimension mismatch.", 0);
+  }
+
+  int ch = src.channels;
+  for (int y=0; y<src.height; y++) {
+    const uint8 *s = &PIXEL(src, y, 0, 0);
+    int x = 0;
+
+#ifdef __SSE2__
+    if (ch == 4) {
+      const __m128i mask = _mm_set1_epi32(0xff);
+
+      for (; x+16 <= src.width; x+=16) {
+        __m128i v[4];
+        for (int i=0; i<4; i++) v[i] = _mm_loadu_si128((const __m128i*)(s + 4*x + 16*i));
+        for (int c=0; c<4; c++) {
+          __m128i b[4];
+          for (int i=0; i<4; i++) b[i] = _mm_and_si128(_mm_srli_epi32(v[i], 8*c), mask);
+          __m128i p = _mm_packus_epi16(_mm_packs_epi32(b[0], b[1]), _mm_packs_epi32(b[2], b[3]));
+          _mm_storeu_si128((__m128i*)&PLANE(dst, c, y, x), p);
+        }
+      }
+    }
+#endif
+
+    for (; x<src.width; x++) {
+      for (int c=0; c<ch; c++) PLANE(dst, c, y, x) = s[ch*x + c];
+    }
+  }
+}
+
+
+void interleave_into(struct Image dst, struct PlanarImage src)
+{
+  if ((dst.height != src.height) || (dst.width != src.width) || (dst.channels != src.channels)) {
+    panic("Planar image dimension mismatch.", 0);
+  }
+
+  int ch = src.channels;
+  for (int y=0; y<src.height; y++) {
+    uint8 *d = &PIXEL(dst, y, 0, 0);
+    int x = 0;
+
+#ifdef __SSE2__
+    if (ch == 4) {
+      for (; x+16 <= src.width; x+=16) {
+        __m128i b = _mm_loadu_si128((const __m128i*)&PLANE(src, 0, y, x));
+        __m128i g = _mm_loadu_si128((const __m128i*)&PLANE(src, 1, y, x));
+        __m128i r = _mm_loadu_si128((const __m128i*)&PLANE(src, 2, y, x));
+        __m128i a = _mm_loadu_si128((const __m128i*)&PLANE(src, 3, y, x));
+        __m128i bg_lo = _mm_unpacklo_epi8(b, g), bg_hi = _mm_unpackhi_epi8(b, g);
+        __m128i ra_lo = _mm_unpacklo_epi8(r, a), ra_hi = _mm_unpackhi_epi8(r, a);
+        __m128i *p = (__m128i*)(d + 4*x);
+        _mm_storeu_si128(p,   _mm_unpacklo_epi16(bg_lo, ra_lo));
+        _mm_storeu_si128(p+1, _mm_unpackhi_epi16(bg_lo, ra_lo));
+        _mm_storeu_si128(p+2, _mm_unpacklo_epi16(bg_hi, ra_hi));
+        _mm_storeu_si128(p+3, _mm_unpackhi_epi16(bg_hi, ra_hi));
+      }
+    }
+#endif
+
+    for (; x<src.width; x++) {
+      for (int c=0; c<ch; c++) d[ch*x + c] = PLANE(src, c, y, x);
+    }
+  }
+}
+
+
+struct PlanarImage image_to_planar(struct Image img)
+{
+  struct PlanarImage p = planar_alloc(img.height, img.width, img.channels);
+  deinterleave_into(p, img);
+
+  return p;
+}
+
+
+struct Image planar_to_image(struct PlanarImage img)
+{
+  struct Image out = { .height = img.height, .width = img.width, .channels = img.channels };
+  if ((out.data = malloc((size_t)img.height * img.width * img.channels)) == NULL) {
+    panic("Failed to allocate memory for image", errno);
+  }
+  interleave_into(out, img);
+
+  return out;
+}
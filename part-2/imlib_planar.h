@@ -0,0 +1,89 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Planar image layout
+///        A planar image stores each channel in its own contiguous plane (structure of arrays)
+///        instead of interleaving the channels of a pixel. Vectorized kernels then operate on 16
+///        values of the same channel without shuffles. Planes start at PLANE_ALIGN-byte
+///        boundaries and every row is padded to a multiple of 16 bytes, so kernels may process
+///        whole 16-byte chunks up to the stride; the values in the padding are unspecified.
+///
+///        Typical use:
+///          struct PlanarImage p = image_to_planar(img);
+///          ... planar kernels ...
+///          out = planar_to_image(p);
+///          planar_free(&p);
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#ifndef __IMLIB_PLANAR_H__
+#define __IMLIB_PLANAR_H__
+
+#include "imlib.h"
+
+#define PLANE_ALIGN 64            ///< alignment of the planes (bytes)
+
+/// @brief Access a value of channel @a c of a planar image. No range checks.
+#define PLANE(img, c, y, x) (img).plane[c][(y) * (img).stride + (x)]
+
+struct PlanarImage {
+  uint8 *plane[4];                ///< channel planes (B, G, R, A); plane[0] owns the allocation
+  int height;
+  int width;
+  int channels;
+  int stride;                     ///< bytes per plane row (multiple of 16, >= width)
+};
+
+
+/// @brief Allocate a planar image. The pixel values are uninitialized. The function aborts in
+///        case of any error.
+///
+/// @param height height
+/// @param width  width
+/// @param channels number of channels (1 - 4)
+/// @retval struct PlanarImage planar image
+struct PlanarImage planar_alloc(int height, int width, int channels);
+
+
+/// @brief Free the planes of @a img.
+///
+/// @param img planar image
+void planar_free(struct PlanarImage *img);
+
+
+/// @brief Split the interleaved image @a src into the planes of @a dst. With SSE2, four-channel
+///        images are converted 16 pixels at a time.
+///
+/// @param dst planar image of the dimensions of @a src
+/// @param src interleaved image. May be a view.
+void deinterleave_into(struct PlanarImage dst, struct Image src);
+
+
+/// @brief Merge the planes of @a src into the interleaved image @a dst. With SSE2, four-channel
+///        images are converted 16 pixels at a time.
+///
+/// @param dst interleaved image of the dimensions of @a src. May be a view.
+/// @param src planar image
+void interleave_into(struct Image dst, struct PlanarImage src);
+
+
+/// @brief Convert @a img to a planar image (see deinterleave_into()).
+///
+/// @param img interleaved image. May be a view.
+/// @retval struct PlanarImage planar image. Free with planar_free().
+struct PlanarImage image_to_planar(struct Image img);
+
+
+/// @brief Convert @a img to an interleaved image (see interleave_into()).
+///
+/// @param img planar image
+/// @retval struct Image densely packed interleaved image
+struct Image planar_to_image(struct PlanarImage img);
+
+#endif // __IMLIB_PLANAR_H__
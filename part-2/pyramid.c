@@ -0,0 +1,168 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Image pyramid (mip chain)
+///        A destination pixel of a four-channel image is computed from the sums over its 2x2
+///        source block
+///          color = round(sum(color * alpha) / sum(alpha)),  alpha = round(sum(alpha) / 4)
+///        with the unweighted average for the color if sum(alpha) is zero. With SSE2, four
+///        destination pixels are computed at a time: the sums are formed in 32-bit lanes with
+///        _mm_madd_epi16() and divided in single precision. All numerators and denominators are
+///        below 2^24 and the quotients below 256, so the truncated float quotient equals the
+///        integer quotient and both versions produce identical results.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#include <stdlib.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "pyramid.h"
+
+
+/// @brief Compute one destination pixel @a d from the two source pixels at @a p (upper row) and
+///        @a q (lower row).
+static void box(uint8 *d, const uint8 *p, const uint8 *q, int channels)
+{
+  int c = 0;
+
+  if (channels == 4) {
+    int a = p[3] + p[7] + q[3] + q[7];
+    if (a > 0) {
+      for (; c<3; c++) {
+        int s = p[c]*p[3] + p[c+4]*p[7] + q[c]*q[3] + q[c+4]*q[7];
+        d[c] = (2*s + a) / (2*a);
+      }
+    }
+  }
+
+  for (; c<channels; c++) {
+    d[c] = (p[c] + p[c+channels] + q[c] + q[c+channels] + 2) / 4;
+  }
+}
+
+#ifdef __SSE2__
+/// @brief Compute one destination pixel of a four-channel image from the 16-bit lanes of two
+///        horizontally adjacent source pixels of the upper (@a r0) and lower row (@a r1).
+///
+/// @retval __m128i destination pixel in four 32-bit lanes
+static inline __m128i box_sse2(__m128i r0, __m128i r1)
+{
+  const __m128i ones = _mm_set1_epi16(1);
+  const __m128i four = _mm_set1_epi32(4);
+  const __m128i alpha_lane = _mm_set_epi32(-1, 0, 0, 0);
+
+  // interleave the two pixels of a row (B0 B1 G0 G1 R0 R1 A0 A1) so that _mm_madd_epi16() sums
+  // the products of a channel over both of them
+  r0 = _mm_unpacklo_epi16(r0, _mm_srli_si128(r0, 8));
+  r1 = _mm_unpacklo_epi16(r1, _mm_srli_si128(r1, 8));
+
+  __m128i w = _mm_add_epi32(_mm_madd_epi16(r0, _mm_shuffle_epi32(r0, 0xff)),
+                            _mm_madd_epi16(r1, _mm_shuffle_epi32(r1, 0xff)));
+  __m128i s = _mm_add_epi32(_mm_madd_epi16(r0, ones), _mm_madd_epi16(r1, ones));
+
+  // alpha and the color of transparent blocks: unweighted; color otherwise: weighted by alpha
+  __m128i a = _mm_shuffle_epi32(s, 0xff);
+  __m128i m = _mm_or_si128(_mm_cmpeq_epi32(a, _mm_setzero_si128()), alpha_lane);
+  __m128i num = _mm_or_si128(_mm_and_si128(m, s), _mm_andnot_si128(m, w));
+  __m128i den = _mm_or_si128(_mm_and_si128(m, four), _mm_andnot_si128(m, a));
+
+  // (2*num + den) / (2*den)
+  __m128 n = _mm_cvtepi32_ps(_mm_add_epi32(_mm_add_epi32(num, num), den));
+  __m128 d = _mm_cvtepi32_ps(_mm_add_epi32(den, den));
+  return _mm_cvttps_epi32(_mm_div_ps(n, d));
+}
+#endif
+
+
+/// @brief Compute row @a y of @a dst from rows 2*@a y and 2*@a y+1 of @a src.
+static void downsample_row(struct Image dst, struct Image src, int y)
+{
+  const uint8 *p = &PIXEL(src, 2*y, 0, 0);
+  const uint8 *q = &PIXEL(src, 2*y+1, 0, 0);
+  uint8 *d = &PIXEL(dst, y, 0, 0);
+  int ch = dst.channels;
+  int x = 0;
+
+#ifdef __SSE2__
+  if (ch == 4) {
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; x+4 <= dst.width; x+=4) {
+      __m128i r[2][2], t[2];
+      for (int i=0; i<2; i++) {
+        __m128i u = _mm_loadu_si128((const __m128i*)(p + 8*x + 16*i));
+        __m128i v = _mm_loadu_si128((const __m128i*)(q + 8*x + 16*i));
+        r[0][0] = _mm_unpacklo_epi8(u, zero); r[0][1] = _mm_unpackhi_epi8(u, zero);
+        r[1][0] = _mm_unpacklo_epi8(v, zero); r[1][1] = _mm_unpackhi_epi8(v, zero);
+        t[i] = _mm_packs_epi32(box_sse2(r[0][0], r[1][0]), box_sse2(r[0][1], r[1][1]));
+      }
+      _mm_storeu_si128((__m128i*)(d + 4*x), _mm_packus_epi16(t[0], t[1]));
+    }
+  }
+#endif
+
+  for (; x<dst.width; x++) {
+    box(d + ch*x, p + 2*ch*x, q + 2*ch*x, ch);
+  }
+}
+
+
+void downsample_into(struct Image dst, struct Image src)
+{
+  if ((dst.channels != src.channels) ||
+      (dst.height != src.height/2) || (dst.width != src.width/2)) abort();
+
+  for (int y=0; y<dst.height; y++) downsample_row(dst, src, y);
+}
+
+
+/// @brief Row @a y of level @a k of @a chain has been computed; compute the rows of the
+///        following levels that depend on it.
+static void cascade(struct Image *chain, int levels, int k, int y)
+{
+  while ((k < levels) && (y & 1)) {
+    y /= 2;
+    downsample_row(chain[k+1], chain[k], y);
+    k++;
+  }
+}
+
+
+int image_pyramid(struct Image img, int levels, struct Image *level)
+{
+  if ((levels < 1) || (levels > PYRAMID_MAX_LEVELS)) abort();
+
+  // chain[0] is the input image, chain[k] is level[k-1]
+  struct Image chain[PYRAMID_MAX_LEVELS+1];
+  chain[0] = img;
+
+  int n = 0;
+  while ((n < levels) && (chain[n].height >= 2) && (chain[n].width >= 2)) {
+    struct Image *l = &chain[n+1];
+    *l = (struct Image){
+      .height = chain[n].height/2, .width = chain[n].width/2, .channels = img.channels
+    };
+    l->data = malloc((size_t)l->height * l->width * l->channels);
+    if (l->data == NULL) abort();
+    n++;
+  }
+  if (n == 0) return 0;
+
+  // Stream through the rows of the input; every second row of a level completes a row of the
+  // next level (rows beyond the last complete pair of an odd-height level are ignored)
+  for (int y=0; y<2*chain[1].height; y+=2) {
+    downsample_row(chain[1], chain[0], y/2);
+    cascade(chain, n, 1, y/2);
+  }
+
+  for (int k=0; k<n; k++) level[k] = chain[k+1];
+
+  return n;
+}
@@ -0,0 +1,54 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Image pyramid (mip chain)
+///        Builds the 1/2, 1/4, 1/8, ... downscaled versions of an image with a 2x2 box filter.
+///        For images with four channels, the color channels are weighted by alpha so that
+///        transparent pixels do not bleed their (meaningless) color into the result.
+///
+///        Typical use:
+///          struct Image level[3];
+///          int n = image_pyramid(img, 3, level);
+///          for (int i=0; i<n; i++) { write level[i]; free(level[i].data); }
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#ifndef __PYRAMID_H__
+#define __PYRAMID_H__
+
+#include "imlib.h"
+
+#define PYRAMID_MAX_LEVELS 16     ///< maximum number of levels built by image_pyramid()
+
+
+/// @brief Downscale @a src by a factor of two into @a dst. Every pixel of @a dst is the average of
+///        a 2x2 block of @a src; an odd last row or column of @a src is ignored. For four-channel
+///        images (BGRA), the color channels are averaged weighted by alpha and alpha is averaged
+///        unweighted; a fully transparent block yields the unweighted average. Results are
+///        rounded to nearest.
+///
+/// @param dst output image. Must be of dimension (src.height/2) x (src.width/2) with the same
+///        number of channels as @a src and must not overlap @a src. May be a view.
+/// @param src image to downscale. May be a view.
+void downsample_into(struct Image dst, struct Image src);
+
+
+/// @brief Build the first @a levels levels of the image pyramid of @a img: level[i] is @a img
+///        downscaled by 2^(i+1) with downsample_into(). All levels are computed in a single pass
+///        over @a img: as soon as two rows of a level are available, the row of the next level is
+///        computed from them while they are still in the cache. Building stops early when a
+///        level would have a height or width of zero.
+///
+/// @param img image. May be a view.
+/// @param levels number of levels to build (1 - PYRAMID_MAX_LEVELS)
+/// @param[out] level array of at least @a levels images. The caller frees level[i].data.
+/// @retval int number of levels built. The function aborts in case of any error.
+int image_pyramid(struct Image img, int levels, struct Image *level);
+
+#endif // __PYRAMID_H__
@@ -0,0 +1,194 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Image pyramid driver
+///        This program loads a RAW image, builds its image pyramid (1/2, 1/4, 1/8, ... thumbnails),
+///        then stores each level to disk in RAW format.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+/// @section license_section License
+/// Copyright (c) 2023, Computer Systems and Platforms Laboratory, SNU
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without modification, are permitted
+/// provided that the following conditions are met:
+///
+/// - Redistributions of source code must retain the above copyright notice, this list of condi-
+///   tions and the following disclaimer.
+/// - Redistributions in binary form must reproduce the above copyright notice, this list of condi-
+///   tions and the following disclaimer in the documentation and/or other materials provided with
+///   the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+/// IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE IMPLIED WARRANTIES OF MERCHANTABILITY
+/// AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+/// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR CONSE-
+/// QUENTIAL DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+/// LOSS OF USE,  DATA, OR PROFITS; OR BUSINESS INTERRUPTION)  HOWEVER CAUSED AND ON ANY THEORY OF
+/// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+/// DAMAGE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <libgen.h>
+
+#include "imlib.h"
+#include "pyramid.h"
+
+struct Arguments {
+  int levels;
+  char *image;
+  char *output;
+};
+
+
+/// @brief Print program syntax and exit. Does not return.
+///
+/// @param msg optional error/informational message.
+void syntax(char *msg)
+{
+  if (msg) printf("%s\n\n", msg);
+
+  printf("Usage: pyramid_driver [-h] [--levels N] [--output OUTPUT] image\n"
+         "\n"
+         "Positional arguments:\n"
+         "  image                       The image to downscale\n"
+         "\n"
+         "Options:\n"
+         "  -h/--help                   Show this help message and exit\n"
+         "  -l/--levels N               Number of levels (1 - %d, default: 3)\n"
+         "  -o/--output OUTPUT          Force name prefix of output images\n",
+         PYRAMID_MAX_LEVELS);
+
+  exit(EXIT_FAILURE);
+}
+
+
+/// @brief Parse arguments
+///
+/// @param argc number of command line arguments
+/// @param argv command line arguments
+/// @retval struct Argument parsed command line arguments
+struct Arguments parse_arguments(int argc, char *argv[])
+{
+  struct Arguments args = { .levels = 3, .image = NULL, .output = NULL };
+
+  for (int i=1; i<argc; i++) {
+    if (!strcmp("--levels", argv[i]) || !strcmp("-l", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--levels'.");
+      char *endptr;
+      args.levels = strtol(argv[i], &endptr, 10);
+      if ((*endptr != '\0') || (args.levels < 1) || (args.levels > PYRAMID_MAX_LEVELS)) {
+        syntax("Invalid number of levels.");
+      }
+    } else
+    if (!strcmp("--output", argv[i]) || !strcmp("-o", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--output'.");
+      args.output = argv[i];
+    } else
+    if (!strcmp("--help", argv[i]) || !strcmp("-h", argv[i])) {
+      syntax(NULL);
+    } else {
+      if (args.image == NULL) args.image = argv[i];
+      else syntax("Too many images or unknown option.");
+    }
+  }
+
+  if (args.image == NULL) syntax("No image file provided.");
+
+  return args;
+}
+
+/// @brief Split a basename (filename.ext) into filename and extension at the last '.'.
+///        Basename is assumed to not contain any path delimiters. Warning: modifies basename!
+///
+/// @param[in/out] basename basename (filename.ext)
+/// @param[out] ext pointer to string to hold extension
+void splitext(char *basename, char **ext)
+{
+  *ext = NULL;
+
+  // assumption: basename is not NULL and does not contain a path
+  char *p = basename;
+  while (*p != '\0') {
+    if (*p == '.') *ext = p+1;
+    p++;
+  }
+
+  // split basename into filename and extension by removing the last '.'
+  if (*ext) *(*ext-1) = '\0';
+}
+
+
+int main(int argc, char *argv[])
+{
+  struct Arguments args;
+  struct Image image, level[PYRAMID_MAX_LEVELS];
+  char *prefix;
+  int n;
+
+  // Parse command line arguments
+  args = parse_arguments(argc, argv);
+
+  // Read image
+  printf("Loading RAW image %s...\n", args.image);
+  image = read_raw_image(args.image);
+  printf("  Image dimensions %d x %d x %d\n", image.height, image.width, image.channels);
+
+
+  // Construct output filename prefix
+  if (args.output == NULL) {
+    char *out, *dn, *bn, *ext;
+    out = strdup(args.image); dn = strdup(dirname(out));  free(out);
+    out = strdup(args.image); bn = strdup(basename(out)); free(out);
+    splitext(bn, &ext);
+
+    size_t prefix_size = strlen(dn)+strlen(bn)+2;
+    prefix = calloc(prefix_size, sizeof(char));
+    snprintf(prefix, prefix_size, "%s/%s", dn, bn);
+
+    free(dn);
+    free(bn);
+  } else {
+    prefix = strdup(args.output);
+  }
+
+
+  // Build pyramid
+  printf("Building image pyramid (levels: %d)...\n", args.levels);
+
+  clock_t t_start = clock();
+  n = image_pyramid(image, args.levels, level);
+  clock_t t_stop = clock();
+  printf("  Elapsed time: %.6f seconds\n", ((float)(t_stop-t_start))/CLOCKS_PER_SEC);
+  if (n < args.levels) printf("  Image too small; built %d levels\n", n);
+
+
+  // Save levels
+  size_t lfn_size = strlen(prefix)+32;
+  char *lfn = calloc(lfn_size, sizeof(char));
+  for (int i=0; i<n; i++) {
+    snprintf(lfn, lfn_size, "%s_1_%d.raw", prefix, 2 << i);
+    printf("Saving level %d (%d x %d x %d) as %s\n",
+           i+1, level[i].height, level[i].width, level[i].channels, lfn);
+    write_raw_image(lfn, level[i]);
+    free(level[i].data);
+  }
+
+
+  // Cleanup
+  free(lfn);
+  free(prefix);
+  free(image.data);
+
+
+  // That's all, folks!
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief RAW format benchmark
+///        This program measures the throughput of the uncompressed and the compressed RAW format
+///        (write, read, and in-memory decoding with several threads) for a given image.
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+/// @section license_section License
+/// Copyright (c) 2023, Computer Systems and Platforms Laboratory, SNU
+/// All rights reserved.
+///
+/// Redistribution and use in source and binary forms, with or without modification, are permitted
+/// provided that the following conditions are met:
+///
+/// - Redistributions of source code must retain the above copyright notice, this list of condi-
+///   tions and the following disclaimer.
+/// - Redistributions in binary form must reproduce the above copyright notice, this list of condi-
+///   tions and the following disclaimer in the documentation and/or other materials provided with
+///   the distribution.
+///
+/// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+/// IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE IMPLIED WARRANTIES OF MERCHANTABILITY
+/// AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+/// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR CONSE-
+/// QUENTIAL DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+/// LOSS OF USE,  DATA, OR PROFITS; OR BUSINESS INTERRUPTION)  HOWEVER CAUSED AND ON ANY THEORY OF
+/// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+/// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+/// DAMAGE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "imlib.h"
+
+struct Arguments {
+  char *image;
+  char *dir;                      // directory for the temporary files
+  int threads;                    // maximum number of decoding threads
+  int repeat;
+};
+
+
+/// @brief Print program syntax and exit. Does not return.
+///
+/// @param msg optional error/informational message.
+void syntax(char *msg)
+{
+  if (msg) printf("%s\n\n", msg);
+
+  printf("Usage: raw_bench [-h] [--dir DIR] [--threads N] [--repeat N] image\n"
+         "\n"
+         "Positional arguments:\n"
+         "  image                       The image to store and load\n"
+         "\n"
+         "Options:\n"
+         "  -h/--help                   Show this help message and exit\n"
+         "  -d/--dir DIR                Directory for the temporary files (default: /tmp)\n"
+         "  -t/--threads N              Maximum number of decoding threads (default: 4)\n"
+         "  -r/--repeat N               Number of repetitions per measurement (default: 5)\n");
+
+  exit(EXIT_FAILURE);
+}
+
+
+/// @brief Parse arguments
+///
+/// @param argc number of command line arguments
+/// @param argv command line arguments
+/// @retval struct Argument parsed command line arguments
+struct Arguments parse_arguments(int argc, char *argv[])
+{
+  struct Arguments args = { .image = NULL, .dir = "/tmp", .threads = 4, .repeat = 5 };
+
+  for (int i=1; i<argc; i++) {
+    if (!strcmp("--dir", argv[i]) || !strcmp("-d", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--dir'.");
+      args.dir = argv[i];
+    } else
+    if (!strcmp("--threads", argv[i]) || !strcmp("-t", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--threads'.");
+      char *endptr;
+      args.threads = strtol(argv[i], &endptr, 10);
+      if ((*endptr != '\0') || (args.threads < 1)) syntax("Invalid number of threads.");
+    } else
+    if (!strcmp("--repeat", argv[i]) || !strcmp("-r", argv[i])) {
+      if (++i == argc) syntax("Missing argument after '--repeat'.");
+      char *endptr;
+      args.repeat = strtol(argv[i], &endptr, 10);
+      if ((*endptr != '\0') || (args.repeat < 1)) syntax("Invalid number of repetitions.");
+    } else
+    if (!strcmp("--help", argv[i]) || !strcmp("-h", argv[i])) {
+      syntax(NULL);
+    } else {
+      if (args.image == NULL) args.image = argv[i];
+      else syntax("Too many images or unknown option.");
+    }
+  }
+
+  if (args.image == NULL) syntax("No image file provided.");
+
+  return args;
+}
+
+
+/// @brief Wall-clock time in seconds.
+static double now(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+/// @brief Return the size of file @a filename in bytes.
+static long long file_size(char *filename)
+{
+  struct stat st;
+  if (stat(filename, &st) < 0) panic("Cannot stat file", 0);
+  return st.st_size;
+}
+
+
+int main(int argc, char *argv[])
+{
+  struct Arguments args;
+  struct Image image, loaded;
+  double t, mb;
+
+  // Parse command line arguments
+  args = parse_arguments(argc, argv);
+
+  // Read image
+  printf("Loading RAW image %s...\n", args.image);
+  image = read_raw_image(args.image);
+  printf("  Image dimensions %d x %d x %d\n", image.height, image.width, image.channels);
+  size_t size = (size_t)image.height * image.width * image.channels;
+  mb = size / 1e6;
+
+  size_t fn_size = strlen(args.dir) + 32;
+  char *fn[2] = { calloc(fn_size, 1), calloc(fn_size, 1) };
+  snprintf(fn[0], fn_size, "%s/raw_bench.raw", args.dir);
+  snprintf(fn[1], fn_size, "%s/raw_bench_z.raw", args.dir);
+
+  // Write and read both formats (reads are served from the page cache)
+  printf("Format        File size     Write MB/s    Read MB/s\n");
+  for (int z=0; z<2; z++) {
+    t = now();
+    for (int r=0; r<args.repeat; r++) {
+      if (z) write_raw_image_compressed(fn[z], image);
+      else write_raw_image(fn[z], image);
+    }
+    double t_write = (now() - t) / args.repeat;
+
+    t = now();
+    for (int r=0; r<args.repeat; r++) {
+      loaded = read_raw_image(fn[z]);
+      if (r < args.repeat-1) free(loaded.data);
+    }
+    double t_read = (now() - t) / args.repeat;
+    if (memcmp(loaded.data, image.data, size)) panic("Decoded image differs from the original.", 0);
+    free(loaded.data);
+
+    long long fs = file_size(fn[z]);
+    printf("%-12s  %10lld    %10.1f   %10.1f   (%.1f%%)\n", z ? "compressed" : "raw",
+           fs, mb / t_write, mb / t_read, 100.0 * fs / (size + RAW_HEADER_SIZE));
+  }
+
+  // Decode only, with 1, 2, 4, ... threads
+  long long fs = file_size(fn[1]);
+  uint8 *file = malloc(fs);
+  FILE *f = fopen(fn[1], "rb");
+  if ((file == NULL) || (f == NULL) || (fread(file, 1, fs, f) < (size_t)fs)) {
+    panic("Cannot read compressed file", 0);
+  }
+  fclose(f);
+  loaded = image;
+  if ((loaded.data = malloc(size)) == NULL) panic("Out of memory", 0);
+
+  printf("Threads       Decode MB/s\n");
+  for (int n=1; n<=args.threads; n*=2) {
+    t = now();
+    for (int r=0; r<args.repeat; r++) {
+      if (raw_decompress(loaded, file, fs, n) < 0) panic("Corrupt image data.", 0);
+    }
+    t = (now() - t) / args.repeat;
+    if (memcmp(loaded.data, image.data, size)) panic("Decoded image differs from the original.", 0);
+    printf("%7d       %11.1f\n", n, mb / t);
+  }
+
+
+  // Cleanup
+  remove(fn[0]);
+  remove(fn[1]);
+  free(fn[0]);
+  free(fn[1]);
+  free(file);
+  free(loaded.data);
+  free(image.data);
+
+
+  // That's all, folks!
+  return EXIT_SUCCESS;
+}
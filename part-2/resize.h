@@ -0,0 +1,75 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Bilinear image resizing
+///        Resizes BGR and BGRA images with fixed-point bilinear interpolation. The resizer
+///        produces the output one row at a time, so a consumer (e.g., blending) can process a
+///        resized image row by row without materializing it.
+///
+///        Typical use:
+///          struct Resizer *r = resize_create(src, height, width);
+///          for (y=0; y<height; y++) { resize_row(r, y, row); consume row; }
+///          resize_destroy(r);
+///
+/// @author Hyunwoo LEE <dlgusdn0414@snu.ac.kr>
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo Lee : created
+///
+//-------------------------------------------------------------------------------------------------
+
+#ifndef __RESIZE_H__
+#define __RESIZE_H__
+
+#include "imlib.h"
+
+struct Resizer;
+
+
+/// @brief Create a resizer that scales @a src to @a height x @a width pixels. The pixel centers
+///        of the output are mapped onto the input; pixels outside the input are clamped to its
+///        border. Interpolation weights have 8 fractional bits.
+///
+/// @param src source image (3 or 4 channels). May be a view; must stay valid while the resizer
+///        is in use.
+/// @param height height of the output (>= 1)
+/// @param width  width of the output (>= 1)
+/// @retval struct Resizer* resizer. The function aborts in case of any error.
+struct Resizer *resize_create(struct Image src, int height, int width);
+
+
+/// @brief Release the resizer.
+///
+/// @param r resizer
+void resize_destroy(struct Resizer *r);
+
+
+/// @brief Compute row @a y of the resized image into @a dst. Rows are cheapest when requested in
+///        increasing order: the two horizontally interpolated source rows of the previous call
+///        are reused.
+///
+/// @param r resizer
+/// @param y row of the output
+/// @param dst output row. Must be of dimension 1 x width with the channels of the source. May be
+///        a view.
+void resize_row(struct Resizer *r, int y, struct Image dst);
+
+
+/// @brief Resize @a src into @a dst using the dimensions of @a dst. Both images may be views and
+///        must not overlap.
+///
+/// @param dst output image. Must have the channels of @a src.
+/// @param src source image (3 or 4 channels).
+void resize_into(struct Image dst, struct Image src);
+
+
+/// @brief Resize @a src to @a height x @a width pixels and return the resized image.
+///
+/// @param src source image (3 or 4 channels).
+/// @param height height of the output (>= 1)
+/// @param width  width of the output (>= 1)
+/// @retval struct Image resized image. The function aborts in case of any error.
+struct Image resize_bilinear(struct Image src, int height, int width);
+
+#endif // __RESIZE_H__
@@ -46,10 +46,11 @@ struct Image blend_vector(struct Image img1, struct Image img2, int mode, int al
 /// @param blended result image (pre-allocated).
 /// @param img1 background image. Must have four channels.
 /// @param img2 foreground image. Must have four channels and be of the same dimension as img1.
-/// @param mode blending mode. Must be 1 (overlay)
+/// @param mode blending mode. Must be 1 (overlay); blend_vasm_opt.s and blend_vasm2.s also
+///             support 0 (merge)
 /// @param alpha blending parameter (0 - 256).
 /// @retval 0 on success
-/// @retval -1 overlay != 1
+/// @retval -1 overlay != 1 (blend_vasm_opt.s, blend_vasm2.s: overlay not 0 or 1)
 /// @retval -2 img1 or img2 do not have four channels
 /// @retval -3 output parameter @a blended NULL or blended->data NULL
 int blend_asm(struct Image *blended, struct Image *img1, struct Image *img2, int mode, int alpha);
@@ -22,16 +22,38 @@
 #define IMG2_RAW (void*)0x80200000
 #define OUT_RAW  (void*)0x80280000
 
+// Optional parameter block in simulator memory. If it starts with PARAM_MAGIC, mode and alpha
+// are taken from it instead of the defaults below. This allows sweep.py to vary the parameters
+// with the simulator's '-i' option without recompiling.
+#define PARAM_RAW   (void*)0x80178000
+#define PARAM_MAGIC 0x4d524150    // 'PARM'
+
+struct Params {
+  unsigned int magic;
+  int mode;
+  int alpha;
+  int reserved;
+};
+
 struct Image img1;
 struct Image img2;
 struct Image blended;
 
+#define MODE  1         // <<< blending mode: 1 overlay, 0 merge (blend_vasm_opt.s, blend_vasm2.s)
 #define ALPHA 0x80      // <<< alpha blending factor. Valid range: 0x00 - 0xff
 
 int main(int argc, char *argv[])
 {
+  struct Params *params = PARAM_RAW;
+  int mode = MODE, alpha = ALPHA;
   int res;
 
+  // Override the defaults with the parameter block, if present
+  if (params->magic == PARAM_MAGIC) {
+    mode = params->mode;
+    alpha = params->alpha;
+  }
+
   // Initialize the two images
   if ((res = get_raw_image(&img1, IMG1_RAW)) < 0) return 0x10 - res;
   if ((res = get_raw_image(&img2, IMG2_RAW)) < 0) return 0x20 - res;
@@ -41,7 +63,7 @@ int main(int argc, char *argv[])
   blended.data = OUT_RAW + 16; // data begins after header (16 bytes)
 
   // And...action!
-  if ((res = blend_asm(&blended, &img1, &img2, 1, 0x80)) < 0) return 0x30 - res;
+  if ((res = blend_asm(&blended, &img1, &img2, mode, alpha)) < 0) return 0x30 - res;
 
   // Write result to RAW image data
   if ((res = set_raw_image(&blended, OUT_RAW)) < 0) return 0x40 - res;
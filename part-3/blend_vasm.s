@@ -9,6 +9,8 @@
 #//
 #// @section changelog Change Log
 #// 2023/06/11 Hyunwoo LEE - Fix : optimize assembly code
+#// 2026/10/18 Hyunwoo LEE - Fix : use svlerp for the blend computation
+#// 2026/10/18 Hyunwoo LEE - Fix : use svlwu/svlwa/svspk for the pixel loads and stores
 #// 
 #/-------------------------------------------------------------------------------------------------
 
@@ -66,23 +68,14 @@ blend_asm:
     slli t2, t2, 2                # t2 = t2 * 4
     add t2, t3, t2                # t2 = t3 + t2 // end point
     svbrdcst a4, a4               # a4 = broadcast a4 (alpha)
-    li a6, 256                    # a6 = 256
-    svbrdcst a6, a6               # a6 = broadcast a6
 .L1:
-    lw t4, 0(t0)                  # t4 = img1.data[i] (ARGB)
-    lw t5, 0(t1)                  # t5 = img2.data[i] (ARGB)
-    srli a2, t4, 24               # a2 = img1.data's alpha value
-    srli t6, t5, 24               # t6 = img2.data's alpha value
-    svbrdcst t6, t6               # t6 = broadcast t6
-    svunpack t4, t4               # unpack t4 to vector data
-    svunpack t5, t5               # unpack t5 to vector data
+    lw t4, 0(t0)                  # t4 = img1.data[i] (ARGB, alpha kept for the result)
+    svlwa t6, 0(t1)               # t6 = broadcast img2.data[i]'s alpha value
+    svlwu t5, 0(t1)               # t5 = unpack img2.data[i] to vector data
+    svunpack a2, t4               # a2 = unpack t4 to vector data
     svmul t6, t6, a4              # t6 = alpha value(img2) * alpha
-    svmul t5, t5, t6              # t5 = t5 * t6 (vector)
-    svsub t6, a6, t6              # t6 = a6 - t6 (256 vector - t6)
-    svmul t4, t4, t6              # t4 = t4 * t6
-    svadd t5, t5, t4              # t5 = t5 + t4
-    svpack t5, t5, a2             # t5 = pack(t5, alpha value(img1))
-    sw t5, 0(t3)                  # store value in blended.data[i]
+    svlerp t5, t5, a2, t6         # t5 = t5 * t6 + a2 * (256 - t6)
+    svspk t5, t4, (t3)            # blended.data[i] = pack(t5, alpha value(img1))
     addi t3, t3, 4                # t3 = t3 + 4
     addi t0, t0, 4                # t0 = t0 + 4
     addi t1, t1, 4                # t1 = t1 + 4
@@ -0,0 +1,181 @@
+#/-------------------------------------------------------------------------------------------------
+#/ 4190.308 Computer Architecture                                                       Spring 2023
+#/
+#// @file
+#// @brief Image blending (two-pixel vector operations)
+#//        This module implements a function that blends two images together (assembly integer
+#//        vector version using the experimental two-pixel SV instructions)
+#//
+#//        The two-pixel instructions operate on the 64-bit vector registers v0-v31, each holding
+#//        two pixels in SV format (the pixel at the lower address in bits 31:0). Both modes
+#//        process two pixels per iteration; a remaining odd pixel and images whose data is not
+#//        8-byte aligned are processed one pixel at a time. The vector registers are
+#//        caller-saved.
+#//
+#// @section changelog Change Log
+#// 2026/10/18 Hyunwoo LEE - Created
+#//
+#/-------------------------------------------------------------------------------------------------
+
+    .option nopic
+    .attribute unaligned_access, 0
+    .attribute stack_align, 16
+
+    .text
+    .align 4
+    .globl blend_asm
+    .type  blend_asm, @function
+
+# struct Image {                 Ofs
+#     uint8 *data;                 0
+#     int height;                  4
+#     int width;                   8
+#     int channels;               12
+# };
+
+# int blend_asm(                 Reg
+#       struct Image *blended,    a0
+#       struct Image *img1,       a1
+#       struct Image *img2,       a2
+#       int overlay,              a3
+#       int alpha                 a4
+#     )
+
+blend_asm:
+    # Check parameters
+    li    t0, 1
+    bgtu  a3, t0, .OverlayError   # if overlay not in {0, 1} goto .OverlayError
+
+    lw    t1, 12(a1)              # t1 = img1->channels
+    lw    t2, 12(a2)              # t2 = img2->channels
+    li    t0, 4                   # t0 = 4
+    bne   t1, t0, .ChannelError   # if img1->channels != 4 goto .ChannelError
+    bne   t2, t0, .ChannelError   # if img2->channels != 4 goto .ChannelError
+
+    # Initialize blended image
+    lw t0, 4(a1)                  # t0 = img1->height
+    lw t1, 8(a1)                  # t1 = img1->width
+    lw t2, 12(a1)                 # t2 = img1->channels
+    sw t0, 4(a0)                  # blended->height = t0
+    sw t1, 8(a0)                  # blended->width = t1
+    sw t2, 12(a0)                 # blended->channels = t2
+
+    # Blend
+    mul t2, t0, t1                # t2 = img1->height * img1->width
+    lw t0, 0(a1)                  # t0 = start address of img1->data
+    lw t1, 0(a2)                  # t1 = start address of img2->data
+    lw t3, 0(a0)                  # t3 = start address of blended.data
+    andi t6, t2, -2               # t6 = number of pixels in pairs
+    slli t2, t2, 2                # t2 = t2 * 4
+    add t2, t3, t2                # t2 = t3 + t2 // end point
+    slli t6, t6, 2                # t6 = t6 * 4
+    add t6, t3, t6                # t6 = t3 + t6 // end point of the pairs
+    beqz a3, .Merge               # if overlay == 0 goto .Merge
+
+    svbrdcst a5, a4               # a5 = broadcast a4 (alpha)
+    or t4, t0, t1                 # the two-pixel loads and stores need 8-byte aligned data
+    or t4, t4, t3
+    andi t4, t4, 7
+    bnez t4, .Tail                # if any image data is not 8-byte aligned goto .Tail
+    svbrdcst2 v1, a4              # v1 = broadcast a4 (alpha) to both pixels
+    beq t3, t6, .Tail             # if there are no pairs goto .Tail
+
+.L2:
+    svld v2, 0(t0)                # v2 = img1.data[i..i+1] (ARGB, alpha kept for the result)
+    svlda v3, 0(t1)               # v3 = broadcast img2.data[i..i+1]'s alpha values
+    svldu v4, 0(t1)               # v4 = unpack img2.data[i..i+1] to vector data
+    svunpack2 v5, v2              # v5 = unpack v2 to vector data
+    svmul2 v3, v3, v1             # v3 = alpha values(img2) * alpha
+    svlerp2 v4, v4, v5, v3        # v4 = v4 * v3 + v5 * (256 - v3)
+    svsdpk v4, v2, (t3)           # blended.data[i..i+1] = pack(v4, alpha values(img1))
+    addi t3, t3, 8                # t3 = t3 + 8
+    addi t0, t0, 8                # t0 = t0 + 8
+    addi t1, t1, 8                # t1 = t1 + 8
+    bne t3, t6, .L2               # if t3 != t6, goto .L2
+
+.Tail:
+    beq t3, t2, .Done             # if t3 == t2, goto .Done
+.L1:
+    lw t4, 0(t0)                  # t4 = img1.data[i] (ARGB, alpha kept for the result)
+    svlwa t5, 0(t1)               # t5 = broadcast img2.data[i]'s alpha value
+    svlwu a6, 0(t1)               # a6 = unpack img2.data[i] to vector data
+    svunpack a2, t4               # a2 = unpack t4 to vector data
+    svmul t5, t5, a5              # t5 = alpha value(img2) * alpha
+    svlerp a6, a6, a2, t5         # a6 = a6 * t5 + a2 * (256 - t5)
+    svspk a6, t4, (t3)            # blended.data[i] = pack(a6, alpha value(img1))
+    addi t3, t3, 4                # t3 = t3 + 4
+    addi t0, t0, 4                # t0 = t0 + 4
+    addi t1, t1, 4                # t1 = t1 + 4
+    bne t3, t2, .L1               # if t3 != t2, goto L1
+    j .Done
+
+.Merge:
+    # w1 = alpha1 * (256 - alpha), w2 = alpha2 * alpha (broadcast to all channels)
+    # color_out = color1 * w1 + color2 * w2, alpha_out = w1 + w2 (saturated)
+    li a5, 256                    # a5 = 256
+    sub a5, a5, a4                # a5 = 256 - alpha
+    or t4, t0, t1                 # the two-pixel loads and stores need 8-byte aligned data
+    or t4, t4, t3
+    andi t4, t4, 7
+    bnez t4, .MergeTail           # if any image data is not 8-byte aligned goto .MergeTail
+    svbrdcst2 v6, a5              # v6 = broadcast a5 (256 - alpha) to both pixels
+    svbrdcst2 v7, a4              # v7 = broadcast a4 (alpha) to both pixels
+    beq t3, t6, .MergeTail        # if there are no pairs goto .MergeTail
+
+    # The two-pixel instructions cannot move alpha_out from the channels into bits 31:24, so
+    # it is packed into the color bytes, stored, and copied into the alpha bytes with lbu/sb.
+.LM2:
+    svlda v2, 0(t0)               # v2 = broadcast img1.data[i..i+1]'s alpha values
+    svlda v3, 0(t1)               # v3 = broadcast img2.data[i..i+1]'s alpha values
+    svldu v4, 0(t0)               # v4 = unpack img1.data[i..i+1] to vector data
+    svldu v5, 0(t1)               # v5 = unpack img2.data[i..i+1] to vector data
+    svmul2 v2, v2, v6             # v2 = w1
+    svmul2 v3, v3, v7             # v3 = w2
+    svmul2 v4, v4, v2             # v4 = v4 * w1
+    svmac2 v5, v5, v3, v4         # v5 = v4 + v5 * w2
+    svadd2 v2, v2, v3             # v2 = alpha_out in all channels (w1 + w2 <= 256, no overflow)
+    svpack2 v2, v2, v2            # v2 = alpha_out in bits 23:0 of each pixel (saturated at 0xff)
+    svsd v2, 0(t3)                # blended.data[i..i+1] = v2
+    lbu t4, 0(t3)                 # t4 = alpha_out of pixel i
+    lbu t5, 4(t3)                 # t5 = alpha_out of pixel i+1
+    svsdpk v5, v2, (t3)           # blended.data[i..i+1] = pack(v5)
+    sb t4, 3(t3)                  # blended.data[i].alpha = t4
+    sb t5, 7(t3)                  # blended.data[i+1].alpha = t5
+    addi t3, t3, 8                # t3 = t3 + 8
+    addi t0, t0, 8                # t0 = t0 + 8
+    addi t1, t1, 8                # t1 = t1 + 8
+    bne t3, t6, .LM2              # if t3 != t6, goto .LM2
+
+.MergeTail:
+    svbrdcst a5, a5               # a5 = broadcast a5
+    svbrdcst a4, a4               # a4 = broadcast a4 (alpha)
+    beq t3, t2, .Done             # if t3 == t2, goto .Done
+.LM:
+    svlwa a2, 0(t0)               # a2 = broadcast img1.data[i]'s alpha value
+    svlwa a3, 0(t1)               # a3 = broadcast img2.data[i]'s alpha value
+    svlwu t4, 0(t0)               # t4 = unpack img1.data[i] to vector data
+    svlwu t5, 0(t1)               # t5 = unpack img2.data[i] to vector data
+    svmul a2, a2, a5              # a2 = w1
+    svmul a3, a3, a4              # a3 = w2
+    svmul t4, t4, a2              # t4 = t4 * w1
+    svmac t5, t5, a3, t4          # t5 = t4 + t5 * w2
+    svadds a2, a2, a3             # a2 = alpha_out in all channels (saturated)
+    svpack a2, a2, zero           # a2 = alpha_out in bits 7:0 (saturated at 0xff)
+    slli a2, a2, 24               # a2 = alpha_out << 24
+    svspk t5, a2, (t3)            # blended.data[i] = pack(t5, alpha_out)
+    addi t3, t3, 4                # t3 = t3 + 4
+    addi t0, t0, 4                # t0 = t0 + 4
+    addi t1, t1, 4                # t1 = t1 + 4
+    bne t3, t2, .LM               # if t3 != t2, goto .LM
+
+.Done:
+    mv    a0, x0                  # move x0 to a0
+    ret
+
+.OverlayError:
+    li    a0, -1
+    ret
+
+.ChannelError:
+    li    a0, -2
+    ret
@@ -0,0 +1,246 @@
+#/-------------------------------------------------------------------------------------------------
+#/ 4190.308 Computer Architecture                                                       Spring 2023
+#/
+#// @file
+#// @brief Image blending (vector operations, optimized)
+#//        This module implements a function that blends two images together (assembly integer
+#//        vector version, unrolled by four with fast paths for transparent and opaque pixels)
+#//
+#//        Overlay mode processes groups of four pixels. All eight input words of a group are
+#//        loaded before the first of them is used, so no load-use stalls occur. Groups whose
+#//        foreground pixels are all transparent (alpha 0) copy the background; groups whose
+#//        foreground pixels are all opaque (alpha 255) use a precomputed weight. The remaining
+#//        n % 4 pixels and merge mode are processed one pixel at a time.
+#//
+#// @section changelog Change Log
+#// 2026/10/18 Hyunwoo LEE - Created
+#// 2026/10/18 Hyunwoo LEE - Fix : svalpha in overlay mode, svlwa/svadds/svpack in merge mode
+#//
+#/-------------------------------------------------------------------------------------------------
+
+    .option nopic
+    .attribute unaligned_access, 0
+    .attribute stack_align, 16
+
+    .text
+    .align 4
+    .globl blend_asm
+    .type  blend_asm, @function
+
+# struct Image {                 Ofs
+#     uint8 *data;                 0
+#     int height;                  4
+#     int width;                   8
+#     int channels;               12
+# };
+
+# int blend_asm(                 Reg
+#       struct Image *blended,    a0
+#       struct Image *img1,       a1
+#       struct Image *img2,       a2
+#       int overlay,              a3
+#       int alpha                 a4
+#     )
+
+blend_asm:
+    # Check parameters
+    li    t0, 1
+    bgtu  a3, t0, .OverlayError   # if overlay not in {0, 1} goto .OverlayError
+
+    lw    t1, 12(a1)              # t1 = img1->channels
+    lw    t2, 12(a2)              # t2 = img2->channels
+    li    t0, 4                   # t0 = 4
+    bne   t1, t0, .ChannelError   # if img1->channels != 4 goto .ChannelError
+    bne   t2, t0, .ChannelError   # if img2->channels != 4 goto .ChannelError
+
+    # Initialize blended image
+    lw t0, 4(a1)                  # t0 = img1->height
+    lw t1, 8(a1)                  # t1 = img1->width
+    lw t2, 12(a1)                 # t2 = img1->channels
+    sw t0, 4(a0)                  # blended->height = t0
+    sw t1, 8(a0)                  # blended->width = t1
+    sw t2, 12(a0)                 # blended->channels = t2
+
+    # Save callee-saved registers
+    addi sp, sp, -32
+    sw s0, 0(sp)
+    sw s1, 4(sp)
+    sw s2, 8(sp)
+    sw s3, 12(sp)
+    sw s4, 16(sp)
+    sw s5, 20(sp)
+    sw s6, 24(sp)
+    sw s7, 28(sp)
+
+    # Blend
+    mul t2, t0, t1                # t2 = img1->height * img1->width
+    lw t0, 0(a1)                  # t0 = start address of img1->data
+    lw t1, 0(a2)                  # t1 = start address of img2->data
+    lw t3, 0(a0)                  # t3 = start address of blended.data
+    andi t6, t2, -4               # t6 = number of pixels in groups of four
+    slli t2, t2, 2                # t2 = t2 * 4
+    add t2, t3, t2                # t2 = t3 + t2 // end point
+    slli t6, t6, 2                # t6 = t6 * 4
+    add t6, t3, t6                # t6 = t3 + t6 // end point of the groups
+    beqz a3, .Merge               # if overlay == 0 goto .Merge
+
+    svbrdcst a4, a4               # a4 = broadcast a4 (alpha)
+    li a7, 255                    # a7 = 255
+    svbrdcst a7, a7               # a7 = broadcast a7
+    svmul a7, a7, a4              # a7 = weight of an opaque pixel (255 * alpha)
+    li a5, 0x01000000             # a5 = smallest word with a non-zero alpha value
+    li a6, 0xff000000             # a6 = smallest word with alpha value 255
+    beq t3, t6, .Tail             # if there are no groups goto .Tail
+
+.Group:
+    lw s0, 0(t1)                  # s0-s3 = img2.data[i..i+3] (ARGB)
+    lw s1, 4(t1)
+    lw s2, 8(t1)
+    lw s3, 12(t1)
+    lw a0, 0(t0)                  # a0-a3 = img1.data[i..i+3] (ARGB)
+    lw a1, 4(t0)
+    lw a2, 8(t0)
+    lw a3, 12(t0)
+    or t4, s0, s1                 # t4 = s0 | s1 | s2 | s3
+    or t5, s2, s3
+    or t4, t4, t5
+    bltu t4, a5, .Transparent     # if all alpha values(img2) == 0 goto .Transparent
+    and t4, s0, s1                # t4 = s0 & s1 & s2 & s3
+    and t5, s2, s3
+    and t4, t4, t5
+    bgeu t4, a6, .Opaque          # if all alpha values(img2) == 255 goto .Opaque
+
+    svalpha s4, s0                # s4-s7 = broadcast alpha values(img2)
+    svalpha s5, s1
+    svalpha s6, s2
+    svalpha s7, s3
+    svunpack s0, s0               # unpack s0-s3 to vector data
+    svunpack s1, s1
+    svunpack s2, s2
+    svunpack s3, s3
+    svmul s4, s4, a4              # s4-s7 = alpha values(img2) * alpha
+    svmul s5, s5, a4
+    svmul s6, s6, a4
+    svmul s7, s7, a4
+    svunpack t4, a0               # t4 = unpack img1.data[i] to vector data
+    svlerp s0, s0, t4, s4         # s0 = s0 * s4 + t4 * (256 - s4)
+    svspk s0, a0, (t3)            # blended.data[i] = pack(s0, alpha value(img1))
+    addi t3, t3, 4                # t3 = t3 + 4
+    svunpack t4, a1
+    svlerp s1, s1, t4, s5
+    svspk s1, a1, (t3)
+    addi t3, t3, 4
+    svunpack t4, a2
+    svlerp s2, s2, t4, s6
+    svspk s2, a2, (t3)
+    addi t3, t3, 4
+    svunpack t4, a3
+    svlerp s3, s3, t4, s7
+    svspk s3, a3, (t3)
+    addi t3, t3, 4
+    addi t0, t0, 16               # t0 = t0 + 16
+    addi t1, t1, 16               # t1 = t1 + 16
+    bne t3, t6, .Group            # if t3 != t6, goto .Group
+
+.Tail:
+    beq t3, t2, .Done             # if t3 == t2, goto .Done
+.L1:
+    lw t4, 0(t0)                  # t4 = img1.data[i] (ARGB, alpha kept for the result)
+    svlwa t5, 0(t1)               # t5 = broadcast img2.data[i]'s alpha value
+    svlwu s0, 0(t1)               # s0 = unpack img2.data[i] to vector data
+    svunpack a2, t4               # a2 = unpack t4 to vector data
+    svmul t5, t5, a4              # t5 = alpha value(img2) * alpha
+    svlerp s0, s0, a2, t5         # s0 = s0 * t5 + a2 * (256 - t5)
+    svspk s0, t4, (t3)            # blended.data[i] = pack(s0, alpha value(img1))
+    addi t3, t3, 4                # t3 = t3 + 4
+    addi t0, t0, 4                # t0 = t0 + 4
+    addi t1, t1, 4                # t1 = t1 + 4
+    bne t3, t2, .L1               # if t3 != t2, goto L1
+    j .Done
+
+    # The fast paths repeat the loop control so that they do not need to jump back
+.Transparent:
+    sw a0, 0(t3)                  # blended.data[i..i+3] = img1.data[i..i+3]
+    sw a1, 4(t3)
+    sw a2, 8(t3)
+    sw a3, 12(t3)
+    addi t3, t3, 16               # t3 = t3 + 16
+    addi t0, t0, 16               # t0 = t0 + 16
+    addi t1, t1, 16               # t1 = t1 + 16
+    bne t3, t6, .Group            # if t3 != t6, goto .Group
+    j .Tail
+
+.Opaque:
+    svunpack s0, s0               # unpack s0-s3 to vector data
+    svunpack s1, s1
+    svunpack s2, s2
+    svunpack s3, s3
+    svunpack t4, a0               # t4 = unpack img1.data[i] to vector data
+    svlerp s0, s0, t4, a7         # s0 = s0 * a7 + t4 * (256 - a7)
+    svspk s0, a0, (t3)            # blended.data[i] = pack(s0, alpha value(img1))
+    addi t3, t3, 4                # t3 = t3 + 4
+    svunpack t4, a1
+    svlerp s1, s1, t4, a7
+    svspk s1, a1, (t3)
+    addi t3, t3, 4
+    svunpack t4, a2
+    svlerp s2, s2, t4, a7
+    svspk s2, a2, (t3)
+    addi t3, t3, 4
+    svunpack t4, a3
+    svlerp s3, s3, t4, a7
+    svspk s3, a3, (t3)
+    addi t3, t3, 4
+    addi t0, t0, 16               # t0 = t0 + 16
+    addi t1, t1, 16               # t1 = t1 + 16
+    bne t3, t6, .Group            # if t3 != t6, goto .Group
+    j .Tail
+
+.Merge:
+    # w1 = alpha1 * (256 - alpha), w2 = alpha2 * alpha (broadcast to all channels)
+    # color_out = color1 * w1 + color2 * w2, alpha_out = w1 + w2 (saturated)
+    li s5, 256                    # s5 = 256
+    sub s5, s5, a4                # s5 = 256 - alpha
+    svbrdcst s5, s5               # s5 = broadcast s5
+    svbrdcst a4, a4               # a4 = broadcast a4 (alpha)
+    beq t3, t2, .Done             # if t3 == t2, goto .Done
+.LM:
+    svlwa a2, 0(t0)               # a2 = broadcast img1.data[i]'s alpha value
+    svlwa a3, 0(t1)               # a3 = broadcast img2.data[i]'s alpha value
+    svlwu t4, 0(t0)               # t4 = unpack img1.data[i] to vector data
+    svlwu t5, 0(t1)               # t5 = unpack img2.data[i] to vector data
+    svmul a2, a2, s5              # a2 = w1
+    svmul a3, a3, a4              # a3 = w2
+    svmul t4, t4, a2              # t4 = t4 * w1
+    svmac t5, t5, a3, t4          # t5 = t4 + t5 * w2
+    svadds a2, a2, a3             # a2 = alpha_out in all channels (saturated)
+    svpack a2, a2, zero           # a2 = alpha_out in bits 7:0 (saturated at 0xff)
+    slli a2, a2, 24               # a2 = alpha_out << 24
+    svspk t5, a2, (t3)            # blended.data[i] = pack(t5, alpha_out)
+    addi t3, t3, 4                # t3 = t3 + 4
+    addi t0, t0, 4                # t0 = t0 + 4
+    addi t1, t1, 4                # t1 = t1 + 4
+    bne t3, t2, .LM               # if t3 != t2, goto .LM
+
+.Done:
+    # Restore callee-saved registers
+    lw s0, 0(sp)
+    lw s1, 4(sp)
+    lw s2, 8(sp)
+    lw s3, 12(sp)
+    lw s4, 16(sp)
+    lw s5, 20(sp)
+    lw s6, 24(sp)
+    lw s7, 28(sp)
+    addi sp, sp, 32
+
+    mv    a0, x0                  # move x0 to a0
+    ret
+
+.OverlayError:
+    li    a0, -1
+    ret
+
+.ChannelError:
+    li    a0, -2
+    ret
@@ -0,0 +1,24 @@
+#ifndef __BLUR_H__
+#define __BLUR_H__
+
+#include "imlib.h"
+
+
+/// @brief Blurs an image with a kernel using fixed-point 16-bit packed integer math. The result
+///        is identical to blur_int(). The image data must contain an alpha channel, i.e.,
+///        image.channels must be four.
+///        The parameter @a blurred holds a pointer to a struct holding the blurred image. Its
+///        data field must point to a memory area large enough to hold the blurred image data;
+///        height, width, and channel fields are set by the function.
+///
+/// @param blurred result image (pre-allocated).
+/// @param image image to blur. Must have four channels.
+/// @param kernel_size size of kernel. Valid values: 3 (3x3), 5 (5x5), and 7 (7x7 kernel).
+/// @retval 0 on success
+/// @retval -1 invalid kernel size
+/// @retval -2 image does not have four channels
+/// @retval -3 image smaller than the kernel
+int blur_asm(struct Image *blurred, struct Image *image, int kernel_size);
+
+
+#endif // __BLUR_H__
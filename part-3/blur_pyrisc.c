@@ -0,0 +1,45 @@
+//-------------------------------------------------------------------------------------------------
+// 4190.308 Computer Architecture                                                       Spring 2023
+//
+/// @file
+/// @brief Image blurring (packed integer)
+///        This module blurs an image with a box filter on the PyRISC simulator
+///
+/// @section changelog Change Log
+/// 2026/10/18 Hyunwoo LEE - Created
+///
+/// @section license_section License
+/// Copyright (c) 2023, Computer Systems and Platforms Laboratory, SNU
+//-------------------------------------------------------------------------------------------------
+
+#include "imlib.h"
+#include "blur.h"
+
+// Locations of RAW image data in simulator memory
+#define IMG_RAW  (void*)0x80180000
+#define OUT_RAW  (void*)0x80280000
+
+struct Image image;
+struct Image blurred;
+
+#define KERNEL_SIZE 3   // <<< kernel size. Valid values: 3, 5, 7
+
+int main(int argc, char *argv[])
+{
+  int res;
+
+  // Initialize the input image
+  if ((res = get_raw_image(&image, IMG_RAW)) < 0) return 0x10 - res;
+
+  // The output image struct is not initialized except for its data pointer which is set
+  // to the data area in the RAW image data of OUT_RAW
+  blurred.data = OUT_RAW + 16; // data begins after header (16 bytes)
+
+  // And...action!
+  if ((res = blur_asm(&blurred, &image, KERNEL_SIZE)) < 0) return 0x30 - res;
+
+  // Write result to RAW image data
+  if ((res = set_raw_image(&blurred, OUT_RAW)) < 0) return 0x40 - res;
+
+  return 0;
+}
@@ -0,0 +1,274 @@
+#/-------------------------------------------------------------------------------------------------
+#/ 4190.308 Computer Architecture                                                       Spring 2023
+#/
+#// @file
+#// @brief Image blurring (packed integer operations)
+#//        This module implements a function that blurs an image with a box filter (assembly
+#//        version of blur_int() with identical results)
+#//
+#//        A pixel (BGRA) is split into two registers with 16-bit lanes, (p & 0x00ff00ff) holding
+#//        B and R, and ((p >> 8) & 0x00ff00ff) holding G and A. All sums of the filter fit into
+#//        16 bits (the kernel weights add up to 255), so the four channels are computed exactly
+#//        with two additions or multiplications per step. The 10-bit lanes of the SV
+#//        instructions cannot hold the sums of a 5x5 or 7x7 window and drop the alpha channel.
+#//
+#//        The filter uses sliding sums. col[x] holds the sum of column x over the rows of the
+#//        current window; for each output row, the new bottom row is added and the old top row
+#//        subtracted in a single pass. Along a row, the window sum S is updated by adding the
+#//        new column and subtracting the column K to the left. The result is
+#//          (k * S + (c - k) * center) >> 8
+#//        where k is the weight of the kernel and c the weight of its center, as in blur_int().
+#//
+#// @section changelog Change Log
+#// 2026/10/18 Hyunwoo LEE - Created
+#//
+#/-------------------------------------------------------------------------------------------------
+
+    .option nopic
+    .attribute unaligned_access, 0
+    .attribute stack_align, 16
+
+    .text
+    .align 4
+    .globl blur_asm
+    .type  blur_asm, @function
+
+# struct Image {                 Ofs
+#     uint8 *data;                 0
+#     int height;                  4
+#     int width;                   8
+#     int channels;               12
+# };
+
+# int blur_asm(                  Reg
+#       struct Image *blurred,    a0
+#       struct Image *image,      a1
+#       int kernel_size           a2
+#     )
+
+# Column buffer on the stack, one 16-byte entry per column x of the input image:
+#   0: col[x] (B, R)    4: col[x] (G, A)    8: column sum of the current row (B, R)   12: (G, A)
+# Entry -1 is zero and serves as the column to the left of column 0.
+
+blur_asm:
+    # Check parameters and select the kernel weights (k, c - k)
+    li    t0, 3
+    li    t1, 28                  # 3x3: k = 255 / 9 = 28, c = 255 - 8 * 28 = 31
+    li    t2, 3
+    beq   a2, t0, .KernelOk
+    li    t0, 5
+    li    t1, 10                  # 5x5: k = 10, c = 15
+    li    t2, 5
+    beq   a2, t0, .KernelOk
+    li    t0, 7
+    li    t1, 5                   # 7x7: k = 5, c = 15
+    li    t2, 10
+    beq   a2, t0, .KernelOk
+    li    a0, -1                  # invalid kernel size
+    ret
+
+.KernelOk:
+    lw    t3, 12(a1)              # t3 = image->channels
+    li    t0, 4
+    bne   t3, t0, .ChannelError   # if image->channels != 4 goto .ChannelError
+    lw    t4, 4(a1)               # t4 = image->height
+    lw    t5, 8(a1)               # t5 = image->width
+    blt   t4, a2, .SizeError      # if image->height < kernel_size goto .SizeError
+    blt   t5, a2, .SizeError      # if image->width < kernel_size goto .SizeError
+
+    # Save callee-saved registers
+    addi  sp, sp, -48
+    sw    s0, 0(sp)
+    sw    s1, 4(sp)
+    sw    s2, 8(sp)
+    sw    s3, 12(sp)
+    sw    s4, 16(sp)
+    sw    s5, 20(sp)
+    sw    s6, 24(sp)
+    sw    s7, 28(sp)
+    sw    s8, 32(sp)
+    sw    s9, 36(sp)
+    sw    s10, 40(sp)
+    sw    s11, 44(sp)
+
+    # Initialize blurred image
+    sub   t6, t4, a2
+    addi  t6, t6, 1               # t6 = height - kernel_size + 1
+    sub   a3, t5, a2
+    addi  a3, a3, 1               # a3 = width - kernel_size + 1
+    sw    t6, 4(a0)               # blurred->height = t6
+    sw    a3, 8(a0)               # blurred->width = a3
+    sw    t3, 12(a0)              # blurred->channels = 4
+
+    mv    s3, t1                  # s3 = k
+    mv    s4, t2                  # s4 = c - k
+    mv    s11, t6                 # s11 = number of output rows
+    li    s5, 0x00ff00ff          # s5 = lane mask
+    li    s8, 0xff00ff00          # s8 = ~lane mask
+    addi  s7, a2, -1
+    slli  s7, s7, 2               # s7 = (kernel_size - 1) * 4
+    slli  s2, t5, 2               # s2 = bytes per row of the input image
+    lw    s0, 0(a1)               # s0 = image->data
+    lw    t4, 0(a0)               # t4 = blurred->data
+
+    # Allocate the column buffer (width + 1 entries) and clear it
+    slli  t0, t5, 4               # t0 = width * 16
+    addi  t0, t0, 16              # t0 = t0 + 16 (entry -1)
+    sub   sp, sp, t0              # sp = sp - t0
+    addi  s6, sp, 16              # s6 = address of entry 0
+    slli  a4, t5, 4
+    add   a4, s6, a4              # a4 = address of entry width (end of the buffer)
+    addi  a5, a2, -1
+    slli  a5, a5, 4
+    add   a5, s6, a5              # a5 = address of entry kernel_size - 1
+    mv    t0, sp
+.Clear:
+    sw    zero, 0(t0)
+    sw    zero, 4(t0)
+    sw    zero, 8(t0)
+    sw    zero, 12(t0)
+    addi  t0, t0, 16
+    bne   t0, a4, .Clear
+
+    # Center of the first window: image->data + (kernel_size / 2) * (bytes per row + 4)
+    srli  t0, a2, 1               # t0 = kernel_size / 2
+    addi  t3, s2, 4
+    mul   t3, t3, t0
+    add   t3, s0, t3              # t3 = center pointer
+
+    # Add rows 0 .. kernel_size - 2 to the column sums
+    mv    t1, s0                  # t1 = image->data
+    mv    t2, s0                  # t2 = top row of the first window
+    addi  a7, a2, -1              # a7 = rows left
+.InitRow:
+    mv    t0, s6                  # t0 = entry 0
+.Init:
+    lw    a0, 0(t1)               # a0 = image pixel
+    lw    a2, 0(t0)               # a2 = col[x] (B, R)
+    lw    a3, 4(t0)               # a3 = col[x] (G, A)
+    srli  t5, a0, 8
+    and   a0, a0, s5              # a0 = B, R
+    and   t5, t5, s5              # t5 = G, A
+    add   a2, a2, a0
+    add   a3, a3, t5
+    sw    a2, 0(t0)
+    sw    a3, 4(t0)
+    addi  t0, t0, 16
+    addi  t1, t1, 4
+    bne   t0, a4, .Init
+    addi  a7, a7, -1
+    bnez  a7, .InitRow
+
+    # Output rows. t1 points to the new bottom row, t2 to the top row of the window
+.Row:
+    mv    t0, s6                  # t0 = entry 0
+    addi  a6, s6, -16             # a6 = entry -1 (column to the left of the window)
+    li    s9, 0                   # s9 = window sum (B, R)
+    li    s10, 0                  # s10 = window sum (G, A)
+
+    # Columns 0 .. kernel_size - 2: update the column sums, no output yet
+.Pro:
+    lw    a0, 0(t1)               # a0 = new bottom pixel
+    lw    a1, 0(t2)               # a1 = old top pixel
+    lw    a2, 0(t0)               # a2 = col[x] (B, R)
+    lw    a3, 4(t0)               # a3 = col[x] (G, A)
+    srli  t5, a0, 8
+    and   a0, a0, s5
+    and   t5, t5, s5
+    srli  t6, a1, 8
+    and   a1, a1, s5
+    and   t6, t6, s5
+    add   a2, a2, a0              # a2, a3 = column sum of the window
+    add   a3, a3, t5
+    sw    a2, 8(t0)
+    sw    a3, 12(t0)
+    add   s9, s9, a2              # S += column sum
+    add   s10, s10, a3
+    sub   a2, a2, a1              # col[x] = column sum - top pixel (for the next row)
+    sub   a3, a3, t6
+    sw    a2, 0(t0)
+    sw    a3, 4(t0)
+    addi  t0, t0, 16
+    addi  t1, t1, 4
+    addi  t2, t2, 4
+    bne   t0, a5, .Pro
+
+    # Columns kernel_size - 1 .. width - 1: one output pixel each
+.Main:
+    lw    a0, 0(t1)               # a0 = new bottom pixel
+    lw    a1, 0(t2)               # a1 = old top pixel
+    lw    a2, 0(t0)               # a2 = col[x] (B, R)
+    lw    a3, 4(t0)               # a3 = col[x] (G, A)
+    lw    a7, 8(a6)               # a7 = column sum K columns to the left (B, R)
+    lw    s0, 12(a6)              # s0 = column sum K columns to the left (G, A)
+    lw    s1, 0(t3)               # s1 = center pixel
+    srli  t5, a0, 8
+    and   a0, a0, s5
+    and   t5, t5, s5
+    srli  t6, a1, 8
+    and   a1, a1, s5
+    and   t6, t6, s5
+    add   a2, a2, a0              # a2, a3 = column sum of the window
+    add   a3, a3, t5
+    sw    a2, 8(t0)
+    sw    a3, 12(t0)
+    add   s9, s9, a2              # S += column sum
+    add   s10, s10, a3
+    sub   a2, a2, a1              # col[x] = column sum - top pixel (for the next row)
+    sub   a3, a3, t6
+    sw    a2, 0(t0)
+    sw    a3, 4(t0)
+    sub   s9, s9, a7              # S -= column sum K columns to the left
+    sub   s10, s10, s0
+    srli  t5, s1, 8
+    and   s1, s1, s5
+    and   t5, t5, s5
+    mul   a0, s9, s3              # a0 = k * S + (c - k) * center (B, R)
+    mul   a1, s10, s3             # a1 = k * S + (c - k) * center (G, A)
+    mul   s1, s1, s4
+    mul   t5, t5, s4
+    add   a0, a0, s1
+    add   a1, a1, t5
+    srli  a0, a0, 8               # a0 = a0 >> 8 (B, R)
+    and   a0, a0, s5
+    and   a1, a1, s8              # a1 = (a1 >> 8) << 8 (G, A)
+    or    a0, a0, a1
+    sw    a0, 0(t4)               # blurred.data[h][x - kernel_size + 1] = a0
+    addi  t0, t0, 16
+    addi  a6, a6, 16
+    addi  t1, t1, 4
+    addi  t2, t2, 4
+    addi  t3, t3, 4
+    addi  t4, t4, 4
+    bne   t0, a4, .Main
+
+    add   t3, t3, s7              # t3 = center of the first window of the next row
+    addi  s11, s11, -1
+    bnez  s11, .Row
+
+    # Release the column buffer and restore callee-saved registers
+    mv    sp, a4
+    lw    s0, 0(sp)
+    lw    s1, 4(sp)
+    lw    s2, 8(sp)
+    lw    s3, 12(sp)
+    lw    s4, 16(sp)
+    lw    s5, 20(sp)
+    lw    s6, 24(sp)
+    lw    s7, 28(sp)
+    lw    s8, 32(sp)
+    lw    s9, 36(sp)
+    lw    s10, 40(sp)
+    lw    s11, 44(sp)
+    addi  sp, sp, 48
+
+    mv    a0, x0                  # move x0 to a0
+    ret
+
+.ChannelError:
+    li    a0, -2
+    ret
+
+.SizeError:
+    li    a0, -3
+    ret
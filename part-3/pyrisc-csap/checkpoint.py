@@ -0,0 +1,74 @@
+#==========================================================================
+#
+#   The PyRISC Project
+#
+#   SNURISC5: A 5-stage Pipelined RISC-V ISA Simulator
+#
+#   Checkpoints of the architectural state
+#
+#   A checkpoint holds the pc, the register file (with the vector
+#   registers), and the contents of the data memory (zlib-compressed).
+#   The instruction memory is not saved;
+#   a checkpoint must be restored with the executable file it was taken
+#   from, which is verified with a CRC of the instruction memory.
+#
+#==========================================================================
+
+
+import struct
+import zlib
+
+from consts import *
+
+
+CKPT_MAGIC      = b'SNURISC5'
+CKPT_VERSION    = 2
+
+# magic, version, pc, imem CRC, dmem start, dmem size, registers, vector registers
+CKPT_HEADER     = '<8sIIIII%dI%dQ' % (NUM_REGS, NUM_VREGS)
+
+
+#--------------------------------------------------------------------------
+#   Checkpoint: saves and restores the architectural state
+#--------------------------------------------------------------------------
+
+class Checkpoint(object):
+
+    @staticmethod
+    def save(cpu, pc, filename):
+        dmem = cpu.dmem
+        header = struct.pack(CKPT_HEADER, CKPT_MAGIC, CKPT_VERSION, int(pc), zlib.crc32(cpu.imem.mem),
+                             int(dmem.mem_start), len(dmem.mem), *[ int(r) for r in cpu.rf.reg ], *[ int(v) for v in cpu.rf.vreg ])
+        with open(filename, 'wb') as f:
+            f.write(header)
+            f.write(zlib.compress(dmem.mem, 1))
+        print("Checkpoint at 0x%08x saved to %s" % (pc, filename))
+
+    @staticmethod
+    def restore(cpu, filename):
+        with open(filename, 'rb') as f:
+            data = f.read()
+
+        size = struct.calcsize(CKPT_HEADER)
+        fields = struct.unpack(CKPT_HEADER, data[:size]) if len(data) >= size else None
+        if fields is None or fields[0] != CKPT_MAGIC or fields[1] != CKPT_VERSION:
+            raise ValueError(f"{filename} is not a checkpoint of this simulator version")
+        magic, version, pc, crc, dmem_start, dmem_size = fields[:6]
+        if crc != zlib.crc32(cpu.imem.mem):
+            raise ValueError(f"Checkpoint {filename} was taken from a different executable file")
+        if dmem_start != cpu.dmem.mem_start or dmem_size != len(cpu.dmem.mem):
+            raise ValueError(f"Checkpoint {filename} requires data memory {dmem_start:08x} - "
+                             f"{dmem_start+dmem_size-1:08x}")
+
+        # dmem.mem is exported as word views (memoryview), so it cannot be resized
+        contents = zlib.decompress(data[size:])
+        if len(contents) != len(cpu.dmem.mem):
+            raise ValueError(f"Checkpoint {filename} is corrupt: {len(contents)} bytes of data "
+                             f"memory, expected {len(cpu.dmem.mem)}")
+        cpu.dmem.mem[:] = contents
+        for i in range(1, NUM_REGS):
+            cpu.rf.reg[i] = WORD(fields[6 + i])
+        for i in range(NUM_VREGS):
+            cpu.rf.vreg[i] = DWORD(fields[6 + NUM_REGS + i])
+        print("Checkpoint at 0x%08x restored from %s" % (pc, filename))
+        return WORD(pc)
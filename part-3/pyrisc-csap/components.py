@@ -14,6 +14,9 @@
 #==========================================================================
 
 
+import struct
+import sys
+
 from consts import *
 from isa import *
 
@@ -22,6 +25,14 @@ from isa import *
 #   Constants
 #--------------------------------------------------------------------------
 
+# One-pixel ALU op applied to each half by the two-pixel ALU ops
+SV2_ALU = {
+            ALU_SVUNPACK2 : ALU_SVUNPACK,   ALU_SVPACK2   : ALU_SVPACK,
+            ALU_SVBRDCST2 : ALU_SVBRDCST,   ALU_SVADD2    : ALU_SVADD,
+            ALU_SVSUB2    : ALU_SVSUB,      ALU_SVMUL2    : ALU_SVMUL,
+            ALU_SVMAC2    : ALU_SVMAC,      ALU_SVLERP2   : ALU_SVLERP,
+        }
+
 # Symbolic register names
 rname =  [ 
             'zero', 'ra',  'sp',  'gp',  'tp',  't0',  't1',  't2',
@@ -33,12 +44,14 @@ rname =  [
 
 #--------------------------------------------------------------------------
 #   RegisterFile: models 32-bit RISC-V register file
+#   (and the 64-bit vector registers v0-v31 as register numbers VREG + n)
 #--------------------------------------------------------------------------
 
 class RegisterFile(object):
 
     def __init__(self):
         self.reg = WORD([0] * NUM_REGS)
+        self.vreg = DWORD([0] * NUM_VREGS)
 
     def read(self, regno):
 
@@ -46,6 +59,8 @@ class RegisterFile(object):
             return 0
         elif regno > 0 and regno < NUM_REGS:
             return self.reg[regno]
+        elif regno >= VREG and regno < VREG + NUM_VREGS:
+            return self.vreg[regno - VREG]
         else:
             raise ValueError
 
@@ -55,6 +70,8 @@ class RegisterFile(object):
             return
         elif regno > 0 and regno < NUM_REGS:
             self.reg[regno] = WORD(value)
+        elif regno >= VREG and regno < VREG + NUM_VREGS:
+            self.vreg[regno - VREG] = DWORD(value)
         else:
             raise ValueError
 
@@ -70,6 +87,15 @@ class RegisterFile(object):
                 str += "%-11s0x%08x    " % ("%s ($%d):" % (name, r), val)
             print(str)
 
+        # Vector registers are shown only if a two-pixel instruction used them
+        if self.vreg.any():
+            print("")
+            for c in range (0, NUM_VREGS, columns // 2):
+                str = ""
+                for r in range (c, min(NUM_VREGS, c + columns // 2)):
+                    str += "%-11s0x%016x    " % ("v%d:" % r, self.vreg[r])
+                print(str)
+
         print("")
 
 
@@ -95,48 +121,60 @@ class Register(object):
 
 class Memory(object):
 
+    # Words are read and written through a memoryview of the memory cast to
+    # 32-bit integers (on little-endian hosts) or with struct otherwise;
+    # addresses are converted to int first, as arithmetic on numpy scalars
+    # is much slower.
+
     def __init__(self, mem_start, mem_size, word_size):
         self.word_size  = word_size
         self.mem_start  = mem_start
         self.mem_end    = mem_start + mem_size
         self.mem        = bytearray(mem_size)
+        self.words      = memoryview(self.mem).cast('I') \
+                          if word_size == 4 and sys.byteorder == 'little' else None
+        self.word       = struct.Struct('<I' if word_size == 4 else '<Q')
 
     def access(self, valid, addr, data, fcn):
+        offset = int(addr) - self.mem_start
         if (not valid):
             res = ( WORD(0), True )
-        elif (addr < self.mem_start) or (addr >= self.mem_end) or \
-            addr % self.word_size != 0:
+        elif (offset < 0) or (offset >= len(self.mem)) or \
+            offset % self.word_size != 0:
             res = ( WORD(0) , False )
         elif fcn == M_XRD:
-            offset = addr - self.mem_start
-            val = int.from_bytes(self.mem[offset:offset+self.word_size], 'little')
+            if self.words:
+                val = self.words[offset >> 2]
+            else:
+                val = self.word.unpack_from(self.mem, offset)[0]
             res = ( WORD(val), True )
         elif fcn == M_XWR:
-            data = int(data)
-            offset = addr - self.mem_start
-            self.mem[offset:offset+self.word_size] = data.to_bytes(self.word_size, 'little')
+            if self.words:
+                self.words[offset >> 2] = int(data)
+            else:
+                self.word.pack_into(self.mem, offset, int(data))
             res = ( WORD(0), True )
         else:
             res = ( WORD(0), False )
 
         return res
 
-    def copy_to(self, addr, data):
-        if (addr < self.mem_start) or (addr + len(data) > self.mem_end):
-            raise Exception(f"Cannot copy data into memory: invalid address {addr:08x} - {addr+len(data):08x}")
-
-        offset = addr - self.mem_start
-        self.mem[offset:offset+len(data)] = data
-
-    def copy_from(self, addr, nbytes):
+    def access_dword(self, valid, addr, data, fcn):
+        # 64-bit access for the two-pixel SV loads and stores (8-byte aligned)
+        if valid and int(addr) % 8 != 0:
+            return ( DWORD(0), False )
+        data = int(data)
+        lo, status = self.access(valid, addr, data & 0xffffffff, fcn)
+        hi, _ = self.access(valid, int(addr) + 4, data >> 32, fcn)
+        return ( DWORD(int(lo) | (int(hi) << 32)), status )
+
+    def view(self, addr, nbytes):
+        # Returns a writable view of nbytes at addr (no copy)
         if (addr < self.mem_start) or (addr + nbytes > self.mem_end):
-            raise Exception(f"Cannot copy data from memory: invalid address {addr:08x} - {addr+len(data):08x}")
+            raise Exception(f"Invalid memory address range {addr:08x} - {addr+nbytes:08x}")
 
-        data = bytearray(nbytes)
         offset = addr - self.mem_start
-        data[0:nbytes] = self.mem[offset:offset+nbytes]
-
-        return data
+        return memoryview(self.mem)[offset:offset+nbytes]
 
     def dump(self, skipzero = False):
 
@@ -161,6 +199,173 @@ class Memory(object):
         print("")
 
 
+#--------------------------------------------------------------------------
+#   Cache: models the timing of a set-associative cache
+#--------------------------------------------------------------------------
+
+class Cache(object):
+
+    # The cache only keeps tags; data is always read from and written to
+    # the backing Memory. access() returns the number of extra cycles the
+    # access takes. Lines are replaced in LRU order.
+    #
+    # write_back = True:  write-back, write-allocate. A miss that evicts a
+    #                     dirty line costs another miss_penalty cycles.
+    # write_back = False: write-through, no-write-allocate. Stores are
+    #                     absorbed by a write buffer and never stall.
+
+    def __init__(self, size, assoc, line_size, write_back = True, miss_penalty = 20):
+        self.size           = size
+        self.assoc          = assoc
+        self.line_size      = line_size
+        self.write_back     = write_back
+        self.miss_penalty   = miss_penalty
+        self.nsets          = size // (assoc * line_size)
+        self.sets           = [ [] for _ in range(self.nsets) ]    # [ tag, dirty ], LRU first
+
+        self.reads          = 0         # number of loads
+        self.writes         = 0         # number of stores
+        self.hits           = 0         # number of hits
+        self.misses         = 0         # number of misses
+        self.evictions      = 0         # number of lines replaced
+        self.writebacks     = 0         # number of dirty lines written back
+
+    def access(self, addr, fcn, size = WORD_SIZE):
+        # An access that spans several lines (8-byte accesses with 4-byte
+        # lines) looks up each of them; the latencies add up.
+        first   = int(addr) // self.line_size
+        last    = (int(addr) + size - 1) // self.line_size
+        latency = 0
+        for line in range(first, last + 1):
+            latency += self.access_line(line, fcn)
+        return latency
+
+    def access_line(self, line, fcn):
+        ways    = self.sets[line % self.nsets]
+        tag     = line // self.nsets
+        write   = fcn == M_XWR
+
+        if write:
+            self.writes += 1
+        else:
+            self.reads += 1
+
+        for i in range(len(ways)):
+            if ways[i][0] == tag:
+                self.hits += 1
+                way = ways.pop(i)
+                way[1] = way[1] or (write and self.write_back)
+                ways.append(way)
+                return 0
+
+        self.misses += 1
+        if write and not self.write_back:
+            return 0
+
+        latency = self.miss_penalty
+        if len(ways) == self.assoc:
+            victim = ways.pop(0)
+            self.evictions += 1
+            if victim[1]:
+                self.writebacks += 1
+                latency += self.miss_penalty
+        ways.append([ tag, write ])
+        return latency
+
+    def show(self):
+        accesses = self.reads + self.writes
+        print("D-cache: %d bytes, %d-way, %d-byte lines, %s, miss penalty %d cycles" %
+              (self.size, self.assoc, self.line_size,
+               "write-back" if self.write_back else "write-through", self.miss_penalty))
+        print("  %d accesses (%d loads, %d stores), %d hits, %d misses (%.2f%%)" %
+              (accesses, self.reads, self.writes, self.hits, self.misses,
+               0.0 if accesses == 0 else self.misses * 100.0 / accesses))
+        print("  %d evictions, %d writebacks" % (self.evictions, self.writebacks))
+
+
+#--------------------------------------------------------------------------
+#   BranchPredictor: models a BTB and a branch direction predictor
+#--------------------------------------------------------------------------
+
+class BranchPredictor(object):
+
+    # The BTB is direct-mapped and tagged with the full PC. It holds the
+    # target and the branch type of every branch or jump seen in EX, so
+    # instructions that are not in the BTB are predicted not taken. On a
+    # BTB hit, jumps are always predicted taken and conditional branches
+    # are predicted by the direction predictor. The predictor and the
+    # global history are updated when the branch is resolved in EX.
+
+    def __init__(self, kind = BP_NONE, btb_entries = 64, bht_entries = 1024):
+        self.kind           = kind
+        self.btb_entries    = btb_entries
+        self.bht_entries    = bht_entries
+        self.btb            = [ None ] * btb_entries      # [ pc, target, br_type ]
+        self.bht            = [ 1 ] * bht_entries         # 2-bit counters, weakly not taken
+        self.ghr            = 0                           # global history (gshare)
+
+        self.branches       = 0         # number of conditional branches
+        self.br_miss        = 0         # number of mispredicted conditional branches
+        self.jumps          = 0         # number of jumps (jal, jalr)
+        self.jmp_miss       = 0         # number of mispredicted jumps
+        self.btb_miss       = 0         # number of taken branches/jumps not found in BTB
+
+    def index(self, pc):
+        if self.kind == BP_GSHARE:
+            return ((pc >> 2) ^ self.ghr) % self.bht_entries
+        return (pc >> 2) % self.bht_entries
+
+    def predict(self, pc):
+        pc = int(pc)
+        if self.kind == BP_NONE:
+            return False, 0
+        entry = self.btb[(pc >> 2) % self.btb_entries]
+        if entry is None or entry[0] != pc:
+            return False, 0
+        target, br_type = entry[1], entry[2]
+        if br_type in [ BR_J, BR_JR ]:
+            return True, target
+        if self.kind == BP_BTFN:
+            return target <= pc, target
+        return self.bht[self.index(pc)] >= 2, target
+
+    def update(self, pc, br_type, taken, target, mispredicted):
+        pc, target = int(pc), int(target)
+        if br_type in [ BR_J, BR_JR ]:
+            self.jumps += 1
+            self.jmp_miss += mispredicted
+        else:
+            self.branches += 1
+            self.br_miss += mispredicted
+        if self.kind == BP_NONE:
+            return
+
+        entry = self.btb[(pc >> 2) % self.btb_entries]
+        if taken and (entry is None or entry[0] != pc):
+            self.btb_miss += 1
+        if taken or (entry is not None and entry[0] == pc):
+            self.btb[(pc >> 2) % self.btb_entries] = [ pc, target, br_type ]
+
+        if br_type not in [ BR_J, BR_JR ]:
+            i = self.index(pc)
+            self.bht[i] = min(self.bht[i] + 1, 3) if taken else max(self.bht[i] - 1, 0)
+            if self.kind == BP_GSHARE:
+                self.ghr = ((self.ghr << 1) | taken) % self.bht_entries
+
+    def show(self):
+        print("Branch prediction: %s" % self.kind +
+              ("" if self.kind == BP_NONE else ", %d-entry BTB" % self.btb_entries) +
+              (", %d-entry BHT" % self.bht_entries if self.kind in [ BP_BIMODAL, BP_GSHARE ] else ""))
+        print("  %d conditional branches, %d mispredicted (accuracy %.2f%%)" %
+              (self.branches, self.br_miss,
+               100.0 if self.branches == 0 else (self.branches - self.br_miss) * 100.0 / self.branches))
+        print("  %d jumps, %d mispredicted (accuracy %.2f%%)" %
+              (self.jumps, self.jmp_miss,
+               100.0 if self.jumps == 0 else (self.jumps - self.jmp_miss) * 100.0 / self.jumps))
+        if self.kind != BP_NONE:
+            print("  %d BTB misses on taken branches/jumps" % self.btb_miss)
+
+
 #--------------------------------------------------------------------------
 #   ALU: models an ALU
 #--------------------------------------------------------------------------
@@ -170,7 +375,7 @@ class ALU(object):
     def __init__(self):
         pass
 
-    def op(self, alufun, alu1, alu2):
+    def op(self, alufun, alu1, alu2, alu3 = 0):
 
         np.seterr(all='ignore')
         if alufun == ALU_ADD:
@@ -217,11 +422,40 @@ class ALU(object):
         elif alufun == ALU_SVMUL: # when mul, multiply alu1 vector to alu2 vector
             ROUND = lambda c: (c >> 8) + 0 if (c&0xff) < 0x80 else (c >> 8) + 1 # ROUND function
             output = WORD((ROUND(((alu1 >> 20) & 0x3FF) * ((alu2 >> 20) & 0x3FF))) << 20 | (ROUND(((alu1 >> 10) & 0x3FF) * ((alu2 >> 10) & 0x3FF))) << 10 | ROUND((alu1 & 0x3FF) * (alu2 & 0x3FF)))
+        elif alufun == ALU_SVMAC: # when mac, multiply alu1 vector to alu2 vector and add alu3 vector
+            ROUND = lambda c: (c >> 8) + 0 if (c&0xff) < 0x80 else (c >> 8) + 1 # ROUND function
+            LANE = lambda v, s: (int(v) >> s) & 0x3ff
+            output = WORD(sum(((LANE(alu3, s) + ROUND(LANE(alu1, s) * LANE(alu2, s))) & 0x3ff) << s for s in [ 20, 10, 0 ]))
+        elif alufun == ALU_SVLERP: # when lerp, alu1 vector * alu3 weights + alu2 vector * (256 - alu3 weights)
+            ROUND = lambda c: (c >> 8) + 0 if (c&0xff) < 0x80 else (c >> 8) + 1 # ROUND function
+            LANE = lambda v, s: (int(v) >> s) & 0x3ff
+            output = WORD(sum(((ROUND(LANE(alu1, s) * LANE(alu3, s)) + ROUND(LANE(alu2, s) * ((0x100 - LANE(alu3, s)) & 0x3ff))) & 0x3ff) << s for s in [ 20, 10, 0 ]))
+        elif alufun == ALU_SVADDS: # when adds, add alu1 vector to alu2 vector, saturating each channel at 0x3ff
+            LANE = lambda v, s: (int(v) >> s) & 0x3ff
+            output = WORD(sum(min(LANE(alu1, s) + LANE(alu2, s), 0x3ff) << s for s in [ 20, 10, 0 ]))
+        elif alufun == ALU_SVSUBS: # when subs, sub alu2 vector from alu1 vector, saturating each channel at 0
+            LANE = lambda v, s: (int(v) >> s) & 0x3ff
+            output = WORD(sum(max(LANE(alu1, s) - LANE(alu2, s), 0) << s for s in [ 20, 10, 0 ]))
+        elif alufun == ALU_SVALPHA: # when alpha, broadcast the alpha (bits 31:24) of the ARGB value in alu1
+            output = self.op(ALU_SVBRDCST, alu1 >> 24, WORD(0))
+        elif alufun in SV2_ALU:
+            output = self.op2(alufun, alu1, alu2, alu3)
         else:
             output = WORD(0)
 
         return output
 
+    def op2(self, alufun, alu1, alu2, alu3):
+        # Two-pixel SV ops: the one-pixel op on each 32-bit half of the 64-bit vectors
+        alu1, alu2, alu3 = int(alu1), int(alu2), int(alu3)
+        if alufun == ALU_SVBRDCST2:     # both halves from the scalar in alu1
+            alu1 = (alu1 & 0xffffffff) * 0x100000001
+        elif alufun == ALU_SVPACK2:     # alpha from bits 31:24 of each half of alu2
+            alu2 = ((alu2 >> 24) & 0xff) | ((alu2 >> 56) << 32)
+        half = [ int(self.op(SV2_ALU[alufun], WORD((alu1 >> s) & 0xffffffff),
+                    WORD((alu2 >> s) & 0xffffffff), WORD((alu3 >> s) & 0xffffffff))) for s in [ 0, 32 ] ]
+        return DWORD(half[0] | (half[1] << 32))
+
 
 
 #--------------------------------------------------------------------------
@@ -22,6 +22,7 @@ import numpy as np
 
 WORD                = np.uint32
 SWORD               = np.int32
+DWORD               = np.uint64     # two-pixel vector registers
 
 BITWIDTH            = np.dtype(WORD).itemsize * 8
 
@@ -34,6 +35,8 @@ N                   = False
 
 WORD_SIZE           = 4
 NUM_REGS            = 32
+NUM_VREGS           = 32            # two-pixel vector registers v0 - v31
+VREG                = NUM_REGS      # register number of v0 in the register file and the pipeline
 
 BUBBLE              = WORD(0x00004033)      # Machine-generated NOP:  xor x0, x0, x0
 NOP                 = WORD(0x00000013)      # Software-generated NOP: addi zero, zero, 0
@@ -51,6 +54,8 @@ RS2_MASK            = WORD(0x01f00000)
 RS2_SHIFT           = 20
 FUNCT7_MASK         = WORD(0xfe000000)
 FUNCT7_SHIFT        = 25
+RS3_MASK            = WORD(0xf8000000)      # R4 type
+RS3_SHIFT           = 27
 
 
 #--------------------------------------------------------------------------
@@ -77,6 +82,18 @@ S_TYPE              = 6
 B_TYPE              = 7
 J_TYPE              = 8
 X_TYPE              = 9
+R4_TYPE             = 10    # R_TYPE with a third source register (rs3)
+R4S_TYPE            = 11    # R4_TYPE, but store instruction (rs2, rs3, (rs1))
+
+
+#--------------------------------------------------------------------------
+#   Operands that name vector registers (two-pixel SV instructions)
+#--------------------------------------------------------------------------
+
+V_RD                = 1
+V_RS1               = 2
+V_RS2               = 4
+V_RS3               = 8
 
 
 #--------------------------------------------------------------------------
@@ -92,9 +109,20 @@ CL_CTRL             = 2
 #   PC select signal
 #--------------------------------------------------------------------------
 
-PC_4                = 0         # PC + 4
+PC_4                = 0         # PC + 4 (or the target predicted in IF)
 PC_BRJMP            = 1         # branch or jump target
 PC_JALR             = 2         # jump register target
+PC_EX4              = 3         # PC + 4 of the branch in EX (predicted taken, but not taken)
+
+
+#--------------------------------------------------------------------------
+#   Branch predictors
+#--------------------------------------------------------------------------
+
+BP_NONE             = 'none'    # always not taken
+BP_BTFN             = 'btfn'    # backward taken, forward not taken
+BP_BIMODAL          = 'bimodal' # 2-bit saturating counters indexed by PC
+BP_GSHARE           = 'gshare'  # 2-bit saturating counters indexed by PC xor global history
 
 
 #--------------------------------------------------------------------------
@@ -186,6 +214,21 @@ ALU_SVADDI          = 18
 ALU_SVADD           = 19
 ALU_SVSUB           = 20
 ALU_SVMUL           = 21
+ALU_SVMAC           = 22
+ALU_SVLERP          = 23
+# Two-pixel vector extensions (the operation above on each 32-bit half)
+ALU_SVUNPACK2       = 24
+ALU_SVPACK2         = 25
+ALU_SVBRDCST2       = 26
+ALU_SVADD2          = 27
+ALU_SVSUB2          = 28
+ALU_SVMUL2          = 29
+ALU_SVMAC2          = 30
+ALU_SVLERP2         = 31
+# Saturating and alpha-aware extensions
+ALU_SVADDS          = 32
+ALU_SVSUBS          = 33
+ALU_SVALPHA         = 34
 ALU_X               = 0
 
 
@@ -238,6 +281,13 @@ MT_D                = 4         # doubleword
 MT_BU               = 5         # byte (unsigned)
 MT_HU               = 6         # halfword (unsigned)
 MT_WU               = 7         # word (unsigned)
+# Custom vector extensions
+MT_VU               = 8         # word, unpacked to a vector on load
+MT_VA               = 9         # word, alpha broadcast to a vector on load
+MT_VP               = 10        # vector, packed to a word on store
+MT_VU2              = 11        # doubleword, two words unpacked to a vector on load
+MT_VA2              = 12        # doubleword, two alphas broadcast to a vector on load
+MT_VP2              = 13        # vector, packed to two words on store
 
 
 #--------------------------------------------------------------------------
@@ -76,6 +76,29 @@ csignals = {
     SVADD      : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVADD  , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
     SVSUB      : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVSUB  , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
     SVMUL      : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVMUL  , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVMAC      : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVMAC  , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVLERP     : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVLERP , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVLWU      : [ Y, BR_N  , OP1_RS1, OP2_IMI, OEN_1, OEN_0, ALU_ADD    , WB_MEM, REN_1, MEN_1, M_XRD, MT_VU, ],
+    SVLWA      : [ Y, BR_N  , OP1_RS1, OP2_IMI, OEN_1, OEN_0, ALU_ADD    , WB_MEM, REN_1, MEN_1, M_XRD, MT_VA, ],
+    SVSPK      : [ Y, BR_N  , OP1_RS1, OP2_X,   OEN_1, OEN_1, ALU_COPY1  , WB_X  , REN_0, MEN_1, M_XWR, MT_VP, ],
+    SVADDS     : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVADDS , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVSUBS     : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVSUBS , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVALPHA    : [ Y, BR_N  , OP1_RS1, OP2_X,   OEN_1, OEN_0, ALU_SVALPHA, WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+
+    # Two-pixel SV instructions on the 64-bit vector registers
+    SVUNPACK2  : [ Y, BR_N  , OP1_RS1, OP2_X,   OEN_1, OEN_0, ALU_SVUNPACK2, WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVPACK2    : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVPACK2  , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVBRDCST2  : [ Y, BR_N  , OP1_RS1, OP2_X,   OEN_1, OEN_0, ALU_SVBRDCST2, WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVADD2     : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVADD2   , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVSUB2     : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVSUB2   , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVMUL2     : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVMUL2   , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVMAC2     : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVMAC2   , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVLERP2    : [ Y, BR_N  , OP1_RS1, OP2_RS2, OEN_1, OEN_1, ALU_SVLERP2  , WB_ALU, REN_1, MEN_0, M_X  , MT_X, ],
+    SVLD       : [ Y, BR_N  , OP1_RS1, OP2_IMI, OEN_1, OEN_0, ALU_ADD      , WB_MEM, REN_1, MEN_1, M_XRD, MT_D, ],
+    SVLDU      : [ Y, BR_N  , OP1_RS1, OP2_IMI, OEN_1, OEN_0, ALU_ADD      , WB_MEM, REN_1, MEN_1, M_XRD, MT_VU2, ],
+    SVLDA      : [ Y, BR_N  , OP1_RS1, OP2_IMI, OEN_1, OEN_0, ALU_ADD      , WB_MEM, REN_1, MEN_1, M_XRD, MT_VA2, ],
+    SVSD       : [ Y, BR_N  , OP1_RS1, OP2_IMS, OEN_1, OEN_1, ALU_ADD      , WB_X  , REN_0, MEN_1, M_XWR, MT_D, ],
+    SVSDPK     : [ Y, BR_N  , OP1_RS1, OP2_X,   OEN_1, OEN_1, ALU_COPY1    , WB_X  , REN_0, MEN_1, M_XWR, MT_VP2, ],
 }
 
 
@@ -99,15 +122,19 @@ class Control(object):
         #   self.rf_wen             # Pipe.CTL.rf_wen
         #   self.fwd_op1            # Pipe.CTL.fwd_op1
         #   self.fwd_op2            # Pipe.CTL.fwd_op2
+        #   self.fwd_rs3            # Pipe.CTL.fwd_rs3
         #   self.imem_en            # Pipe.CTL.imem_en
         #   self.imem_rw            # Pipe.CTL.imem_rw
         #   self.dmem_en            # Pipe.CTL.dmem_en
         #   self.dmem_rw            # Pipe.CTL.dmem_rw
+        #   self.dmem_typ           # Pipe.CTL.dmem_typ
         #   self.IF_stall           # Pipe.CTL.IF_stall
         #   self.ID_stall           # Pipe.CTL.ID_stall
         #   self.ID_bubble          # Pipe.CTL.ID_bubble
         #   self.EX_bubble          # Pipe.CTL.EX_bubble
+        #   self.EX_stall           # Pipe.CTL.EX_stall
         #   self.MM_bubble          # Pipe.CTL.MM_bubble
+        #   self.MM_stall           # Pipe.CTL.MM_stall
         #
         #----------------------------------------------
 
@@ -132,7 +159,9 @@ class Control(object):
         self.ID_stall       = False
         self.ID_bubble      = False
         self.EX_bubble      = False
+        self.EX_stall       = False
         self.MM_bubble      = False
+        self.MM_stall       = False
 
         cs = csignals[opcode]
 
@@ -145,20 +174,36 @@ class Control(object):
 
         rs1_oen             = cs[CS_RS1_OEN]
         rs2_oen             = cs[CS_RS2_OEN]
+        rs3_oen             = isa[opcode][IN_TYPE] in [ R4_TYPE, R4S_TYPE ]
 
         self.dmem_en        = cs[CS_MEM_EN]
         self.dmem_rw        = cs[CS_MEM_FCN]
+        self.dmem_typ       = cs[CS_MSK_SEL]
+
+        # Resolve the branch/jump in EX
+        EX_taken            =   (EX.reg_c_br_type == BR_NE  and (not Pipe.EX.alu_out)) or    \
+                                (EX.reg_c_br_type == BR_EQ  and Pipe.EX.alu_out) or          \
+                                (EX.reg_c_br_type == BR_GE  and (not Pipe.EX.alu_out)) or    \
+                                (EX.reg_c_br_type == BR_GEU and (not Pipe.EX.alu_out)) or    \
+                                (EX.reg_c_br_type == BR_LT  and Pipe.EX.alu_out) or          \
+                                (EX.reg_c_br_type == BR_LTU and Pipe.EX.alu_out) or          \
+                                (EX.reg_c_br_type in [ BR_J, BR_JR ])
+        EX_target           =   Pipe.EX.jump_reg_target if EX.reg_c_br_type == BR_JR else Pipe.EX.brjmp_target
+
+        # Compare with the prediction made in IF
+        EX_mispredicted     =   (bool(EX_taken) != bool(EX.reg_pred_taken)) or  \
+                                (EX_taken and EX_target != EX.reg_pred_target)
 
         # Control signal to select the next PC
-        self.pc_sel         =   PC_BRJMP    if (EX.reg_c_br_type == BR_NE  and (not Pipe.EX.alu_out)) or    \
-                                               (EX.reg_c_br_type == BR_EQ  and Pipe.EX.alu_out) or          \
-                                               (EX.reg_c_br_type == BR_GE  and (not Pipe.EX.alu_out)) or    \
-                                               (EX.reg_c_br_type == BR_GEU and (not Pipe.EX.alu_out)) or    \
-                                               (EX.reg_c_br_type == BR_LT  and Pipe.EX.alu_out) or          \
-                                               (EX.reg_c_br_type == BR_LTU and Pipe.EX.alu_out) or          \
-                                               (EX.reg_c_br_type == BR_J) else                              \
-                                PC_JALR     if  EX.reg_c_br_type == BR_JR else                              \
-                                PC_4
+        # Only mispredicted branches/jumps redirect the fetch; otherwise IF follows its prediction
+        self.pc_sel         =   PC_4        if not EX_mispredicted else                              \
+                                PC_JALR     if EX_taken and EX.reg_c_br_type == BR_JR else          \
+                                PC_BRJMP    if EX_taken else                                        \
+                                PC_EX4
+
+        # Train the predictor once per branch/jump (EX does not advance during a D-cache stall)
+        if EX.reg_c_br_type != BR_N and not Pipe.MM.stall:
+            Pipe.cpu.bpred.update(EX.reg_pc, EX.reg_c_br_type, bool(EX_taken), EX_target, EX_mispredicted)
 
         # Control signal for forwarding rs1 value to op1_data
         # The c_rf_wen signal can be disabled when we have an exception during dmem access,
@@ -192,11 +237,21 @@ class Control(object):
                                                (WB.reg_rd != 0) and WB.reg_c_rf_wen  else   \
                                 FWD_NONE
 
+        # Control signal for forwarding rs3 value to rs3_data (R4 types only)
+        self.fwd_rs3        =   FWD_EX      if (EX.reg_rd == Pipe.ID.rs3) and rs3_oen and   \
+                                               (EX.reg_rd != 0) and EX.reg_c_rf_wen  else   \
+                                FWD_MM      if (MM.reg_rd == Pipe.ID.rs3) and rs3_oen and   \
+                                               (MM.reg_rd != 0) and Pipe.MM.c_rf_wen else   \
+                                FWD_WB      if (WB.reg_rd == Pipe.ID.rs3) and rs3_oen and   \
+                                               (WB.reg_rd != 0) and WB.reg_c_rf_wen  else   \
+                                FWD_NONE
+
         # Check for load-use data hazard
         EX_load_inst = EX.reg_c_dmem_en and EX.reg_c_dmem_rw == M_XRD
         load_use_hazard     = (EX_load_inst and EX.reg_rd != 0) and             \
                               ((EX.reg_rd == Pipe.ID.rs1 and rs1_oen) or        \
-                               (EX.reg_rd == Pipe.ID.rs2 and rs2_oen))
+                               (EX.reg_rd == Pipe.ID.rs2 and rs2_oen) or        \
+                               (EX.reg_rd == Pipe.ID.rs3 and rs3_oen))
 
         # Check for mispredicted branch/jump
         EX_brjmp            = self.pc_sel != PC_4
@@ -215,6 +270,18 @@ class Control(object):
         # safe to make the instruction and any following instructions bubble (except for EBREAK)
         self.MM_bubble = (Pipe.EX.exception and (Pipe.EX.exception != EXC_EBREAK)) or (Pipe.MM.exception)
 
+        # While MM waits for a D-cache miss, all the stages up to MM are frozen
+        # and a bubble is sent to WB. Branches and hazards in EX and ID are
+        # resolved after the stall is over.
+        if Pipe.MM.stall:
+            self.IF_stall   = True
+            self.ID_stall   = True
+            self.EX_stall   = True
+            self.MM_stall   = True
+            self.ID_bubble  = False
+            self.EX_bubble  = False
+            self.MM_bubble  = False
+
         if inst == BUBBLE:
             return False
         else:
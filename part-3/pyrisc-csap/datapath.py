@@ -55,10 +55,18 @@ class Pipe(object):
         Pipe.MM = stages[S_MM]
         Pipe.WB = stages[S_WB]
         Pipe.CTL = ctl
+        Pipe.profiler = None
+        Pipe.trace = False
 
     @staticmethod
     def run(entry_point):
         IF.reg_pc = entry_point
+
+        # Logging is decided once, so it costs nothing per cycle when disabled
+        Pipe.trace = Log.level >= 3
+        verbose = Log.level >= 4
+        klass = { }                 # instruction word -> instruction class
+
         while True:
             # Run each stage 
             # Should be run in the reverse order because forwarding and 
@@ -79,16 +87,21 @@ class Pipe(object):
             Stat.cycle      += 1
             if Pipe.WB.inst != BUBBLE:
                 Stat.icount += 1
-                opcode = RISCV.opcode(Pipe.WB.inst)
-                if isa[opcode][IN_CLASS] == CL_ALU:
+                c = klass.get(Pipe.WB.inst)
+                if c is None:
+                    c = klass[Pipe.WB.inst] = isa[RISCV.opcode(Pipe.WB.inst)][IN_CLASS]
+                if c == CL_ALU:
                     Stat.inst_alu += 1
-                elif isa[opcode][IN_CLASS] == CL_MEM:
+                elif c == CL_MEM:
                     Stat.inst_mem += 1
-                elif isa[opcode][IN_CLASS] == CL_CTRL:
+                elif c == CL_CTRL:
                     Stat.inst_ctrl += 1
 
+            if Pipe.profiler:
+                Pipe.profiler.sample(Pipe)
+
             # Show logs after executing a single instruction
-            if Stat.cycle >= Log.start_cycle:
+            if verbose and Stat.cycle >= Log.start_cycle:
                 if Log.level >= 6:
                     Pipe.cpu.rf.dump()                      # dump register file
                 if Log.level >= 7:
@@ -115,16 +128,16 @@ class Pipe(object):
         #    if Log.level > 1 and Log.level < 7:
         #        Pipe.cpu.dmem.dump(skipzero = True)     # dump dmem
 
-    # This function is called by each stage after updating its states
+    # This function is called by each stage after updating its states if Pipe.trace is set.
+    # info is the log() method of the stage; it is only evaluated at log level 5 and higher.
     @staticmethod
     def log(stage, pc, inst, info):
 
         if Stat.cycle < Log.start_cycle:
             return
-        if Log.level < 5:
-            info = ''
         if Log.level >= 4 or (Log.level == 3 and stage == S_WB):
-            print("%d [%s] 0x%08x: %-30s%-s" % (Stat.cycle, S[stage], pc, Program.disasm(pc, inst), info))
+            print("%d [%s] 0x%08x: %-30s%-s" % (Stat.cycle, S[stage], pc, Program.disasm(pc, inst),
+                                               info() if Log.level >= 5 else ''))
         else:
             return
 
@@ -152,6 +165,8 @@ class IF(Pipe):
         #   self.exception          # Pipe.IF.exception
         #   self.pc_next            # Pipe.IF.pc_next
         #   self.pcplus4            # Pipe.IF.pcplus4
+        #   self.pred_taken         # Pipe.IF.pred_taken
+        #   self.pred_target        # Pipe.IF.pred_target
         #
         #----------------------------------------------
 
@@ -173,10 +188,16 @@ class IF(Pipe):
         # Compute PC + 4 using an adder
         self.pcplus4 = Pipe.cpu.adder_pcplus4.op(self.pc, 4)
 
+        # Predict the next PC using the BTB and the branch predictor
+        self.pred_taken, self.pred_target = Pipe.cpu.bpred.predict(self.pc)
+        self.pred_target = WORD(self.pred_target)
+
         # Select next PC
-        self.pc_next =  self.pcplus4            if Pipe.CTL.pc_sel == PC_4      else \
+        self.pc_next =  self.pred_target        if Pipe.CTL.pc_sel == PC_4 and self.pred_taken else \
+                        self.pcplus4            if Pipe.CTL.pc_sel == PC_4      else \
                         Pipe.EX.brjmp_target    if Pipe.CTL.pc_sel == PC_BRJMP  else \
                         Pipe.EX.jump_reg_target if Pipe.CTL.pc_sel == PC_JALR   else \
+                        Pipe.EX.pcplus4         if Pipe.CTL.pc_sel == PC_EX4    else \
                         WORD(0)                 
 
 
@@ -194,15 +215,20 @@ class IF(Pipe):
             ID.reg_inst         = WORD(BUBBLE)
             ID.reg_exception    = WORD(EXC_NONE)
             ID.reg_pcplus4      = WORD(0)
+            ID.reg_pred_taken   = False
+            ID.reg_pred_target  = WORD(0)
         elif not Pipe.CTL.ID_stall:
             ID.reg_pc           = self.pc
             ID.reg_inst         = self.inst
             ID.reg_exception    = self.exception
             ID.reg_pcplus4      = self.pcplus4
+            ID.reg_pred_taken   = self.pred_taken
+            ID.reg_pred_target  = self.pred_target
         else:               # Pipe.CTL.ID_stall
             pass            # Do not update
 
-        Pipe.log(S_IF, self.pc, self.inst, self.log())
+        if Pipe.trace:
+            Pipe.log(S_IF, self.pc, self.inst, self.log)
 
     def log(self):
         return ("# inst=0x%08x, pc_next=0x%08x" % (self.inst, self.pc_next))
@@ -221,6 +247,8 @@ class ID(Pipe):
     reg_inst        = WORD(BUBBLE)      # ID.reg_inst
     reg_exception   = WORD(EXC_NONE)    # ID.reg_exception
     reg_pcplus4     = WORD(0)           # ID.reg_pcplus4
+    reg_pred_taken  = False             # ID.reg_pred_taken
+    reg_pred_target = WORD(0)           # ID.reg_pred_target
 
     #--------------------------------------------------
 
@@ -234,13 +262,17 @@ class ID(Pipe):
         #   self.inst               # Pipe.ID.inst
         #   self.exception          # Pipe.ID.exception
         #   self.pcplus4            # Pipe.ID.pcplus4
+        #   self.pred_taken         # Pipe.ID.pred_taken
+        #   self.pred_target        # Pipe.ID.pred_target
         #
         #   self.rs1                # Pipe.ID.rs1
         #   self.rs2                # Pipe.ID.rs2
+        #   self.rs3                # Pipe.ID.rs3
         #   self.rd                 # Pipe.ID.rd
         #   self.op1_data           # Pipe.ID.op1_data
         #   self.op2_data           # Pipe.ID.op2_data
         #   self.rs2_data           # Pipe.ID.rs2_data
+        #   self.rs3_data           # Pipe.ID.rs3_data
         #
         #----------------------------------------------
 
@@ -252,13 +284,25 @@ class ID(Pipe):
         self.inst       = ID.reg_inst
         self.exception  = ID.reg_exception
         self.pcplus4    = ID.reg_pcplus4
+        self.pred_taken = ID.reg_pred_taken
+        self.pred_target = ID.reg_pred_target
 
         self.rs1        = RISCV.rs1(self.inst)          # for CTL (forwarding check)
         self.rs2        = RISCV.rs2(self.inst)          # for CTL (forwarding check)
+        self.rs3        = RISCV.rs3(self.inst)          # for CTL (forwarding check)
         self.rd         = RISCV.rd(self.inst)
 
+        # Two-pixel SV instructions name vector registers (VREG + n)
+        vregs           = RISCV.vregs(self.inst)
+        if vregs:
+            self.rs1   += VREG if vregs & V_RS1 else 0
+            self.rs2   += VREG if vregs & V_RS2 else 0
+            self.rs3   += VREG if vregs & V_RS3 else 0
+            self.rd    += VREG if vregs & V_RD else 0
+
         rf_rs1_data     = Pipe.cpu.rf.read(self.rs1)
         rf_rs2_data     = Pipe.cpu.rf.read(self.rs2)
+        rf_rs3_data     = Pipe.cpu.rf.read(self.rs3)
 
         imm_i           = RISCV.imm_i(self.inst)
         imm_s           = RISCV.imm_s(self.inst)
@@ -306,34 +350,48 @@ class ID(Pipe):
                         Pipe.WB.wbdata  if Pipe.CTL.fwd_rs2 == FWD_WB       else \
                         rf_rs2_data
 
+        # Get forwarded value for rs3 if necessary (R4 type only)
+        self.rs3_data = Pipe.EX.alu_out if Pipe.CTL.fwd_rs3 == FWD_EX       else \
+                        Pipe.MM.wbdata  if Pipe.CTL.fwd_rs3 == FWD_MM       else \
+                        Pipe.WB.wbdata  if Pipe.CTL.fwd_rs3 == FWD_WB       else \
+                        rf_rs3_data
 
-    def update(self):
 
-        EX.reg_pc                   = self.pc
+    def update(self):
 
-        if Pipe.CTL.EX_bubble:
+        if Pipe.CTL.EX_stall:
+            pass                    # Do not update
+        elif Pipe.CTL.EX_bubble:
+            EX.reg_pc               = self.pc
             EX.reg_inst             = WORD(BUBBLE)
             EX.reg_exception        = WORD(EXC_NONE)
             EX.reg_c_br_type        = WORD(BR_N)
             EX.reg_c_rf_wen         = False
             EX.reg_c_dmem_en        = False
+            EX.reg_pred_taken       = False
         else:
+            EX.reg_pc               = self.pc
             EX.reg_inst             = self.inst
             EX.reg_exception        = self.exception
             EX.reg_rd               = self.rd
             EX.reg_op1_data         = self.op1_data
             EX.reg_op2_data         = self.op2_data
             EX.reg_rs2_data         = self.rs2_data
+            EX.reg_rs3_data         = self.rs3_data
             EX.reg_c_br_type        = Pipe.CTL.br_type
             EX.reg_c_alu_fun        = Pipe.CTL.alu_fun
             EX.reg_c_wb_sel         = Pipe.CTL.wb_sel
             EX.reg_c_rf_wen         = Pipe.CTL.rf_wen
             EX.reg_c_dmem_en        = Pipe.CTL.dmem_en
             EX.reg_c_dmem_rw        = Pipe.CTL.dmem_rw
+            EX.reg_c_dmem_typ       = Pipe.CTL.dmem_typ
             EX.reg_pcplus4          = self.pcplus4
+            EX.reg_pred_taken       = self.pred_taken
+            EX.reg_pred_target      = self.pred_target
 
 
-        Pipe.log(S_ID, self.pc, self.inst, self.log())
+        if Pipe.trace:
+            Pipe.log(S_ID, self.pc, self.inst, self.log)
 
     def log(self):
         if self.inst in [ BUBBLE, ILLEGAL ]:
@@ -358,12 +416,16 @@ class EX(Pipe):
     reg_c_wb_sel        = WORD(WB_X)        # EX.reg_c_wb_sel
     reg_c_dmem_en       = False             # EX.reg_c_dmem_en
     reg_c_dmem_rw       = WORD(M_X)         # EX.reg_c_dmem_rw
+    reg_c_dmem_typ      = WORD(MT_X)        # EX.reg_c_dmem_typ
     reg_c_br_type       = WORD(BR_N)        # EX.reg_c_br_type
     reg_c_alu_fun       = WORD(ALU_X)       # EX.reg_c_alu_fun
     reg_op1_data        = WORD(0)           # EX.reg_op1_data
     reg_op2_data        = WORD(0)           # EX.reg_op2_data
     reg_rs2_data        = WORD(0)           # EX.reg_rs2_data
+    reg_rs3_data        = WORD(0)           # EX.reg_rs3_data
     reg_pcplus4         = WORD(0)           # EX.reg_pcplus4
+    reg_pred_taken      = False             # EX.reg_pred_taken
+    reg_pred_target     = WORD(0)           # EX.reg_pred_target
 
     #--------------------------------------------------
 
@@ -381,11 +443,13 @@ class EX(Pipe):
         #   self.c_wb_sel           # Pipe.EX.c_wb_sel
         #   self.c_dmem_en          # Pipe.EX.c_dmem_en
         #   self.c_dmem_rw          # Pipe.EX.c_dmem_fcn
+        #   self.c_dmem_typ         # Pipe.EX.c_dmem_typ
         #   self.c_br_type          # Pipe.EX.c_br_type
         #   self.c_alu_fun          # Pipe.EX.c_alu_fun
         #   self.op1_data           # Pipe.EX.op1_data
         #   self.op2_data           # Pipe.EX.op2_data
         #   self.rs2_data           # Pipe.EX.rs2_data
+        #   self.rs3_data           # Pipe.EX.rs3_data
         #   self.pcplus4            # Pipe.EX.pcplus4
         #
         #   self.alu2_data          # Pipe.EX.alu2_data
@@ -407,11 +471,13 @@ class EX(Pipe):
         self.c_wb_sel           = EX.reg_c_wb_sel
         self.c_dmem_en          = EX.reg_c_dmem_en
         self.c_dmem_rw          = EX.reg_c_dmem_rw
+        self.c_dmem_typ         = EX.reg_c_dmem_typ
         self.c_br_type          = EX.reg_c_br_type
         self.c_alu_fun          = EX.reg_c_alu_fun
         self.op1_data           = EX.reg_op1_data
         self.op2_data           = EX.reg_op2_data
         self.rs2_data           = EX.reg_rs2_data
+        self.rs3_data           = EX.reg_rs3_data
         self.pcplus4            = EX.reg_pcplus4
 
 
@@ -422,7 +488,7 @@ class EX(Pipe):
                           self.op2_data
 
         # Perform ALU operation
-        self.alu_out = Pipe.cpu.alu.op(self.c_alu_fun, self.op1_data, self.alu2_data)
+        self.alu_out = Pipe.cpu.alu.op(self.c_alu_fun, self.op1_data, self.alu2_data, self.rs3_data)
 
         # Adjust the output for jalr instruction (forwarded to IF)
         self.jump_reg_target    = self.alu_out & WORD(0xfffffffe) 
@@ -434,9 +500,20 @@ class EX(Pipe):
         if self.c_wb_sel == WB_PC4:                   
             self.alu_out        = self.pcplus4
 
+        # For svspk, pack the vector in rs2 with the alpha (bits 31:24) of rs3 before the store
+        if self.c_dmem_typ == MT_VP:
+            self.rs2_data       = Pipe.cpu.alu.op(ALU_SVPACK, self.rs2_data, self.rs3_data >> 24)
+        elif self.c_dmem_typ == MT_VP2:
+            self.rs2_data       = Pipe.cpu.alu.op(ALU_SVPACK2, self.rs2_data, self.rs3_data)
+
 
     def update(self):
 
+        if Pipe.CTL.MM_stall:
+            if Pipe.trace:
+                Pipe.log(S_EX, self.pc, self.inst, self.log)
+            return                  # Do not update
+
         MM.reg_pc                   = self.pc
         # Exception should not be cleared in MM even if MM_bubble is enabled.
         # Otherwise we will lose any exception status.
@@ -455,10 +532,12 @@ class EX(Pipe):
             MM.reg_c_wb_sel         = self.c_wb_sel
             MM.reg_c_dmem_en        = self.c_dmem_en
             MM.reg_c_dmem_rw        = self.c_dmem_rw
+            MM.reg_c_dmem_typ       = self.c_dmem_typ
             MM.reg_alu_out          = self.alu_out
             MM.reg_rs2_data         = self.rs2_data
 
-        Pipe.log(S_EX, self.pc, self.inst, self.log())
+        if Pipe.trace:
+            Pipe.log(S_EX, self.pc, self.inst, self.log)
 
 
     def log(self):
@@ -487,6 +566,19 @@ class EX(Pipe):
             ALU_SVADD       : f'# {self.alu_out:#010x} <- V.{self.op1_data:#010x} + V.{self.alu2_data:#010x}',
             ALU_SVSUB       : f'# {self.alu_out:#010x} <- V.{self.op1_data:#010x} - V.{self.alu2_data:#010x}',
             ALU_SVMUL       : f'# {self.alu_out:#010x} <- V.{self.op1_data:#010x} * V.{self.alu2_data:#010x}',
+            ALU_SVMAC       : f'# {self.alu_out:#010x} <- V.{self.rs3_data:#010x} + V.{self.op1_data:#010x} * V.{self.alu2_data:#010x}',
+            ALU_SVLERP      : f'# {self.alu_out:#010x} <- V.{self.op1_data:#010x} * W.{self.rs3_data:#010x} + V.{self.alu2_data:#010x} * (256 - W)',
+            ALU_SVADDS      : f'# {self.alu_out:#010x} <- V.{self.op1_data:#010x} +sat V.{self.alu2_data:#010x}',
+            ALU_SVSUBS      : f'# {self.alu_out:#010x} <- V.{self.op1_data:#010x} -sat V.{self.alu2_data:#010x}',
+            ALU_SVALPHA     : f'# {self.alu_out:#010x} <- broadcast alpha {self.op1_data:#010x}',
+            ALU_SVUNPACK2   : f'# {self.alu_out:#018x} <- vectorize2 {self.op1_data:#018x}',
+            ALU_SVPACK2     : f'# {self.alu_out:#018x} <- unpack2 {self.op1_data:#018x}',
+            ALU_SVBRDCST2   : f'# {self.alu_out:#018x} <- broadcast2 {self.op1_data:#010x}',
+            ALU_SVADD2      : f'# {self.alu_out:#018x} <- V2.{self.op1_data:#018x} + V2.{self.alu2_data:#018x}',
+            ALU_SVSUB2      : f'# {self.alu_out:#018x} <- V2.{self.op1_data:#018x} - V2.{self.alu2_data:#018x}',
+            ALU_SVMUL2      : f'# {self.alu_out:#018x} <- V2.{self.op1_data:#018x} * V2.{self.alu2_data:#018x}',
+            ALU_SVMAC2      : f'# {self.alu_out:#018x} <- V2.{self.rs3_data:#018x} + V2.{self.op1_data:#018x} * V2.{self.alu2_data:#018x}',
+            ALU_SVLERP2     : f'# {self.alu_out:#018x} <- V2.{self.op1_data:#018x} * W2.{self.rs3_data:#018x} + V2.{self.alu2_data:#018x} * (256 - W)',
         }
         return('# -' if self.inst == BUBBLE else ALU_OPS[self.c_alu_fun]);
 
@@ -507,8 +599,10 @@ class MM(Pipe):
     reg_c_wb_sel        = WORD(WB_X)        # MM.reg_c_wb_sel
     reg_c_dmem_en       = False             # MM.reg_c_dmem_en
     reg_c_dmem_rw       = WORD(M_X)         # MM.reg_c_dmem_rw
+    reg_c_dmem_typ      = WORD(MT_X)        # MM.reg_c_dmem_typ
     reg_alu_out         = WORD(0)           # MM.reg_alu_out
     reg_rs2_data        = WORD(0)           # MM.reg_rs2_data
+    reg_wait            = None              # MM.reg_wait (remaining D-cache miss cycles)
 
     #--------------------------------------------------
 
@@ -525,10 +619,13 @@ class MM(Pipe):
         #   self.c_wb_sel           # Pipe.MM.c_rf_wen
         #   self.c_dmem_en          # Pipe.MM.c_dmem_en
         #   self.c_dmem_rw          # Pipe.MM.c_dmem_rw
+        #   self.c_dmem_typ         # Pipe.MM.c_dmem_typ
         #   self.alu_out            # Pipe.MM.alu_out
         #   self.rs2_data           # Pipe.MM.rs2_data
         #
         #   self.wbdata             # Pipe.MM.wbdata
+        #   self.wait               # Pipe.MM.wait
+        #   self.stall              # Pipe.MM.stall
         #
         #----------------------------------------------
 
@@ -542,17 +639,42 @@ class MM(Pipe):
         self.c_wb_sel       = MM.reg_c_wb_sel
         self.c_dmem_en      = MM.reg_c_dmem_en
         self.c_dmem_rw      = MM.reg_c_dmem_rw
+        self.c_dmem_typ     = MM.reg_c_dmem_typ
         self.alu_out        = MM.reg_alu_out  
         self.rs2_data       = MM.reg_rs2_data 
 
         # Access data memory (dmem) if needed
-        mem_data, status = Pipe.cpu.dmem.access(self.c_dmem_en, self.alu_out, self.rs2_data, self.c_dmem_rw)
+        # (svld, svldu, svlda, svsd and svsdpk access two words at once)
+        if self.c_dmem_typ in [ MT_D, MT_VU2, MT_VA2, MT_VP2 ]:
+            mem_data, status = Pipe.cpu.dmem.access_dword(self.c_dmem_en, self.alu_out, self.rs2_data, self.c_dmem_rw)
+        else:
+            mem_data, status = Pipe.cpu.dmem.access(self.c_dmem_en, self.alu_out, self.rs2_data, self.c_dmem_rw)
 
         # Handle exception during dmem access
         if not status:
             self.exception |= EXC_DMEM_ERROR
             self.c_rf_wen   = False
 
+        # Look up the data cache when the access starts, and stall MM
+        # (and the stages behind it) until the miss has been serviced
+        self.wait           = 0
+        if Pipe.cpu.dcache and self.c_dmem_en and status:
+            size            = 8 if self.c_dmem_typ in [ MT_D, MT_VU2, MT_VA2, MT_VP2 ] else WORD_SIZE
+            self.wait       = Pipe.cpu.dcache.access(self.alu_out, self.c_dmem_rw, size) if MM.reg_wait is None else \
+                              MM.reg_wait
+        self.stall          = self.wait > 0
+
+        # For svlwu and svlwa, the loaded word is converted to a vector
+        if self.c_dmem_typ == MT_VU:
+            mem_data        = Pipe.cpu.alu.op(ALU_SVUNPACK, mem_data, WORD(0))
+        elif self.c_dmem_typ == MT_VA:
+            mem_data        = Pipe.cpu.alu.op(ALU_SVBRDCST, mem_data >> 24, WORD(0))
+        elif self.c_dmem_typ == MT_VU2:
+            mem_data        = Pipe.cpu.alu.op(ALU_SVUNPACK2, mem_data, WORD(0))
+        elif self.c_dmem_typ == MT_VA2:
+            mem_data        = DWORD(int(Pipe.cpu.alu.op(ALU_SVBRDCST, (int(mem_data) >> 24) & 0xff, WORD(0))) |
+                                    int(Pipe.cpu.alu.op(ALU_SVBRDCST, int(mem_data) >> 56, WORD(0))) << 32)
+
         # For load instruction, we need to store the value read from dmem
         self.wbdata         = mem_data          if self.c_wb_sel == WB_MEM  else \
                               self.alu_out  
@@ -560,18 +682,30 @@ class MM(Pipe):
 
     def update(self):
 
-        WB.reg_pc           = self.pc
-        WB.reg_inst         = self.inst
-        WB.reg_exception    = self.exception
-        WB.reg_rd           = self.rd
-        WB.reg_c_rf_wen     = self.c_rf_wen
-        WB.reg_wbdata       = self.wbdata
+        if self.stall:
+            MM.reg_wait         = self.wait - 1
+            WB.reg_pc           = self.pc
+            WB.reg_inst         = WORD(BUBBLE)
+            WB.reg_exception    = WORD(EXC_NONE)
+            WB.reg_c_rf_wen     = False
+            Stat.dmem_stall    += 1
+        else:
+            MM.reg_wait         = None
+            WB.reg_pc           = self.pc
+            WB.reg_inst         = self.inst
+            WB.reg_exception    = self.exception
+            WB.reg_rd           = self.rd
+            WB.reg_c_rf_wen     = self.c_rf_wen
+            WB.reg_wbdata       = self.wbdata
 
-        Pipe.log(S_MM, self.pc, self.inst, self.log())
+        if Pipe.trace:
+            Pipe.log(S_MM, self.pc, self.inst, self.log)
 
 
     def log(self):
-        if not self.c_dmem_en:
+        if self.stall:
+            return('# D-cache miss, %d cycle(s) left' % self.wait)
+        elif not self.c_dmem_en:
             return('# -')
         elif self.c_dmem_rw == M_XRD:
             return('# 0x%08x <- M[0x%08x]' % (self.wbdata, self.alu_out))
@@ -616,7 +750,8 @@ class WB(Pipe):
         if self.c_rf_wen:
             Pipe.cpu.rf.write(self.rd, self.wbdata)
 
-        Pipe.log(S_WB, self.pc, self.inst, self.log())
+        if Pipe.trace:
+            Pipe.log(S_WB, self.pc, self.inst, self.log)
 
         if (self.exception):
             return False
@@ -627,4 +762,5 @@ class WB(Pipe):
         if self.inst == BUBBLE or (not self.c_rf_wen):
             return('# -')
         else:
-            return('# R[%d] <- 0x%08x' % (self.rd, self.wbdata))
+            return('# V[%d] <- 0x%016x' % (self.rd - VREG, self.wbdata) if self.rd >= VREG else \
+                   '# R[%d] <- 0x%08x' % (self.rd, self.wbdata))
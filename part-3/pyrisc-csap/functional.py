@@ -0,0 +1,390 @@
+#==========================================================================
+#
+#   The PyRISC Project
+#
+#   SNURISC5: A 5-stage Pipelined RISC-V ISA Simulator
+#
+#   Functional (instruction-level) execution mode
+#
+#   Executes one instruction per step without modeling the pipeline.
+#   Each instruction is decoded once into a bound handler that is cached
+#   in a table indexed by its PC. Handlers operate on plain Python ints;
+#   the register file is copied back when the program terminates.
+#
+#   The functional mode also fast-forwards the pipelined mode: run() stops
+#   after a given number of instructions or when a given pc is reached,
+#   and returns the pc at which the simulation continues.
+#
+#==========================================================================
+
+
+import itertools
+
+from consts import *
+from isa import *
+from components import *
+from program import *
+from control import *
+
+
+MASK32      = 0xffffffff
+
+
+#--------------------------------------------------------------------------
+#   Integer ALU (Python ints, results masked to 32 bits)
+#--------------------------------------------------------------------------
+
+def sext(v):
+    return v - 0x100000000 if v & 0x80000000 else v
+
+INT_ALU = {
+    ALU_ADD     : lambda a, b: (a + b) & MASK32,
+    ALU_SUB     : lambda a, b: (a - b) & MASK32,
+    ALU_AND     : lambda a, b: a & b,
+    ALU_OR      : lambda a, b: a | b,
+    ALU_XOR     : lambda a, b: a ^ b,
+    ALU_SLT     : lambda a, b: 1 if sext(a) < sext(b) else 0,
+    ALU_SLTU    : lambda a, b: 1 if a < b else 0,
+    ALU_SLL     : lambda a, b: (a << (b & 0x1f)) & MASK32,
+    ALU_SRL     : lambda a, b: a >> (b & 0x1f),
+    ALU_SRA     : lambda a, b: (sext(a) >> (b & 0x1f)) & MASK32,
+    ALU_COPY1   : lambda a, b: a,
+    ALU_COPY2   : lambda a, b: b,
+    ALU_SEQ     : lambda a, b: 1 if a == b else 0,
+    ALU_MUL     : lambda a, b: (a * b) & MASK32,
+}
+
+
+class Stop(Exception):
+    # Raised by a handler to terminate the simulation
+    def __init__(self, exception, pc):
+        self.exception = exception
+        self.pc = pc
+
+
+#--------------------------------------------------------------------------
+#   Functional: functional simulator with a decoded-instruction cache
+#--------------------------------------------------------------------------
+
+class Functional(object):
+
+    def __init__(self, cpu, profiler = None):
+        self.cpu = cpu
+        self.profiler = profiler
+        self.r = [ int(v) for v in cpu.rf.reg ] + [ int(v) for v in cpu.rf.vreg ]
+        self.r[0] = 0
+
+        imem = cpu.imem
+        self.ibase = int(imem.mem_start)
+        self.table = [ None ] * (len(imem.mem) // WORD_SIZE)
+        self.count = [ 0 ] * len(self.table)
+        self.klass = [ None ] * len(self.table)
+        self.logged = 0
+
+        dmem = cpu.dmem
+        self.dbase = int(dmem.mem_start)
+        self.dsize = len(dmem.mem)
+        self.dwords = dmem.words
+
+
+    #----------------------------------------------------------------------
+    #   Decoder: builds the handler of the instruction at pc
+    #----------------------------------------------------------------------
+
+    def decode(self, pc, inst):
+        opcode = RISCV.opcode(inst)
+        if opcode == ILLEGAL:
+            def illegal(pc):
+                raise Stop(EXC_ILLEGAL_INST, pc)
+            return illegal, None
+
+        cs      = csignals[opcode]
+        r       = self.r
+        rd      = int(RISCV.rd(inst))
+        rs1     = int(RISCV.rs1(inst))
+        rs2     = int(RISCV.rs2(inst))
+        rs3     = int(RISCV.rs3(inst))
+        vregs   = RISCV.vregs(inst)             # vector registers are r[VREG + n]
+        if vregs:
+            rd  += VREG if vregs & V_RD else 0
+            rs1 += VREG if vregs & V_RS1 else 0
+            rs2 += VREG if vregs & V_RS2 else 0
+            rs3 += VREG if vregs & V_RS3 else 0
+        br_type = cs[CS_BR_TYPE]
+        alu_fun = cs[CS_ALU_FUN]
+        wb_sel  = cs[CS_WB_SEL]
+        rf_wen  = cs[CS_RF_WEN] and rd != 0
+
+        imm = { OP2_IMI: RISCV.imm_i, OP2_IMS: RISCV.imm_s, OP2_IMB: RISCV.imm_b,
+                OP2_IMU: RISCV.imm_u, OP2_IMJ: RISCV.imm_j }.get(cs[CS_OP2_SEL])
+        imm = int(imm(inst)) & MASK32 if imm else 0
+
+        if opcode in [ EBREAK, ECALL ]:
+            def ebreak(pc):
+                raise Stop(EXC_EBREAK, pc)
+            return ebreak, isa[opcode][IN_CLASS]
+
+        # Memory access
+        if cs[CS_MEM_EN]:
+            handler = self.decode_mem(cs[CS_MEM_FCN], cs[CS_MSK_SEL], rd if rf_wen else 0,
+                                      rs1, rs2, rs3, imm)
+            return handler, isa[opcode][IN_CLASS]
+
+        # Conditional branches
+        if br_type in [ BR_EQ, BR_NE, BR_LT, BR_GE, BR_LTU, BR_GEU ]:
+            target = (pc + imm) & MASK32
+            fallthrough = (pc + 4) & MASK32
+            taken = {
+                BR_EQ   : lambda a, b: a == b,
+                BR_NE   : lambda a, b: a != b,
+                BR_LT   : lambda a, b: sext(a) < sext(b),
+                BR_GE   : lambda a, b: sext(a) >= sext(b),
+                BR_LTU  : lambda a, b: a < b,
+                BR_GEU  : lambda a, b: a >= b,
+            }[br_type]
+            if br_type == BR_EQ:
+                def h(pc):
+                    return target if r[rs1] == r[rs2] else fallthrough
+            elif br_type == BR_NE:
+                def h(pc):
+                    return target if r[rs1] != r[rs2] else fallthrough
+            else:
+                def h(pc):
+                    return target if taken(r[rs1], r[rs2]) else fallthrough
+            return h, isa[opcode][IN_CLASS]
+
+        # Jumps
+        if br_type == BR_J:
+            target = (pc + imm) & MASK32
+            link = (pc + 4) & MASK32
+            def h(pc):
+                if rf_wen: r[rd] = link
+                return target
+            return h, isa[opcode][IN_CLASS]
+
+        if br_type == BR_JR:
+            link = (pc + 4) & MASK32
+            def h(pc):
+                target = (r[rs1] + imm) & 0xfffffffe
+                if rf_wen: r[rd] = link
+                return target
+            return h, isa[opcode][IN_CLASS]
+
+        # ALU operations
+        if not rf_wen:
+            def h(pc):
+                return pc + 4
+            return h, isa[opcode][IN_CLASS]
+
+        if cs[CS_OP1_SEL] == OP1_PC:
+            value = (pc + imm) & MASK32                         # auipc
+            def h(pc):
+                r[rd] = value
+                return pc + 4
+            return h, isa[opcode][IN_CLASS]
+
+        if alu_fun in SV2_ALU:
+            # Two-pixel SV ops: 64-bit values, not truncated to a WORD
+            alu = self.cpu.alu
+            def h(pc):
+                r[rd] = int(alu.op2(alu_fun, r[rs1], r[rs2], r[rs3]))
+                return pc + 4
+            return h, isa[opcode][IN_CLASS]
+
+        if isa[opcode][IN_TYPE] == R4_TYPE:
+            alu = self.cpu.alu
+            def h(pc):
+                r[rd] = int(alu.op(alu_fun, WORD(r[rs1]), WORD(r[rs2]), WORD(r[rs3])))
+                return pc + 4
+            return h, isa[opcode][IN_CLASS]
+
+        f = INT_ALU.get(alu_fun)
+        if f is None:
+            # Custom instructions: use the ALU model of the pipeline
+            alu = self.cpu.alu
+            f = lambda a, b: int(alu.op(alu_fun, WORD(a), WORD(b)))
+
+        if cs[CS_OP2_SEL] == OP2_RS2:
+            if alu_fun == ALU_ADD:
+                def h(pc):
+                    r[rd] = (r[rs1] + r[rs2]) & MASK32
+                    return pc + 4
+            else:
+                def h(pc):
+                    r[rd] = f(r[rs1], r[rs2])
+                    return pc + 4
+        elif alu_fun == ALU_COPY2:                              # lui
+            def h(pc):
+                r[rd] = imm
+                return pc + 4
+        elif alu_fun == ALU_ADD:
+            def h(pc):
+                r[rd] = (r[rs1] + imm) & MASK32
+                return pc + 4
+        else:
+            def h(pc):
+                r[rd] = f(r[rs1], imm)
+                return pc + 4
+
+        return h, isa[opcode][IN_CLASS]
+
+
+    def decode_mem(self, fcn, typ, rd, rs1, rs2, rs3, imm):
+        r       = self.r
+        dbase   = self.dbase
+        dsize   = self.dsize
+        dwords  = self.dwords
+        mem     = self.cpu.dmem.mem
+
+        # Conversions of the vector loads and stores (MT_VU, MT_VA, MT_VP)
+        alu     = self.cpu.alu
+        conv    = {
+            MT_VU   : lambda v: int(alu.op(ALU_SVUNPACK, WORD(v), WORD(0))),
+            MT_VA   : lambda v: int(alu.op(ALU_SVBRDCST, WORD(v >> 24), WORD(0))),
+            MT_VP   : lambda v: int(alu.op(ALU_SVPACK, WORD(v), WORD(r[rs3] >> 24))),
+            MT_VU2  : lambda v: int(alu.op2(ALU_SVUNPACK2, v, 0, 0)),
+            MT_VA2  : lambda v: int(alu.op(ALU_SVBRDCST, WORD((v >> 24) & 0xff), WORD(0))) |
+                                int(alu.op(ALU_SVBRDCST, WORD(v >> 56), WORD(0))) << 32,
+            MT_VP2  : lambda v: int(alu.op2(ALU_SVPACK2, v, r[rs3], 0)),
+        }.get(typ)
+
+        # Two-pixel SV loads and stores access 8-byte aligned doublewords
+        if typ in [ MT_D, MT_VU2, MT_VA2, MT_VP2 ]:
+            if fcn == M_XRD:
+                def h(pc):
+                    ofs = ((r[rs1] + imm) & MASK32) - dbase
+                    if ofs < 0 or ofs >= dsize or ofs & 7:
+                        raise Stop(EXC_DMEM_ERROR, pc)
+                    value = int.from_bytes(mem[ofs:ofs+8], 'little')
+                    if rd: r[rd] = conv(value) if conv else value
+                    return pc + 4
+            else:
+                def h(pc):
+                    ofs = ((r[rs1] + imm) & MASK32) - dbase
+                    if ofs < 0 or ofs >= dsize or ofs & 7:
+                        raise Stop(EXC_DMEM_ERROR, pc)
+                    value = conv(r[rs2]) if conv else r[rs2]
+                    mem[ofs:ofs+8] = value.to_bytes(8, 'little')
+                    return pc + 4
+            return h
+
+        if fcn == M_XRD:
+            def h(pc):
+                ofs = ((r[rs1] + imm) & MASK32) - dbase
+                if ofs < 0 or ofs >= dsize or ofs & 3:
+                    raise Stop(EXC_DMEM_ERROR, pc)
+                value = dwords[ofs >> 2] if dwords else int.from_bytes(mem[ofs:ofs+4], 'little')
+                if rd: r[rd] = conv(value) if conv else value
+                return pc + 4
+        else:
+            def h(pc):
+                ofs = ((r[rs1] + imm) & MASK32) - dbase
+                if ofs < 0 or ofs >= dsize or ofs & 3:
+                    raise Stop(EXC_DMEM_ERROR, pc)
+                value = conv(r[rs2]) if conv else r[rs2]
+                if dwords: dwords[ofs >> 2] = value
+                else: mem[ofs:ofs+4] = value.to_bytes(4, 'little')
+                return pc + 4
+        return h
+
+
+    #----------------------------------------------------------------------
+    #   Simulation loop
+    #----------------------------------------------------------------------
+
+    def run(self, entry_point, limit = None, stop_pc = None):
+        table   = self.table
+        count   = self.count
+        ibase   = self.ibase
+        n       = len(table)
+        trace   = Log.level >= 3 and limit is None and stop_pc is None
+        pc      = int(entry_point)
+
+        # Stopping at a pc costs nothing: its handler is replaced by one that stops
+        if stop_pc is not None and 0 <= stop_pc - ibase < n * WORD_SIZE and not stop_pc & 3:
+            def stop(pc):
+                raise Stop(EXC_NONE, pc)
+            table[(stop_pc - ibase) >> 2] = stop
+        steps = itertools.repeat(None) if limit is None else range(limit)
+
+        try:
+            for _ in steps:
+                i = (pc - ibase) >> 2
+                if i < 0 or i >= n or pc & 3:
+                    raise Stop(EXC_IMEM_ERROR, pc)
+                h = table[i]
+                if h is None:
+                    inst, status = self.cpu.imem.access(True, WORD(pc), 0, M_XRD)
+                    h, self.klass[i] = self.decode(pc, inst)
+                    table[i] = h
+                if trace:
+                    self.log(pc)
+                count[i] += 1
+                pc = h(pc)
+            exception = EXC_NONE
+        except Stop as stop:
+            exception, pc = stop.exception, stop.pc
+            if exception == EXC_NONE:
+                count[(pc - ibase) >> 2] -= 1       # stop_pc is not executed
+
+        # Fast-forward point reached: hand the architectural state over
+        if exception == EXC_NONE:
+            self.writeback()
+            name, ofs = Program.symbol(pc)
+            print("Fast-forwarded %d instructions to 0x%08x (%s+%d)" % (sum(count), pc, name, ofs))
+            return pc
+
+        Stat.functional = True
+        self.finish(exception, pc)
+        return None
+
+
+    def finish(self, exception, pc):
+        count   = self.count
+        ibase   = self.ibase
+        n       = len(self.table)
+
+        # Illegal instructions do not retire
+        if exception == EXC_ILLEGAL_INST:
+            count[(pc - ibase) >> 2] -= 1
+
+        # Collect statistics
+        for i in range(n):
+            if count[i]:
+                Stat.icount += count[i]
+                if self.klass[i] == CL_ALU:
+                    Stat.inst_alu += count[i]
+                elif self.klass[i] == CL_MEM:
+                    Stat.inst_mem += count[i]
+                elif self.klass[i] == CL_CTRL:
+                    Stat.inst_ctrl += count[i]
+
+        if self.profiler:
+            self.profiler.add_counts({ ibase + (i << 2) :
+                (self.cpu.imem.access(True, WORD(ibase + (i << 2)), 0, M_XRD)[0], count[i])
+                for i in range(n) if count[i] })
+
+        # Write back architectural state
+        self.writeback()
+
+        if exception == EXC_EBREAK:
+            print("Execution completed")
+        else:
+            print("Exception '%s' occurred at 0x%08x -- Program terminated" % (EXC_MSG[exception], pc))
+
+        if Log.level > 0:
+            self.cpu.rf.dump()
+
+
+    def writeback(self):
+        for i in range(1, NUM_REGS):
+            self.cpu.rf.reg[i] = WORD(self.r[i])
+        for i in range(NUM_VREGS):
+            self.cpu.rf.vreg[i] = DWORD(self.r[VREG + i])
+
+
+    def log(self, pc):
+        self.logged += 1
+        if self.logged > Log.start_cycle:
+            inst, status = self.cpu.imem.access(True, WORD(pc), 0, M_XRD)
+            print("%d 0x%08x: %-30s" % (self.logged - 1, pc, Program.disasm(pc, inst)))
@@ -72,12 +72,36 @@ SVADDI      = WORD(0b00000000000000000011000000001011)
 SVADD       = WORD(0b00000000000000000100000000001011)
 SVSUB       = WORD(0b00000000000000000101000000001011)
 SVMUL       = WORD(0b00000000000000000110000000001011)
+SVMAC       = WORD(0b00000000000000000111000000001011)
+SVLERP      = WORD(0b00000010000000000111000000001011)
+SVLWU       = WORD(0b00000000000000000000000000101011)
+SVLWA       = WORD(0b00000000000000000001000000101011)
+SVSPK       = WORD(0b00000000000000000010000000101011)
+SVADDS      = WORD(0b00000010000000000100000000001011)
+SVSUBS      = WORD(0b00000010000000000101000000001011)
+SVALPHA     = WORD(0b00000010000000000010000000001011)
+
+# Two-pixel vector extensions (custom-2: ALU, custom-3: memory)
+SVUNPACK2   = WORD(0b00000000000000000000000001011011)
+SVPACK2     = WORD(0b00000000000000000001000001011011)
+SVBRDCST2   = WORD(0b00000000000000000010000001011011)
+SVADD2      = WORD(0b00000000000000000100000001011011)
+SVSUB2      = WORD(0b00000000000000000101000001011011)
+SVMUL2      = WORD(0b00000000000000000110000001011011)
+SVMAC2      = WORD(0b00000000000000000111000001011011)
+SVLERP2     = WORD(0b00000010000000000111000001011011)
+SVLD        = WORD(0b00000000000000000000000001111011)
+SVLDU       = WORD(0b00000000000000000001000001111011)
+SVLDA       = WORD(0b00000000000000000010000001111011)
+SVSD        = WORD(0b00000000000000000011000001111011)
+SVSDPK      = WORD(0b00000000000000000100000001111011)
 
 #--------------------------------------------------------------------------
 #   Instruction masks
 #--------------------------------------------------------------------------
 
 R_MASK      = WORD(0b11111110000000000111000001111111)
+R4_MASK     = WORD(0b00000110000000000111000001111111)
 
 LW_MASK     = WORD(0b00000000000000000111000001111111)
 SW_MASK     = WORD(0b00000000000000000111000001111111)
@@ -130,6 +154,28 @@ SVADDI_MASK      = WORD(0b00000000000000000111000001111111)
 SVADD_MASK       = R_MASK
 SVSUB_MASK       = R_MASK
 SVMUL_MASK       = R_MASK
+SVMAC_MASK       = R4_MASK
+SVLERP_MASK      = R4_MASK
+SVLWU_MASK       = WORD(0b00000000000000000111000001111111)
+SVLWA_MASK       = WORD(0b00000000000000000111000001111111)
+SVSPK_MASK       = WORD(0b00000110000000000111111111111111)
+SVADDS_MASK      = R_MASK
+SVSUBS_MASK      = R_MASK
+SVALPHA_MASK     = SVBRDCST_MASK
+
+SVUNPACK2_MASK   = SVUNPACK_MASK
+SVPACK2_MASK     = R_MASK
+SVBRDCST2_MASK   = SVBRDCST_MASK
+SVADD2_MASK      = R_MASK
+SVSUB2_MASK      = R_MASK
+SVMUL2_MASK      = R_MASK
+SVMAC2_MASK      = R4_MASK
+SVLERP2_MASK     = R4_MASK
+SVLD_MASK        = WORD(0b00000000000000000111000001111111)
+SVLDU_MASK       = WORD(0b00000000000000000111000001111111)
+SVLDA_MASK       = WORD(0b00000000000000000111000001111111)
+SVSD_MASK        = WORD(0b00000000000000000111000001111111)
+SVSDPK_MASK      = SVSPK_MASK
 
 #--------------------------------------------------------------------------
 #   ISA table: for opcode matching, disassembly, and run-time stats
@@ -187,9 +233,51 @@ isa         = {
     SVADD      : [ "svadd",         SVADD_MASK,   R_TYPE,  CL_ALU,   ], 
     SVSUB      : [ "svsub",         SVSUB_MASK,   R_TYPE,  CL_ALU,   ], 
     SVMUL      : [ "svmul",         SVMUL_MASK,   R_TYPE,  CL_ALU,   ], 
+    SVMAC      : [ "svmac",         SVMAC_MASK,   R4_TYPE, CL_ALU,   ], 
+    SVLERP     : [ "svlerp",        SVLERP_MASK,  R4_TYPE, CL_ALU,   ], 
+    SVLWU      : [ "svlwu",         SVLWU_MASK,   IL_TYPE, CL_MEM,   ], 
+    SVLWA      : [ "svlwa",         SVLWA_MASK,   IL_TYPE, CL_MEM,   ], 
+    SVSPK      : [ "svspk",         SVSPK_MASK,   R4S_TYPE,CL_MEM,   ], 
+    SVADDS     : [ "svadds",        SVADDS_MASK,  R_TYPE,  CL_ALU,   ],
+    SVSUBS     : [ "svsubs",        SVSUBS_MASK,  R_TYPE,  CL_ALU,   ],
+    SVALPHA    : [ "svalpha",       SVALPHA_MASK, R_TYPE,  CL_ALU,   ],
+    SVUNPACK2  : [ "svunpack2",     SVUNPACK2_MASK,  R_TYPE,  CL_ALU,   ],
+    SVPACK2    : [ "svpack2",       SVPACK2_MASK,  R_TYPE,  CL_ALU,   ],
+    SVBRDCST2  : [ "svbrdcst2",     SVBRDCST2_MASK,  R_TYPE,  CL_ALU,   ],
+    SVADD2     : [ "svadd2",        SVADD2_MASK,  R_TYPE,  CL_ALU,   ],
+    SVSUB2     : [ "svsub2",        SVSUB2_MASK,  R_TYPE,  CL_ALU,   ],
+    SVMUL2     : [ "svmul2",        SVMUL2_MASK,  R_TYPE,  CL_ALU,   ],
+    SVMAC2     : [ "svmac2",        SVMAC2_MASK,  R4_TYPE, CL_ALU,   ],
+    SVLERP2    : [ "svlerp2",       SVLERP2_MASK, R4_TYPE, CL_ALU,   ],
+    SVLD       : [ "svld",          SVLD_MASK,    IL_TYPE, CL_MEM,   ],
+    SVLDU      : [ "svldu",         SVLDU_MASK,   IL_TYPE, CL_MEM,   ],
+    SVLDA      : [ "svlda",         SVLDA_MASK,   IL_TYPE, CL_MEM,   ],
+    SVSD       : [ "svsd",          SVSD_MASK,    S_TYPE,  CL_MEM,   ],
+    SVSDPK     : [ "svsdpk",        SVSDPK_MASK,  R4S_TYPE,CL_MEM,   ],
 }
 
 
+# Operands of the two-pixel instructions that name vector registers. Vector
+# register vN is register number VREG + N in the register file and the pipeline.
+vregs = {
+    SVUNPACK2  : V_RD | V_RS1,
+    SVPACK2    : V_RD | V_RS1 | V_RS2,
+    SVBRDCST2  : V_RD,
+    SVADD2     : V_RD | V_RS1 | V_RS2,
+    SVSUB2     : V_RD | V_RS1 | V_RS2,
+    SVMUL2     : V_RD | V_RS1 | V_RS2,
+    SVMAC2     : V_RD | V_RS1 | V_RS2 | V_RS3,
+    SVLERP2    : V_RD | V_RS1 | V_RS2 | V_RS3,
+    SVLD       : V_RD,
+    SVLDU      : V_RD,
+    SVLDA      : V_RD,
+    SVSD       : V_RS2,
+    SVSDPK     : V_RS2 | V_RS3,
+}
+
+VREG_OPCODES = [ 0b1011011, 0b1111011 ]     # custom-2, custom-3
+
+
 #--------------------------------------------------------------------------
 #   RISCV: decodes RISC-V instructions
 #--------------------------------------------------------------------------
@@ -212,6 +300,13 @@ class RISCV(object):
     def opcode_name(opcode):
         return isa[opcode][IN_NAME]
 
+    @staticmethod
+    def vregs(inst):
+        # Operands of inst that name vector registers (V_RD | V_RS1 | V_RS2 | V_RS3)
+        if (inst & OP_MASK) not in VREG_OPCODES:
+            return 0
+        return vregs.get(RISCV.opcode(inst), 0)
+
     @staticmethod
     def rs1(inst):
         return (inst & RS1_MASK) >> RS1_SHIFT
@@ -220,6 +315,10 @@ class RISCV(object):
     def rs2(inst):
         return (inst & RS2_MASK) >> RS2_SHIFT
 
+    @staticmethod
+    def rs3(inst):
+        return (inst & RS3_MASK) >> RS3_SHIFT
+
     @staticmethod
     def rd(inst):
         return (inst & RD_MASK) >> RD_SHIFT
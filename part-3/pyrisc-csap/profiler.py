@@ -0,0 +1,118 @@
+#==========================================================================
+#
+#   The PyRISC Project
+#
+#   SNURISC5: A 5-stage Pipelined RISC-V ISA Simulator
+#
+#   Per-PC execution profile
+#
+#   Every cycle is charged to one instruction: a retired instruction is
+#   charged one cycle, and cycles lost in the pipeline are charged to the
+#   instruction that caused them -- the consumer of a load-use hazard, the
+#   load/store that missed in the D-cache, and the mispredicted branch or
+#   jump (two cancelled instructions). The remaining cycles are pipeline
+#   fill and drain.
+#
+#==========================================================================
+
+
+from consts import *
+from isa import *
+from program import *
+
+
+#--------------------------------------------------------------------------
+#   Profiler: collects and reports per-PC statistics
+#--------------------------------------------------------------------------
+
+class Profiler(object):
+
+    def __init__(self, entry_point):
+        self.retired    = { }           # pc -> number of retired instructions
+        self.stall      = { }           # pc -> load-use stall cycles
+        self.dstall     = { }           # pc -> D-cache stall cycles
+        self.flush      = { }           # pc -> cycles lost to cancelled instructions
+        self.inst       = { }           # pc -> instruction word
+
+        # Shadow call stack for folded stacks, updated as instructions retire
+        self.stack      = [ Program.symbol(entry_point)[0] ]
+        self.folded     = { }           # ';'-joined call stack -> cycles
+        self.call       = False         # last retired instruction was a call
+        self.ret        = False         # last retired instruction was a return
+
+    # Called once per cycle (pipelined mode)
+    def sample(self, pipe):
+        ctl = pipe.CTL
+
+        if pipe.WB.inst != BUBBLE:
+            self.retire(pipe.WB.pc, pipe.WB.inst)
+
+        if pipe.MM.stall:
+            pc = int(pipe.MM.pc)
+            self.dstall[pc] = self.dstall.get(pc, 0) + 1
+        elif ctl.ID_stall:
+            pc = int(pipe.ID.pc)
+            self.stall[pc] = self.stall.get(pc, 0) + 1
+        elif ctl.ID_bubble:
+            pc = int(pipe.EX.pc)
+            self.flush[pc] = self.flush.get(pc, 0) + 2
+
+        key = ';'.join(self.stack)
+        self.folded[key] = self.folded.get(key, 0) + 1
+
+    def retire(self, pc, inst):
+        pc = int(pc)
+        if self.call:
+            self.stack.append(Program.symbol(pc)[0])
+        elif self.ret and len(self.stack) > 1:
+            self.stack.pop()
+
+        self.retired[pc] = self.retired.get(pc, 0) + 1
+        self.inst[pc] = inst
+
+        opcode = RISCV.opcode(inst)
+        self.call = opcode in [ JAL, JALR ] and RISCV.rd(inst) == 1
+        self.ret = opcode == JALR and RISCV.rd(inst) == 0 and RISCV.rs1(inst) == 1
+
+    # Called with the instruction counts of the functional mode
+    def add_counts(self, counts):
+        for pc, (inst, n) in counts.items():
+            self.retired[pc] = self.retired.get(pc, 0) + n
+            self.inst[pc] = inst
+            key = Program.symbol(pc)[0]
+            self.folded[key] = self.folded.get(key, 0) + n
+
+    def cost(self, pc):
+        return self.retired.get(pc, 0) + self.stall.get(pc, 0) + self.dstall.get(pc, 0) + self.flush.get(pc, 0)
+
+    def show(self, top = 20):
+        pcs = set(self.retired) | set(self.stall) | set(self.dstall) | set(self.flush)
+        total = sum(self.cost(pc) for pc in pcs)
+        pct = lambda n, t: 0.0 if t == 0 else n * 100.0 / t
+
+        print("Profile: %d cycles charged to instructions" % total +
+              ("" if Stat.functional else ", %d cycles of pipeline fill/drain" % (Stat.cycle - total)))
+        print("%-10s  %-22s %9s %7s %7s %7s %9s %7s  %s" %
+              ('pc', 'symbol', 'retired', 'stall', 'dstall', 'flush', 'cycles', '%', 'instruction'))
+        for pc in sorted(pcs, key = lambda pc: (-self.cost(pc), pc))[:top]:
+            name, ofs = Program.symbol(pc)
+            print("0x%08x  %-22s %9d %7d %7d %7d %9d %6.2f%%  %s" %
+                  (pc, "%s+%d" % (name, ofs), self.retired.get(pc, 0), self.stall.get(pc, 0),
+                   self.dstall.get(pc, 0), self.flush.get(pc, 0), self.cost(pc),
+                   pct(self.cost(pc), total), Program.disasm(pc, self.inst.get(pc, BUBBLE))))
+
+        funcs = { }
+        for pc in pcs:
+            f = funcs.setdefault(Program.symbol(pc)[0], [ 0, 0 ])
+            f[0] += self.retired.get(pc, 0)
+            f[1] += self.cost(pc)
+        print("")
+        print("%-22s %12s %12s %7s" % ('function', 'retired', 'cycles', '%'))
+        for name, (n, c) in sorted(funcs.items(), key = lambda f: -f[1][1]):
+            print("%-22s %12d %12d %6.2f%%" % (name, n, c, pct(c, total)))
+        print("")
+
+    def write_folded(self, filename):
+        with open(filename, 'w') as f:
+            for key, n in sorted(self.folded.items()):
+                f.write("%s %d\n" % (key, n))
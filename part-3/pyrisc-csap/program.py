@@ -13,6 +13,8 @@
 #
 #==========================================================================
 
+import bisect
+
 from elftools.elf import elffile as elf
 from consts import *
 from isa import *
@@ -59,6 +61,7 @@ class Program(object):
 
     def __init__(self):
         Program.asmcache = AsmCache()
+        Program.symbols = [ ]               # (address, name) of functions, sorted by address
 
 
     def check_elf(self, filename, header):
@@ -101,6 +104,18 @@ class Program(object):
 
             entry_point = WORD(efh['e_entry'])
 
+            # Collect function symbols for profiling
+            # Mapping symbols ($x, ...) and local labels (.L1, ...) are skipped
+            symtab = ef.get_section_by_name('.symtab')
+            if symtab:
+                syms = { }
+                for sym in symtab.iter_symbols():
+                    if sym['st_info']['type'] in [ 'STT_FUNC', 'STT_NOTYPE' ] and \
+                       sym.name and sym.name[0] not in '$.' and \
+                       sym['st_value'] >= cpu.imem.mem_start and sym['st_value'] < cpu.imem.mem_end:
+                        syms.setdefault(sym['st_value'], sym.name)
+                Program.symbols = sorted(syms.items())
+
             for seg in ef.iter_segments():
                 addr = seg.header['p_vaddr']
                 memsz = seg.header['p_memsz']
@@ -115,12 +130,26 @@ class Program(object):
                         % (addr, addr + memsz - 1))
                     continue
                 image = seg.data()
-                for i in range(0, len(image), WORD_SIZE):
-                    c = int.from_bytes(image[i:i+WORD_SIZE], byteorder='little')
-                    mem.access(True, addr, c, M_XWR)
-                    addr += WORD_SIZE
+                mem.view(addr, len(image))[:] = image
             return entry_point
 
+    @staticmethod
+    def symbol(pc):
+        # Returns the name of the function containing pc and the offset into it
+        i = bisect.bisect_right(Program.symbols, (int(pc), '\uffff')) - 1
+        if i < 0:
+            return '?', int(pc)
+        addr, name = Program.symbols[i]
+        return name, int(pc) - addr
+
+    @staticmethod
+    def address(name):
+        # Returns the address of the function name, or None if there is no such symbol
+        for addr, sym in Program.symbols:
+            if sym == name:
+                return addr
+        return None
+
     @staticmethod
     def disasm(pc, inst):
 
@@ -151,24 +180,36 @@ class Program(object):
         imm_b   = RISCV.imm_b(inst)
         imm_u   = RISCV.imm_u(inst)
         imm_j   = RISCV.imm_j(inst)
+
+        # Two-pixel SV instructions name vector registers (vN)
+        vregs   = RISCV.vregs(inst)
+        rdn     = "v%d" % rd if vregs & V_RD else rname[rd]
+        rs1n    = "v%d" % rs1 if vregs & V_RS1 else rname[rs1]
+        rs2n    = "v%d" % rs2 if vregs & V_RS2 else rname[rs2]
+        rs3n    = "v%d" % RISCV.rs3(inst) if vregs & V_RS3 else rname[RISCV.rs3(inst)]
+
         if info[IN_TYPE] == R_TYPE:
-            asm = "%-7s%s, %s, %s" % (opname, rname[rd], rname[rs1], rname[rs2])
+            asm = "%-10s%s, %s, %s" % (opname, rdn, rs1n, rs2n)
         elif info[IN_TYPE] == I_TYPE:
-            asm = "%-7s%s, %s, %d" % (opname, rname[rd], rname[rs1], SWORD(imm_i))
+            asm = "%-10s%s, %s, %d" % (opname, rname[rd], rname[rs1], SWORD(imm_i))
         elif info[IN_TYPE] == IL_TYPE:
-            asm = "%-7s%s, %d(%s)" % (opname, rname[rd], SWORD(imm_i), rname[rs1])
+            asm = "%-10s%s, %d(%s)" % (opname, rdn, SWORD(imm_i), rname[rs1])
         elif info[IN_TYPE] == IJ_TYPE:
-            asm = "%-7s%s, %s, %d" % (opname, rname[rd], rname[rs1], SWORD(imm_i))
+            asm = "%-10s%s, %s, %d" % (opname, rname[rd], rname[rs1], SWORD(imm_i))
         elif info[IN_TYPE] == IS_TYPE:
-            asm = "%-7s%s, %s, %d" % (opname, rname[rd], rname[rs1], SWORD(imm_i & 0x1f))
+            asm = "%-10s%s, %s, %d" % (opname, rname[rd], rname[rs1], SWORD(imm_i & 0x1f))
         elif info[IN_TYPE] == U_TYPE:
-            asm = "%-7s%s, 0x%05x" % (opname, rname[rd], imm_u)
+            asm = "%-10s%s, 0x%05x" % (opname, rname[rd], imm_u)
         elif info[IN_TYPE] == S_TYPE:
-            asm = "%-7s%s, %d(%s)" % (opname, rname[rs2], SWORD(imm_s), rname[rs1])
+            asm = "%-10s%s, %d(%s)" % (opname, rs2n, SWORD(imm_s), rname[rs1])
         elif info[IN_TYPE] == B_TYPE:
-            asm = "%-7s%s, %s, 0x%08x" % (opname, rname[rs1], rname[rs2], pc + SWORD(imm_b))
+            asm = "%-10s%s, %s, 0x%08x" % (opname, rname[rs1], rname[rs2], pc + SWORD(imm_b))
         elif info[IN_TYPE] == J_TYPE:
-            asm = "%-7s%s, 0x%08x" % (opname, rname[rd], pc + SWORD(imm_j))
+            asm = "%-10s%s, 0x%08x" % (opname, rname[rd], pc + SWORD(imm_j))
+        elif info[IN_TYPE] == R4_TYPE:
+            asm = "%-10s%s, %s, %s, %s" % (opname, rdn, rs1n, rs2n, rs3n)
+        elif info[IN_TYPE] == R4S_TYPE:
+            asm = "%-10s%s, %s, (%s)" % (opname, rs2n, rs3n, rname[rs1])
         elif info[IN_TYPE] == X_TYPE:
             return info[IN_NAME]
         else:
@@ -203,11 +244,28 @@ class Stat(object):
     inst_mem        = 0         # number of load/store instructions
     inst_ctrl       = 0         # number of control transfer instructions
 
+    functional      = False     # executed in functional mode (no cycle count)
+
+    dcache          = None      # data cache model, if configured
+    dmem_stall      = 0         # number of cycles stalled on D-cache misses
+    bpred           = None      # branch predictor, if other than always-not-taken
+    issue           = None      # multi-issue timing model, if configured
+
     @staticmethod
     def show():
-        print("%d instructions executed in %d cycles. CPI = %.3f" % (Stat.icount, Stat.cycle, 0.0 if Stat.icount == 0 else  Stat.cycle / Stat.icount))
+        if Stat.functional:
+            print("%d instructions executed (functional mode, no timing)" % Stat.icount)
+        else:
+            print("%d instructions executed in %d cycles. CPI = %.3f" % (Stat.icount, Stat.cycle, 0.0 if Stat.icount == 0 else  Stat.cycle / Stat.icount))
         print("Data transfer:    %d instructions (%.2f%%)" % (Stat.inst_mem, 0.0 if Stat.icount == 0 else Stat.inst_mem * 100.0 / Stat.icount))
         print("ALU operation:    %d instructions (%.2f%%)" % (Stat.inst_alu, 0.0 if Stat.icount == 0 else Stat.inst_alu * 100.0 / Stat.icount))
         print("Control transfer: %d instructions (%.2f%%)" % (Stat.inst_ctrl, 0.0 if Stat.icount == 0 else Stat.inst_ctrl * 100.0 / Stat.icount))
+        if Stat.dcache and not Stat.functional:
+            Stat.dcache.show()
+            print("  %d stall cycles (%.2f%% of all cycles)" % (Stat.dmem_stall, 0.0 if Stat.cycle == 0 else Stat.dmem_stall * 100.0 / Stat.cycle))
+        if Stat.bpred and not Stat.functional:
+            Stat.bpred.show()
+        if Stat.issue:
+            Stat.issue.show()
 
 
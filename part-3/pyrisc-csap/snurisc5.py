@@ -16,7 +16,9 @@
 #==========================================================================
 
 import argparse
+import os
 import sys
+import zlib
 
 from consts import *
 from isa import *
@@ -24,6 +26,10 @@ from components import *
 from program import *
 from datapath import *
 from control import *
+from functional import *
+from superscalar import *
+from profiler import *
+from checkpoint import *
 
 
 #--------------------------------------------------------------------------
@@ -39,6 +45,21 @@ IMEM_SIZE   = WORD(64 * 1024)
 DMEM_START  = WORD(0x80010000)      # DMEM: 0x80010000 - 0x8001ffff (64KB)
 DMEM_SIZE   = WORD(64 * 1024)
 
+# Data cache configurations (disabled by default: every access takes one cycle)
+DCACHE_SIZE     = 0                 # bytes
+DCACHE_ASSOC    = 2                 # ways
+DCACHE_LINE     = 32                # bytes
+DCACHE_POLICY   = 'wb'              # 'wb': write-back/write-allocate, 'wt': write-through/no-write-allocate
+DCACHE_PENALTY  = 20                # cycles
+
+# Branch predictor configurations (default: always not taken, no BTB)
+BPRED           = BP_NONE
+BTB_ENTRIES     = 64
+BHT_ENTRIES     = 1024
+
+# Issue width (1: pipelined mode, 2: in-order dual-issue timing model)
+ISSUE_WIDTH     = 1
+
 
 #--------------------------------------------------------------------------
 #   SNURISC5: Target machine to simulate
@@ -47,7 +68,11 @@ DMEM_SIZE   = WORD(64 * 1024)
 class SNURISC5(object):
 
     def __init__(self, imem_start=IMEM_START, imem_size=IMEM_SIZE,
-                       dmem_start=DMEM_START, dmem_size=DMEM_SIZE):
+                       dmem_start=DMEM_START, dmem_size=DMEM_SIZE,
+                       dcache_size=DCACHE_SIZE, dcache_assoc=DCACHE_ASSOC, dcache_line=DCACHE_LINE,
+                       dcache_policy=DCACHE_POLICY, dcache_penalty=DCACHE_PENALTY,
+                       bpred=BPRED, btb_entries=BTB_ENTRIES, bht_entries=BHT_ENTRIES,
+                       issue_width=ISSUE_WIDTH):
 
         stages = [ IF(), ID(), EX(), MM(), WB() ]
         self.ctl = Control()
@@ -57,20 +82,40 @@ class SNURISC5(object):
         self.alu = ALU()
         self.imem = Memory(imem_start, imem_size, WORD_SIZE)
         self.dmem = Memory(dmem_start, dmem_size, WORD_SIZE)
+        self.dcache = Cache(dcache_size, dcache_assoc, dcache_line,
+                            dcache_policy == 'wb', dcache_penalty) if dcache_size else None
+        Stat.dcache = self.dcache
+        self.bpred = BranchPredictor(bpred, btb_entries, bht_entries)
+        Stat.bpred = self.bpred if bpred != BP_NONE else None
         self.adder_brtarget = Adder()
         self.adder_pcplus4 = Adder()
+        self.issue_width = issue_width
 
         print(f"SnuRISC-V\n"
               f"  architecture:          {BITWIDTH} bit\n"
-              f"  pipeline stages:       {len(stages)}\n"
+              f"  pipeline stages:       {len(stages)}\n" +
+              (f"  issue width:           {issue_width} (in-order, one memory access per cycle)\n"
+               if issue_width > 1 else "") +
               f"\n"
               f"  instruction memory:    {imem_start:08x} - {imem_start+imem_size-1:08x}"
               f" ({imem_size} bytes)\n"
               f"  data memory:           {dmem_start:08x} - {dmem_start+dmem_size-1:08x}"
-              f" ({dmem_size} bytes)\n")
-
-    def run(self, entry_point):
-        Pipe.run(entry_point)
+              f" ({dmem_size} bytes)\n" +
+              (f"  data cache:            {dcache_size} bytes, {dcache_assoc}-way, {dcache_line}-byte lines,"
+               f" {'write-back' if dcache_policy == 'wb' else 'write-through'},"
+               f" miss penalty {dcache_penalty} cycles\n" if dcache_size else "") +
+              (f"  branch predictor:      {bpred}, {btb_entries}-entry BTB" +
+               (f", {bht_entries}-entry BHT" if bpred in [ BP_BIMODAL, BP_GSHARE ] else "") + "\n"
+               if bpred != BP_NONE else ""))
+
+    def run(self, entry_point, fast = False, profiler = None):
+        if fast:
+            Functional(self, profiler).run(entry_point)
+        elif self.issue_width > 1:
+            Superscalar(self, self.issue_width).run(entry_point)
+        else:
+            Pipe.profiler = profiler
+            Pipe.run(entry_point)
 
 
 #--------------------------------------------------------------------------
@@ -94,6 +139,24 @@ sets the desired log level (default: %(default)s)
  7: 6 + dumps data memory for each cycle''')
     parser.add_argument("--cycle", "-c", type=int, default=0,
         help="shows logs after cycle m (default: %(default)s, only effective for log level 3 or higher)")
+    parser.add_argument("--fast", "-f", action="store_true",
+        help="functional mode: execute one instruction per step without modeling the pipeline.\n"
+             "Much faster; reports the instruction count and mix but no cycles.\n"
+             "Log level 3 and higher show executed instructions (--cycle counts instructions).")
+    parser.add_argument("--profile", "-p", nargs="?", type=int, const=20, default=0, metavar="N",
+        help="shows the N instructions that take the most cycles (default: 20) and the cycles of each function.\n"
+             "Stall cycles are charged to the instruction that caused them.")
+    parser.add_argument("--folded", type=str, metavar="FILE",
+        help="writes the cycles of each call stack to FILE in folded-stack format (for flamegraph.pl).")
+    parser.add_argument("--ff", type=lambda x: int(x, 0), metavar="N",
+        help="fast-forwards N instructions in functional mode before the simulation starts.")
+    parser.add_argument("--ff-pc", type=str, metavar="ADDR",
+        help="fast-forwards in functional mode until the pc reaches ADDR (an address or a function name).")
+    parser.add_argument("--checkpoint", type=str, metavar="FILE",
+        help="saves the architectural state (pc, registers, data memory) at the fast-forward point to FILE.")
+    parser.add_argument("--restore", type=str, metavar="FILE",
+        help="restores the architectural state from FILE (saved with --checkpoint) before execution.\n"
+             "The same executable file and data memory configuration must be used.")
     parser.add_argument("--input", "-i", action="append", 
         nargs=3, metavar=("address", "maxsize", "filename"),
         help="Load file to the indicated address before execution. Aborts of the file is larger than maxsize.")
@@ -108,6 +171,33 @@ sets the desired log level (default: %(default)s)
         help="Set start address of data memory. Default: %(default)08x.")
     parser.add_argument("--dmem-size", "-dms", type=lambda x: int(x, 0), default=DMEM_SIZE,
         help="Set size of data memory. Default: %(default)08x.")
+    parser.add_argument("--dcache-size", "-dcs", type=lambda x: int(x, 0), default=DCACHE_SIZE,
+        help="Set size of the data cache in bytes. Default: %(default)d (no data cache).")
+    parser.add_argument("--dcache-assoc", "-dca", type=lambda x: int(x, 0), default=DCACHE_ASSOC,
+        help="Set associativity of the data cache. Default: %(default)d.")
+    parser.add_argument("--dcache-line", "-dcl", type=lambda x: int(x, 0), default=DCACHE_LINE,
+        help="Set line size of the data cache in bytes. Default: %(default)d.")
+    parser.add_argument("--dcache-policy", "-dcw", choices=[ 'wb', 'wt' ], default=DCACHE_POLICY,
+        help="Set write policy of the data cache. Default: %(default)s.\n"
+             " wb: write-back, write-allocate\n"
+             " wt: write-through, no-write-allocate (stores never stall)")
+    parser.add_argument("--dcache-penalty", "-dcp", type=lambda x: int(x, 0), default=DCACHE_PENALTY,
+        help="Set the number of cycles to service a data cache miss. Default: %(default)d.")
+    parser.add_argument("--bpred", "-bp", choices=[ BP_NONE, BP_BTFN, BP_BIMODAL, BP_GSHARE ], default=BPRED,
+        help="Set the branch predictor used in IF. Default: %(default)s.\n"
+             " none:    always not taken (no BTB)\n"
+             " btfn:    backward taken, forward not taken\n"
+             " bimodal: 2-bit counters indexed by PC\n"
+             " gshare:  2-bit counters indexed by PC xor global branch history")
+    parser.add_argument("--btb-entries", "-btb", type=lambda x: int(x, 0), default=BTB_ENTRIES,
+        help="Set the number of BTB entries. Default: %(default)d.")
+    parser.add_argument("--bht-entries", "-bht", type=lambda x: int(x, 0), default=BHT_ENTRIES,
+        help="Set the number of 2-bit counters of bimodal/gshare. Default: %(default)d.")
+    parser.add_argument("--issue", "-w", type=int, choices=[ 1, 2 ], default=ISSUE_WIDTH,
+        help="Set the issue width. Default: %(default)d.\n"
+             " 1: 5-stage pipeline\n"
+             " 2: in-order dual-issue timing model. At most one memory access per cycle;\n"
+             "    dependent instructions and instructions after a branch or jump are not paired.")
     parser.add_argument("filename", type=str, help="RISC-V executable file name")
 
     args = parser.parse_args()
@@ -125,6 +215,28 @@ sets the desired log level (default: %(default)s)
         print(f"         Data memory: {args.dmem_addr:08x} - {args.dmem_addr+args.dmem_size:08x}")
         exit(1)
 
+    if args.dcache_size:
+        pow2 = lambda x: x > 0 and (x & (x - 1)) == 0
+        if (not pow2(args.dcache_size) or not pow2(args.dcache_assoc) or not pow2(args.dcache_line) or
+            args.dcache_line < WORD_SIZE or args.dcache_size < args.dcache_assoc * args.dcache_line or
+            args.dcache_penalty < 0):
+            print("Invalid data cache configuration: size, associativity, and line size must be powers of two,")
+            print("the line must hold at least one word, and the cache at least one set.")
+            exit(1)
+
+    if args.btb_entries < 1 or args.bht_entries < 1 or (args.bht_entries & (args.bht_entries - 1)):
+        print("Invalid branch predictor configuration: the BTB needs at least one entry,")
+        print("and the number of BHT entries must be a power of two.")
+        exit(1)
+
+    if args.issue > 1 and (args.fast or args.profile or args.folded):
+        print("The dual-issue timing model cannot be combined with the functional mode or profiling.")
+        exit(1)
+
+    if args.checkpoint and args.ff is None and args.ff_pc is None:
+        print("A checkpoint is saved at the fast-forward point; use --ff or --ff-pc.")
+        exit(1)
+
     # Set arguments
     Log.level = args.log
     Log.start_cycle = args.cycle
@@ -138,12 +250,13 @@ def load_file(cpu, adr_str, maxsize_str, filename):
         maxsize = int(maxsize_str, 0)
 
         with open(filename, 'rb') as f:
-            data = bytearray(f.read())
+            size = os.fstat(f.fileno()).st_size
 
-            if len(data) > maxsize:
+            if size > maxsize:
                 raise ValueError(f"Data of {filename} larger than maximum allowed size ({maxsize})")
 
-            cpu.dmem.copy_to(address, data)
+            # Read the file directly into the data memory
+            f.readinto(cpu.dmem.view(address, size))
 
     except ValueError:
         print(f"Invalid data types in input parameter {adr_str} {maxsize_str} {filename}. "
@@ -159,7 +272,7 @@ def save_file(cpu, adr_str, size_str, filename):
         address = int(adr_str, 0)
         size = int(size_str, 0)
 
-        data = cpu.dmem.copy_from(address, size)
+        data = cpu.dmem.view(address, size)
 
         with open(filename, 'wb') as f:
             f.write(data)
@@ -184,7 +297,10 @@ def main():
     args = parse_args(sys.argv[1:])
 
     # Instantiate CPU instance with H/W components
-    cpu = SNURISC5(args.imem_addr, args.imem_size, args.dmem_addr, args.dmem_size)
+    cpu = SNURISC5(args.imem_addr, args.imem_size, args.dmem_addr, args.dmem_size,
+                   args.dcache_size, args.dcache_assoc, args.dcache_line,
+                   args.dcache_policy, args.dcache_penalty,
+                   args.bpred, args.btb_entries, args.bht_entries, args.issue)
 
     # Make program instance
     prog = Program()
@@ -199,8 +315,33 @@ def main():
         for item in args.input:
             load_file(cpu, item[0], item[1], item[2])
 
+    # Restore the architectural state
+    if args.restore:
+        try:
+            entry_point = Checkpoint.restore(cpu, args.restore)
+        except (OSError, ValueError, zlib.error) as e:
+            print(f"Error restoring checkpoint: {e}")
+            sys.exit(1)
+
+    # Fast-forward in functional mode (entry_point is None if the program terminated)
+    if args.ff is not None or args.ff_pc is not None:
+        ff_pc = None
+        if args.ff_pc is not None:
+            ff_pc = Program.address(args.ff_pc)
+            if ff_pc is None:
+                try:
+                    ff_pc = int(args.ff_pc, 0)
+                except ValueError:
+                    print(f"Unknown function {args.ff_pc}")
+                    sys.exit(1)
+        entry_point = Functional(cpu).run(entry_point, args.ff, ff_pc)
+        if entry_point is not None and args.checkpoint:
+            Checkpoint.save(cpu, entry_point, args.checkpoint)
+
     # Execute program
-    cpu.run(entry_point)
+    profiler = Profiler(entry_point) if (args.profile or args.folded) and entry_point is not None else None
+    if entry_point is not None:
+        cpu.run(entry_point, args.fast, profiler)
 
     # Save output files
     if args.output:
@@ -208,6 +349,10 @@ def main():
             save_file(cpu, item[0], item[1], item[2])
 
     # Show statistics
+    if profiler and args.profile:
+        profiler.show(args.profile)
+    if profiler and args.folded:
+        profiler.write_folded(args.folded)
     Stat.show()
 
 
@@ -0,0 +1,232 @@
+#==========================================================================
+#
+#   The PyRISC Project
+#
+#   SNURISC5: A 5-stage Pipelined RISC-V ISA Simulator
+#
+#   In-order dual-issue timing model
+#
+#   Models a 5-stage pipeline that issues up to two instructions per
+#   cycle into EX. The instructions are executed in program order by the
+#   handlers of the functional mode; for each instruction, the model
+#   computes the cycle in which it is in EX. The hazards are those of the
+#   single-issue pipeline (datapath.py, control.py):
+#
+#     - results are forwarded from EX, MM, and WB of both lanes, so an
+#       ALU result can be used in the next cycle and a loaded value one
+#       cycle later (load-use hazard)
+#     - branches and jumps are resolved in EX; a misprediction cancels
+#       the instructions fetched after it (two cycles)
+#     - a D-cache miss freezes the pipeline for the miss penalty
+#
+#   Two instructions are paired if at most one of them accesses memory,
+#   the second neither reads nor writes the destination register of the
+#   first, and the first is not a branch or jump. With an issue width of
+#   one, the model yields the cycle count of the pipelined mode.
+#
+#==========================================================================
+
+
+from collections import deque
+
+from consts import *
+from isa import *
+from components import *
+from program import *
+from control import *
+from functional import *
+
+
+# Reasons for issuing an instruction without a partner
+P_DEP       = 0         # the next instruction depends on it
+P_MEM       = 1         # both access memory
+P_WAW       = 2         # both write the same register
+P_CTRL      = 3         # it is a branch or jump
+P_STALL     = 4         # the next instruction is not available (misprediction, D-cache miss)
+
+P_MSG = [ 'data dependency', 'memory port', 'same destination', 'branch/jump', 'stall' ]
+
+
+#--------------------------------------------------------------------------
+#   Superscalar: functional execution with an in-order multi-issue timing model
+#--------------------------------------------------------------------------
+
+class Superscalar(Functional):
+
+    def __init__(self, cpu, width = 2):
+        super().__init__(cpu)
+        self.width      = width
+        self.timing     = [ None ] * len(self.table)
+
+        self.lanes      = [ 0 ] * width     # number of instructions issued to each lane
+        self.unpaired   = [ 0 ] * len(P_MSG)
+
+
+    # Registers read and written, memory access, and branch target of an instruction
+    def decode_timing(self, pc, inst):
+        opcode = RISCV.opcode(inst)
+        if opcode == ILLEGAL:
+            return (), 0, 0, M_X, 0, 0, BR_N, 0
+
+        cs      = csignals[opcode]
+        vregs   = RISCV.vregs(inst)             # vector registers are VREG + n
+        srcs    = [ ]
+        if cs[CS_RS1_OEN]:
+            srcs.append(int(RISCV.rs1(inst)) + (VREG if vregs & V_RS1 else 0))
+        if cs[CS_RS2_OEN]:
+            srcs.append(int(RISCV.rs2(inst)) + (VREG if vregs & V_RS2 else 0))
+        if isa[opcode][IN_TYPE] in [ R4_TYPE, R4S_TYPE ]:
+            srcs.append(int(RISCV.rs3(inst)) + (VREG if vregs & V_RS3 else 0))
+        rd      = int(RISCV.rd(inst)) + (VREG if vregs & V_RD else 0) if cs[CS_RF_WEN] else 0
+        imm     = int(RISCV.imm_s(inst)) if cs[CS_OP2_SEL] == OP2_IMS else \
+                  int(RISCV.imm_i(inst)) if cs[CS_OP2_SEL] == OP2_IMI else 0
+
+        # The target of a branch is known even if it is not taken (jalr: computed in EX)
+        target  = (pc + int(RISCV.imm_j(inst))) & MASK32 if cs[CS_BR_TYPE] == BR_J else \
+                  (pc + int(RISCV.imm_b(inst))) & MASK32
+
+        # mem: size of the memory access in bytes (0: none)
+        mem     = 0 if not cs[CS_MEM_EN] else \
+                  8 if cs[CS_MSK_SEL] in [ MT_D, MT_VU2, MT_VA2, MT_VP2 ] else WORD_SIZE
+
+        return tuple(s for s in srcs if s), rd, mem, cs[CS_MEM_FCN], \
+               int(RISCV.rs1(inst)), imm & MASK32, cs[CS_BR_TYPE], target
+
+
+    #----------------------------------------------------------------------
+    #   Simulation loop
+    #----------------------------------------------------------------------
+
+    def run(self, entry_point):
+        table   = self.table
+        timing  = self.timing
+        count   = self.count
+        ibase   = self.ibase
+        n       = len(table)
+        r       = self.r
+        width   = self.width
+        lanes   = self.lanes
+        unpaired = self.unpaired
+        dcache  = self.cpu.dcache
+        bpred   = self.cpu.bpred
+        trace   = Log.level >= 3
+        pc      = int(entry_point)
+
+        ready   = [ 0 ] * (NUM_REGS + NUM_VREGS)    # first cycle a register can be read in EX
+        front   = 2                         # first cycle the next instruction can be in EX
+        group   = 1                         # cycle of the current issue group
+        issued  = width                     # number of instructions in the current group
+        has_mem = False                     # the current group accesses memory
+        dsts    = [ ]                       # registers written by the current group
+        closed  = False                     # the current group ends with a branch or jump
+        updates = deque()                   # branch predictor updates in EX order
+        e       = group
+
+        try:
+            while True:
+                i = (pc - ibase) >> 2
+                if i < 0 or i >= n or pc & 3:
+                    raise Stop(EXC_IMEM_ERROR, pc)
+                h = table[i]
+                if h is None:
+                    inst, status = self.cpu.imem.access(True, WORD(pc), 0, M_XRD)
+                    h, self.klass[i] = self.decode(pc, inst)
+                    timing[i] = self.decode_timing(pc, inst)
+                    table[i] = h
+                srcs, rd, mem, fcn, rs1, imm, br_type, target = timing[i]
+
+                # Earliest cycle in EX
+                t = front
+                for s in srcs:
+                    if ready[s] > t:
+                        t = ready[s]
+
+                # Issue with the current group or start a new one
+                if issued < width:
+                    reason = P_CTRL  if closed              else \
+                             P_STALL if front > group       else \
+                             P_DEP   if t > group           else \
+                             P_MEM   if mem and has_mem     else \
+                             P_WAW   if rd and rd in dsts   else \
+                             None
+                else:
+                    reason = P_STALL
+                if reason is None:
+                    issued += 1
+                else:
+                    if issued < width:
+                        unpaired[reason] += 1
+                    group   = max(t, group + 1)
+                    issued  = 1
+                    has_mem = False
+                    dsts    = [ ]
+                    closed  = False
+                e = group
+                lanes[issued - 1] += 1
+                if rd:
+                    dsts.append(rd)
+                if mem:
+                    has_mem = True
+                    addr = (r[rs1] + imm) & MASK32
+
+                if trace and e >= Log.start_cycle:
+                    self.log_issue(e, issued - 1, pc)
+                count[i] += 1
+                pc_next = h(pc)
+
+                # Results are forwarded from EX (ALU) or MM (loads)
+                if rd:
+                    ready[rd] = e + 1 if not (mem and fcn == M_XRD) else e + 2
+
+                # A D-cache miss in MM freezes the pipeline
+                if mem and dcache:
+                    wait = dcache.access(addr, fcn, mem)
+                    if wait:
+                        Stat.dmem_stall += wait
+                        front = max(front, e + 1 + wait)
+                        if rd:
+                            ready[rd] += wait
+
+                # Branches and jumps are predicted in IF (two cycles before EX) and resolved in EX
+                if br_type != BR_N:
+                    while updates and updates[0][0] <= e - 2:
+                        bpred.update(*updates.popleft()[1:])
+                    pred_taken, pred_target = bpred.predict(pc)
+                    taken = pc_next != ((pc + 4) & MASK32) or br_type in [ BR_J, BR_JR ]
+                    if br_type == BR_JR:
+                        target = pc_next
+                    mispredicted = taken != bool(pred_taken) or (taken and target != pred_target)
+                    updates.append((e, pc, br_type, taken, target, mispredicted))
+                    if mispredicted:
+                        front = max(front, e + 3)
+                    closed = True
+
+                pc = pc_next
+        except Stop as stop:
+            exception, pc = stop.exception, stop.pc
+
+        while updates:
+            bpred.update(*updates.popleft()[1:])
+
+        # The last instruction leaves WB three cycles after EX
+        Stat.cycle = e + 3
+        Stat.issue = self
+        self.finish(exception, pc)
+
+
+    def log_issue(self, cycle, lane, pc):
+        inst, status = self.cpu.imem.access(True, WORD(pc), 0, M_XRD)
+        print("%d [%d] 0x%08x: %-30s" % (cycle, lane, pc, Program.disasm(pc, inst)))
+
+
+    def show(self):
+        issued = sum(self.lanes)
+        print("Issue: %d lanes, in-order, IPC = %.3f" %
+              (self.width, 0.0 if Stat.cycle == 0 else issued / Stat.cycle))
+        for lane, n in enumerate(self.lanes):
+            print("  lane %d: %d instructions (%.2f%% of cycles, %.2f%% of instructions)" %
+                  (lane, n, 0.0 if Stat.cycle == 0 else n * 100.0 / Stat.cycle,
+                   0.0 if issued == 0 else n * 100.0 / issued))
+        if self.width > 1:
+            print("  issued without a partner: " +
+                  ", ".join("%d %s" % (self.unpaired[p], P_MSG[p]) for p in range(len(P_MSG))))
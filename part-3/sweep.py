@@ -0,0 +1,333 @@
+#!/usr/bin/env python3
+"""
+4190.308 Computer Architecture                                                          Spring 2023
+
+Parameter sweep for the blending kernels
+
+This program runs one or more blend_pyrisc binaries in the simulator over a range of image sizes,
+foreground alpha distributions, blending modes and alpha values. For every combination, it
+generates the input images, passes mode and alpha to the driver through its parameter block
+(PARAM_RAW in blend_pyrisc.c, loaded with the simulator's '-i' option, so the binaries need not
+be recompiled), compares the output with blend_int() of Part 2, and reports instructions, cycles,
+CPI and cycles per pixel. The simulations run as separate processes in parallel.
+
+The SV instructions round where blend_int() truncates; an output is accepted if no channel differs
+by more than the tolerance (default: 2).
+
+Example:
+    ./sweep.py --sizes 32x32,64x64 --dist random,mixed --alpha 64,128 blend_pyrisc blend_pyrisc_opt
+
+@changes:
+    2026/10/18 Hyunwoo LEE created
+
+@license:
+    Copyright (c) 2023, Computer Systems and Platforms Laboratory, SNU
+    All rights reserved.
+
+    Redistribution and use in source and binary forms, with or without modification, are permitted
+    provided that the following conditions are met:
+
+    - Redistributions of source code must retain the above copyright notice, this list of condi-
+      tions and the following disclaimer.
+    - Redistributions in binary form must reproduce the above copyright notice, this list of condi-
+      tions and the following disclaimer in the documentation and/or other materials provided with
+      the distribution.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR
+    IMPLIED WARRANTIES, INCLUDING,  BUT NOT LIMITED TO,  THE IMPLIED WARRANTIES OF MERCHANTABILITY
+    AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+    CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,  INCIDENTAL,  SPECIAL,  EXEMPLARY,  OR CONSE-
+    QUENTIAL DAMAGES  (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+    LOSS OF USE,  DATA, OR PROFITS; OR BUSINESS INTERRUPTION)  HOWEVER CAUSED AND ON ANY THEORY OF
+    LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,  OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+    ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+    DAMAGE.
+"""
+
+
+import argparse
+import concurrent.futures
+import os
+import re
+import shlex
+import struct
+import subprocess
+import sys
+import tempfile
+
+import numpy as np
+
+
+# Simulator and memory layout (must match blend_pyrisc.c and the Makefile)
+SIMULATOR   = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'pyrisc-csap', 'snurisc5.py')
+DMEM        = [ '-dma', '0x80100000', '-dms', '0x200000' ]
+PARAM_RAW   = 0x80178000
+IMG1_RAW    = 0x80180000
+IMG2_RAW    = 0x80200000
+OUT_RAW     = 0x80280000
+RAW_SIZE    = 0x80000           # size of the memory area of each image
+PARAM_MAGIC = 0x4d524150        # 'PARM'
+
+# RAW image format (see imlib.py)
+MAGIC       = 0x43534150        # 'CSAP'
+BGRA_FORMAT = 0x42475241        # 'BGRA'
+
+# Foreground alpha distributions
+DISTRIBUTIONS = {
+    'random':       'uniformly distributed alpha values',
+    'opaque':       'all pixels opaque (alpha 255)',
+    'transparent':  'all pixels transparent (alpha 0)',
+    'mixed':        'groups of four pixels that are all transparent, all opaque, or random',
+}
+
+
+
+def write_raw_image(filename, image):
+    """
+    Saves a BGRA image given as a height x width x 4 uint8 array in RAW image file format.
+    """
+    height, width = image.shape[:2]
+    with open(filename, 'wb') as f:
+        f.write(struct.pack('>II', MAGIC, BGRA_FORMAT) + struct.pack('<ii', height, width))
+        f.write(image.tobytes())
+
+
+def read_raw_data(filename, height, width):
+    """
+    Reads the pixel data of a height x width BGRA image from a RAW file written by the simulator.
+    Returns None if the header does not match.
+    """
+    with open(filename, 'rb') as f:
+        data = f.read(16 + height * width * 4)
+    if len(data) < 16 + height * width * 4 or \
+       struct.unpack('>II', data[:8]) + struct.unpack('<ii', data[8:16]) != (MAGIC, BGRA_FORMAT, height, width):
+        return None
+    return np.frombuffer(data, dtype=np.uint8, offset=16).reshape(height, width, 4)
+
+
+def generate(rng, height, width, dist):
+    """
+    Generates a background and a foreground image. The background has random colors and alpha
+    values, the foreground random colors and alpha values following the distribution @dist.
+    """
+    bg = rng.integers(0, 256, (height, width, 4), dtype=np.uint8)
+    fg = rng.integers(0, 256, (height, width, 4), dtype=np.uint8)
+
+    alpha = fg[:, :, 3].reshape(-1)
+    if dist == 'opaque':
+        alpha[:] = 255
+    elif dist == 'transparent':
+        alpha[:] = 0
+    elif dist == 'mixed':
+        kind = np.repeat(rng.integers(0, 3, (alpha.size + 3) // 4), 4)[:alpha.size]
+        alpha[kind == 0] = 0
+        alpha[kind == 1] = 255
+    return bg, fg
+
+
+def blend_int(img1, img2, mode, alpha):
+    """
+    Reference: blend_int() of Part 2 (mode 1: overlay, 0: merge).
+    """
+    c1 = img1[:, :, :3].astype(np.int64)
+    c2 = img2[:, :, :3].astype(np.int64)
+    a1 = img1[:, :, 3:].astype(np.int64)
+    a2 = img2[:, :, 3:].astype(np.int64)
+    if mode == 1:
+        ac = (a2 * alpha) >> 8
+        colors = (c1 * (256 - ac) + c2 * ac) >> 8
+        alphas = a1
+    else:
+        colors = (c1 * a1 * (256 - alpha) + c2 * a2 * alpha) >> 16
+        alphas = (a1 * (256 - alpha) + a2 * alpha) >> 8
+    return np.concatenate((colors, alphas), axis=2).astype(np.uint8)
+
+
+
+def run(job):
+    """
+    Runs one simulation and returns the job with its results.
+    """
+    cmd = [ sys.executable, SIMULATOR ] + DMEM + \
+          [ '-i', hex(PARAM_RAW), '16', job['param'],
+            '-i', hex(IMG1_RAW), hex(RAW_SIZE), job['img1'],
+            '-i', hex(IMG2_RAW), hex(RAW_SIZE), job['img2'],
+            '-o', hex(OUT_RAW), hex(RAW_SIZE), job['out'],
+            '-l', '1' ] + job['simargs'] + [ job['variant'] ]
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+
+    job['instructions'], job['cycles'], job['result'] = None, None, None
+    m = re.search(r'^(\d+) instructions executed(?: in (\d+) cycles)?', proc.stdout, re.M)
+    if m:
+        job['instructions'] = int(m.group(1))
+        job['cycles'] = int(m.group(2)) if m.group(2) else None
+    ret = re.search(r'a0 \(\$10\):\s*0x([0-9a-f]+)', proc.stdout)
+    if proc.returncode != 0 or not m or not ret:
+        job['result'] = 'simulator error'
+        job['log'] = proc.stdout
+    elif int(ret.group(1), 16) != 0:
+        job['result'] = 'returned 0x%x' % int(ret.group(1), 16)
+    return job
+
+
+def check(job, img1, img2, tolerance):
+    """
+    Compares the output of a job with the reference and sets its result.
+    """
+    height, width = img1.shape[:2]
+    out = read_raw_data(job['out'], height, width)
+    if out is None:
+        job['error'] = None
+        job['result'] = 'invalid output'
+        return
+    ref = blend_int(img1, img2, job['mode'], job['alpha'])
+    job['error'] = int(np.abs(out.astype(np.int64) - ref).max())
+    job['result'] = 'ok' if job['error'] <= tolerance else 'MISMATCH'
+
+
+
+def parse_list(s, conv, name):
+    try:
+        return [ conv(v) for v in s.split(',') if v ]
+    except ValueError:
+        raise argparse.ArgumentTypeError(f"invalid {name} list '{s}'")
+
+
+def parse_size(s):
+    h, w = s.lower().split('x')
+    h, w = int(h), int(w)
+    if h <= 0 or w <= 0:
+        raise ValueError
+    return h, w
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Runs the blending kernels over a range of '
+                                     'image sizes, alpha distributions and alpha values.')
+    parser.add_argument('variants', nargs='*', default=[ 'blend_pyrisc', 'blend_pyrisc_opt' ],
+                        help='blend_pyrisc binaries (default: blend_pyrisc blend_pyrisc_opt)')
+    parser.add_argument('-s', '--sizes', default='32x32,64x64',
+                        type=lambda s: parse_list(s, parse_size, 'size'),
+                        help='image sizes HxW (default: 32x32,64x64)')
+    parser.add_argument('-d', '--dist', default='random,mixed',
+                        type=lambda s: parse_list(s, str, 'distribution'),
+                        help='foreground alpha distributions: %s (default: random,mixed)' %
+                             ', '.join(DISTRIBUTIONS))
+    parser.add_argument('-a', '--alpha', default='128',
+                        type=lambda s: parse_list(s, lambda v: int(v, 0), 'alpha'),
+                        help='alpha values 0 - 256 (default: 128)')
+    parser.add_argument('-m', '--mode', default='1',
+                        type=lambda s: parse_list(s, int, 'mode'),
+                        help='blending modes, 1: overlay, 0: merge (default: 1)')
+    parser.add_argument('-j', '--jobs', type=int, default=os.cpu_count(),
+                        help='number of parallel simulations (default: number of cores)')
+    parser.add_argument('-t', '--tolerance', type=int, default=2,
+                        help='maximum difference of a channel from blend_int (default: 2)')
+    parser.add_argument('--seed', type=int, default=0, help='seed of the input images (default: 0)')
+    parser.add_argument('--simargs', type=shlex.split, default=[],
+                        help="additional simulator options, e.g., --simargs='--issue 2'")
+    parser.add_argument('--keep', metavar='DIR',
+                        help='keep the input and output images in DIR')
+    parser.add_argument('--csv', metavar='FILE', help='also write the results to FILE')
+    args = parser.parse_args()
+
+    for d in args.dist:
+        if d not in DISTRIBUTIONS:
+            parser.error(f"unknown distribution '{d}'")
+    for a in args.alpha:
+        if a < 0 or a > 256:
+            parser.error(f"alpha {a} out of range")
+    for m in args.mode:
+        if m not in [ 0, 1 ]:
+            parser.error(f"invalid mode {m}")
+    for h, w in args.sizes:
+        if 16 + h * w * 4 > RAW_SIZE:
+            parser.error(f"{h}x{w} image does not fit into {RAW_SIZE} bytes")
+    for v in args.variants:
+        if not os.path.isfile(v):
+            parser.error(f"{v} not found")
+
+    workdir = args.keep or tempfile.mkdtemp(prefix='sweep')
+    os.makedirs(workdir, exist_ok=True)
+
+    # Inputs and parameter blocks
+    rng = np.random.default_rng(args.seed)
+    images = { }
+    for h, w in args.sizes:
+        for d in args.dist:
+            bg, fg = generate(rng, h, w, d)
+            base = os.path.join(workdir, f'{h}x{w}_{d}')
+            write_raw_image(base + '_bg.raw', bg)
+            write_raw_image(base + '_fg.raw', fg)
+            images[h, w, d] = (base, bg, fg)
+    params = { }
+    for m in args.mode:
+        for a in args.alpha:
+            params[m, a] = os.path.join(workdir, f'param_{m}_{a}.bin')
+            with open(params[m, a], 'wb') as f:
+                f.write(struct.pack('<Iiii', PARAM_MAGIC, m, a, 0))
+
+    jobs = [ ]
+    for (h, w, d), (base, bg, fg) in images.items():
+        for (m, a), param in params.items():
+            for v in args.variants:
+                jobs.append({ 'variant': v, 'height': h, 'width': w, 'dist': d, 'mode': m, 'alpha': a,
+                              'param': param, 'img1': base + '_bg.raw', 'img2': base + '_fg.raw',
+                              'out': f'{base}_{m}_{a}_{os.path.basename(v)}.raw',
+                              'simargs': args.simargs })
+
+    print(f"Running {len(jobs)} simulations on {args.jobs} cores (inputs in {workdir})...",
+          file=sys.stderr)
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as executor:
+        for i, job in enumerate(executor.map(run, jobs)):
+            if job['result'] is None:
+                base, bg, fg = images[job['height'], job['width'], job['dist']]
+                check(job, bg, fg, args.tolerance)
+            print(f"  [{i + 1}/{len(jobs)}] {job['variant']} {job['height']}x{job['width']} "
+                  f"{job['dist']} mode {job['mode']} alpha {job['alpha']}: {job['result']}",
+                  file=sys.stderr)
+
+    # Results
+    header = [ 'variant', 'size', 'dist', 'mode', 'alpha', 'instructions', 'cycles', 'CPI',
+               'cycles/pixel', 'max err', 'result' ]
+    rows = [ ]
+    for job in jobs:
+        n, c = job['instructions'], job['cycles']
+        pixels = job['height'] * job['width']
+        rows.append([ os.path.basename(job['variant']), f"{job['height']}x{job['width']}",
+                      job['dist'], str(job['mode']), str(job['alpha']),
+                      '-' if n is None else str(n),
+                      '-' if c is None else str(c),
+                      '-' if c is None or not n else '%.3f' % (c / n),
+                      '-' if c is None else '%.2f' % (c / pixels),
+                      '-' if job.get('error') is None else str(job['error']),
+                      job['result'] ])
+
+    widths = [ max(len(r[i]) for r in rows + [ header ]) for i in range(len(header)) ]
+    print('  '.join(h.ljust(w) if i < 3 else h.rjust(w) for i, (h, w) in enumerate(zip(header, widths))))
+    for r in rows:
+        print('  '.join(v.ljust(w) if i < 3 else v.rjust(w) for i, (v, w) in enumerate(zip(r, widths))))
+
+    if args.csv:
+        with open(args.csv, 'w') as f:
+            f.write(','.join(header) + '\n')
+            for r in rows:
+                f.write(','.join(r) + '\n')
+
+    for job in jobs:
+        if job['result'] == 'simulator error':
+            print(f"\n{job['variant']} {job['height']}x{job['width']} {job['dist']}:\n{job['log']}",
+                  file=sys.stderr)
+            break
+
+    if not args.keep:
+        for f in os.listdir(workdir):
+            os.remove(os.path.join(workdir, f))
+        os.rmdir(workdir)
+
+    return 0 if all(job['result'] == 'ok' for job in jobs) else 1
+
+
+
+if __name__ == '__main__':
+    sys.exit(main())
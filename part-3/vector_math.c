@@ -67,3 +67,108 @@ vrgb vmul(vrgb va, vrgb vb)
 
   return (rr << RSHIFT) | (gr << GSHIFT) | (br << BSHIFT);
 }
+
+vrgb vmac(vrgb va, vrgb vb, vrgb vc)
+{
+  // vc + va*vb (rounded as in vmul)
+  vrgb m = vmul(va, vb);
+
+  return (((vc >> RSHIFT) + (m >> RSHIFT)) & MASK) << RSHIFT |
+         (((vc >> GSHIFT) + (m >> GSHIFT)) & MASK) << GSHIFT |
+         (((vc >> BSHIFT) + (m >> BSHIFT)) & MASK) << BSHIFT;
+}
+
+vrgb vlerp(vrgb va, vrgb vb, vrgb vw)
+{
+  // va*vw + vb*(256-vw) (each product rounded as in vmul)
+  return vmac(vb, vsub(vbrdcst(256), vw), vmul(va, vw));
+}
+
+vrgb vadds(vrgb va, vrgb vb)
+{
+  // saturating: each channel is at most MASK
+  uint32 r = ((va >> RSHIFT) & MASK) + ((vb >> RSHIFT) & MASK);
+  if (r > MASK) r = MASK;
+
+  uint32 g = ((va >> GSHIFT) & MASK) + ((vb >> GSHIFT) & MASK);
+  if (g > MASK) g = MASK;
+
+  uint32 b = ((va >> BSHIFT) & MASK) + ((vb >> BSHIFT) & MASK);
+  if (b > MASK) b = MASK;
+
+  return (r << RSHIFT) | (g << GSHIFT) | (b << BSHIFT);
+}
+
+vrgb vsubs(vrgb va, vrgb vb)
+{
+  // saturating: each channel is at least 0
+  uint32 ra = (va >> RSHIFT) & MASK, rb = (vb >> RSHIFT) & MASK;
+  uint32 r = ra > rb ? ra - rb : 0;
+
+  uint32 ga = (va >> GSHIFT) & MASK, gb = (vb >> GSHIFT) & MASK;
+  uint32 g = ga > gb ? ga - gb : 0;
+
+  uint32 ba = (va >> BSHIFT) & MASK, bb = (vb >> BSHIFT) & MASK;
+  uint32 b = ba > bb ? ba - bb : 0;
+
+  return (r << RSHIFT) | (g << GSHIFT) | (b << BSHIFT);
+}
+
+vrgb valpha(argb v)
+{
+  return vbrdcst(v >> 24);
+}
+
+
+// Two-pixel operations: the one-pixel operation on each 32-bit half
+
+#define LO(v)       ((uint32)(v))
+#define HI(v)       ((uint32)((v) >> 32))
+#define PAIR(l, h)  ((uint64)(l) | ((uint64)(h) << 32))
+
+vrgb2 vunpack2(argb2 v)
+{
+  return PAIR(vunpack(LO(v)), vunpack(HI(v)));
+}
+
+argb2 vpack2(vrgb2 v, argb2 alpha)
+{
+  // the alpha of each pixel is taken from bits 31:24 of the same half of alpha
+  return PAIR(vpack(LO(v), LO(alpha) >> 24), vpack(HI(v), HI(alpha) >> 24));
+}
+
+vrgb2 vbrdcst2(uint32 w)
+{
+  return PAIR(vbrdcst(w), vbrdcst(w));
+}
+
+vrgb2 valpha2(argb2 v)
+{
+  // the alpha of each pixel broadcast to its lanes (svlda)
+  return PAIR(vbrdcst(LO(v) >> 24), vbrdcst(HI(v) >> 24));
+}
+
+vrgb2 vadd2(vrgb2 va, vrgb2 vb)
+{
+  return PAIR(vadd(LO(va), LO(vb)), vadd(HI(va), HI(vb)));
+}
+
+vrgb2 vsub2(vrgb2 va, vrgb2 vb)
+{
+  return PAIR(vsub(LO(va), LO(vb)), vsub(HI(va), HI(vb)));
+}
+
+vrgb2 vmul2(vrgb2 va, vrgb2 vb)
+{
+  return PAIR(vmul(LO(va), LO(vb)), vmul(HI(va), HI(vb)));
+}
+
+vrgb2 vmac2(vrgb2 va, vrgb2 vb, vrgb2 vc)
+{
+  return PAIR(vmac(LO(va), LO(vb), LO(vc)), vmac(HI(va), HI(vb), HI(vc)));
+}
+
+vrgb2 vlerp2(vrgb2 va, vrgb2 vb, vrgb2 vw)
+{
+  return PAIR(vlerp(LO(va), LO(vb), LO(vw)), vlerp(HI(va), HI(vb), HI(vw)));
+}
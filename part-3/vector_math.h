@@ -15,10 +15,15 @@
 typedef unsigned char uint8;
 typedef signed int int12;     // signed 12-bit
 typedef unsigned int uint32;
+typedef unsigned long long uint64;
 
 typedef unsigned int argb;
 typedef unsigned int vrgb;
 
+// Two-pixel vectors: two argb/vrgb values, the pixel at the lower address in bits 31:0
+typedef uint64 argb2;
+typedef uint64 vrgb2;
+
 vrgb vunpack(argb v);
 argb vpack(vrgb v, uint8 alpha);
 vrgb vbrdcst(uint32 w);
@@ -26,5 +31,20 @@ vrgb vaddi(vrgb v, int12 i);
 vrgb vadd(vrgb va, vrgb vb);
 vrgb vsub(vrgb va, vrgb vb);
 vrgb vmul(vrgb va, vrgb vb);
+vrgb vmac(vrgb va, vrgb vb, vrgb vc);
+vrgb vlerp(vrgb va, vrgb vb, vrgb vw);
+vrgb vadds(vrgb va, vrgb vb);
+vrgb vsubs(vrgb va, vrgb vb);
+vrgb valpha(argb v);
+
+vrgb2 vunpack2(argb2 v);
+argb2 vpack2(vrgb2 v, argb2 alpha);
+vrgb2 vbrdcst2(uint32 w);
+vrgb2 valpha2(argb2 v);
+vrgb2 vadd2(vrgb2 va, vrgb2 vb);
+vrgb2 vsub2(vrgb2 va, vrgb2 vb);
+vrgb2 vmul2(vrgb2 va, vrgb2 vb);
+vrgb2 vmac2(vrgb2 va, vrgb2 vb, vrgb2 vc);
+vrgb2 vlerp2(vrgb2 va, vrgb2 vb, vrgb2 vw);
 
 #endif // __VECTOR_MATH__